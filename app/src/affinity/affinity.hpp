@@ -1,5 +1,7 @@
 #pragma once
 
+#include <vector>
+
 #include <util/logger/logger.hpp>
 
 #ifdef _WIN64
@@ -32,6 +34,21 @@ inline bool setAffinity(const std::vector<int>& cpus, HANDLE process_handle) noe
     return SetProcessAffinityMask(process_handle, affinity_mask) != 0;
 }
 
+// Pins the calling thread, an empty list leaves it unpinned.
+inline bool setThreadAffinity(const std::vector<int>& cpus) noexcept {
+    if (cpus.empty()) return true;
+
+    DWORD_PTR affinity_mask = 0;
+
+    for (const auto& cpu : cpus) {
+        assert(cpu <= 63);
+
+        affinity_mask |= (1ull << cpu);
+    }
+
+    return SetThreadAffinityMask(GetCurrentThread(), affinity_mask) != 0;
+}
+
 #elif defined(__APPLE__)
 
 inline void setAffinity(const std::vector<int>&) noexcept {
@@ -45,6 +62,8 @@ inline void setAffinity(const std::vector<int>&) noexcept {
     // do nothing for now, is affinity_tag supposed to be a mask or the core number?
 }
 
+inline bool setThreadAffinity(const std::vector<int>&) noexcept { return true; }
+
 #else
 
 inline bool setAffinity(const std::vector<int>& cpus, pid_t process_pid) noexcept {
@@ -60,6 +79,21 @@ inline bool setAffinity(const std::vector<int>& cpus, pid_t process_pid) noexcep
     return sched_setaffinity(process_pid, sizeof(cpu_set_t), &mask);
 }
 
+// Pins the calling thread, an empty list leaves it unpinned.
+inline bool setThreadAffinity(const std::vector<int>& cpus) noexcept {
+    if (cpus.empty()) return true;
+
+    cpu_set_t mask;
+    CPU_ZERO(&mask);
+
+    for (const auto& cpu : cpus) {
+        CPU_SET(cpu, &mask);
+    }
+
+    // pid 0 is the calling thread
+    return sched_setaffinity(0, sizeof(cpu_set_t), &mask) == 0;
+}
+
 #endif
 }  // namespace affinity
 
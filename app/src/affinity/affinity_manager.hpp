@@ -1,10 +1,16 @@
 #pragma once
 
+#include <algorithm>
+#include <array>
 #include <atomic>
+#include <deque>
 #include <iostream>
+#include <map>
 #include <mutex>
 #include <sstream>
 #include <stack>
+#include <utility>
+#include <vector>
 
 #include <chess.hpp>
 
@@ -24,41 +30,45 @@ namespace fastchess {
 
 namespace affinity {
 class AffinityManager {
-    enum Group {
-        NONE = -1,
-        HT_1,
-        HT_2,
-    };
-
     class AffinityProcessor : public util::ScopeEntry {
        public:
-        AffinityProcessor(const std::vector<int>& cpus) : util::ScopeEntry(true), cpus(cpus) {}
+        AffinityProcessor(const std::vector<int>& cpus, const std::vector<int>& domain = {})
+            : util::ScopeEntry(true), cpus(cpus), domain(domain) {}
 
         std::vector<int> cpus;
 
+        // processors sharing the L3 cache of the set, for the thread running the game
+        std::vector<int> domain;
+
         friend class AffinityManager;
     };
 
    public:
-    // Hyperthreads are split up into two groups: HT_1 and HT_2
-    // So all elements in HT_1 are guaranteed to be on a different physical core.
-    // Same goes for HT_2. This is done to avoid putting two processes on the same
-    // physical core. When all cores in HT_1 are used, HT_2 is used.
-
-    // Construct a new Affinity Manager object
-    AffinityManager(bool use_affinity, int tpe) {
-        use_affinity_ = use_affinity;
-
-        if (tpe > 1) {
-            use_affinity_ = false;
-        }
+    // A game gets a set of tpe processors, one per thread of its engines. The processors of a
+    // set are neighbouring cores which share an L3 cache and a NUMA node. While concurrency
+    // sets of whole cores fit on the machine, the second hyperthreads stay idle, otherwise
+    // the hyperthreads of a core go to the same game. Single threaded games get a hyperthread
+    // each, the second hyperthreads are only handed out once all first ones are in use.
+    AffinityManager(bool use_affinity, int tpe, int concurrency) {
+        use_affinity_ = use_affinity && tpe > 0;
 
         if (use_affinity_) {
-            setupCores(cpu_info::getCpuInfo());
+            setupCores(cpu_info::getCpuInfo(), tpe, concurrency);
             Logger::trace("Using affinity");
         }
     }
 
+    AffinityManager(const cpu_info::CpuInfo& cpu_info, int tpe, int concurrency) {
+        use_affinity_ = tpe > 0;
+
+        if (use_affinity_) setupCores(cpu_info, tpe, concurrency);
+    }
+
+    // Number of sets the manager hands out for the cpu info, 0 if the threads don't fit.
+    [[nodiscard]] static std::size_t sets(const cpu_info::CpuInfo& cpu_info, int tpe, int concurrency) {
+        return tpe > 0 ? buildSets(cpu_info, tpe, concurrency).size() : 0;
+    }
+
     // Get a core from the pool of available cores.
     [[nodiscard]] AffinityProcessor& consume() {
         if (!use_affinity_) {
@@ -67,19 +77,17 @@ class AffinityManager {
 
         std::lock_guard<std::mutex> lock(core_mutex_);
 
-        if (cores_[HT_1].empty() && cores_[HT_2].empty()) {
+        if (cores_.empty()) {
             Logger::trace("No cores available");
 
             throw std::runtime_error("No cores available");
         }
 
         // find first available core
-        for (const auto grp : {HT_1, HT_2}) {
-            for (auto& core : cores_[grp]) {
-                if (core.available_) {
-                    core.available_ = false;
-                    return core;
-                }
+        for (auto& core : cores_) {
+            if (core.available_) {
+                core.available_ = false;
+                return core;
             }
         }
 
@@ -88,32 +96,132 @@ class AffinityManager {
         throw std::runtime_error("No cores available");
     }
 
+    // One character per set of processors, # while a game uses it, empty without affinity.
+    [[nodiscard]] std::string map() const {
+        if (!use_affinity_) return "";
+
+        std::lock_guard<std::mutex> lock(core_mutex_);
+
+        std::string map;
+        map.reserve(cores_.size());
+        for (const auto& core : cores_) map += core.available_ ? '.' : '#';
+
+        return map;
+    }
+
    private:
-    // Setup the cores for the affinity, later entries from the core pool will be just
-    // picked up.
-    void setupCores(const cpu_info::CpuInfo& cpu_info) {
+    struct Core {
+        // physical cpu, NUMA node and L3 cache
+        std::array<int, 3> domain;
+        std::vector<int> processors;
+    };
+
+    // processors of a set and of the L3 cache it is in
+    using Set = std::pair<std::vector<int>, std::vector<int>>;
+
+    // Setup the sets of processors, later entries from the pool will be just picked up.
+    void setupCores(const cpu_info::CpuInfo& cpu_info, int tpe, int concurrency) {
         Logger::trace("Setting up cores");
         std::lock_guard<std::mutex> lock(core_mutex_);
 
-        // @TODO: fix logic for multiple threads and multiple concurrencies
+        for (const auto& [set, all] : buildSets(cpu_info, tpe, concurrency)) cores_.emplace_back(set, all);
+
+        Logger::trace("Using {} sets of {} processors", cores_.size(), tpe);
 
-        for (const auto& physical_cpu : cpu_info.physical_cpus) {
-            for (const auto& core : physical_cpu.second.cores) {
-                int idx = 0;
-                for (const auto& processor : core.second.processors) {
-                    Group group = idx % 2 == 0 ? HT_1 : HT_2;
+        if (cores_.empty()) {
+            Logger::warn("Warning; {} threads per game don't fit on the cores, affinity is disabled.", tpe);
+            use_affinity_ = false;
+        }
+    }
 
-                    // this looks wrong??
-                    cores_[group].emplace_back(std::vector{processor.processor_id});
+    // The sets in the order they are handed out.
+    static std::vector<Set> buildSets(const cpu_info::CpuInfo& cpu_info, int tpe, int concurrency) {
+        std::vector<Core> cores;
 
-                    idx++;
+        for (const auto& [physical_id, physical_cpu] : cpu_info.physical_cpus) {
+            for (const auto& [core_id, core] : physical_cpu.cores) {
+                Core entry{{physical_id, core.node_id, core.cache_id}, {}};
+
+                for (const auto& processor : core.processors) entry.processors.push_back(processor.processor_id);
+                if (entry.processors.empty()) continue;
+
+                std::sort(entry.processors.begin(), entry.processors.end());
+                cores.push_back(entry);
+            }
+        }
+
+        std::sort(cores.begin(), cores.end(),
+                  [](const Core& a, const Core& b) { return a.processors.front() < b.processors.front(); });
+
+        const bool whole = static_cast<std::size_t>(concurrency) * tpe <= cores.size();
+
+        // a set needs tpe cores of which it uses the first hyperthread, or enough cores for
+        // tpe hyperthreads
+        const auto fits = [&](const std::vector<std::size_t>& domain) {
+            std::size_t processors = 0;
+            for (const auto idx : domain) processors += whole ? 1 : cores[idx].processors.size();
+            return processors >= static_cast<std::size_t>(tpe);
+        };
+
+        // start with L3 caches and widen the domains until a set fits into one
+        std::map<std::array<int, 3>, std::vector<std::size_t>> domains;
+
+        for (int level = 3; level >= 0; level--) {
+            domains.clear();
+
+            for (std::size_t idx = 0; idx < cores.size(); idx++) {
+                auto key = cores[idx].domain;
+                for (int i = level; i < 3; i++) key[i] = -1;
+
+                domains[key].push_back(idx);
+            }
+
+            if (std::any_of(domains.begin(), domains.end(), [&](const auto& domain) { return fits(domain.second); })) {
+                break;
+            }
+        }
+
+        const auto processors_of = [&](const std::vector<std::size_t>& domain) {
+            std::vector<int> processors;
+            for (const auto idx : domain) {
+                processors.insert(processors.end(), cores[idx].processors.begin(), cores[idx].processors.end());
+            }
+            return processors;
+        };
+
+        // sets of first hyperthreads only are handed out before the ones with their siblings
+        std::vector<Set> firsts, siblings;
+
+        for (const auto& [key, domain] : domains) {
+            const auto all = processors_of(domain);
+
+            std::vector<int> set;
+            bool first = true;
+
+            for (const auto idx : domain) {
+                const auto& processors = cores[idx].processors;
+
+                // the processors which don't make it into a set stay idle
+                for (std::size_t i = 0; i < processors.size() && (i == 0 || !whole); i++) {
+                    set.push_back(processors[i]);
+                    first &= i == 0;
+
+                    if (set.size() == static_cast<std::size_t>(tpe)) {
+                        (first ? firsts : siblings).emplace_back(set, all);
+                        set.clear();
+                        first = true;
+                    }
                 }
             }
         }
+
+        firsts.insert(firsts.end(), siblings.begin(), siblings.end());
+
+        return firsts;
     }
 
-    std::array<std::deque<AffinityProcessor>, 2> cores_;
-    std::mutex core_mutex_;
+    std::deque<AffinityProcessor> cores_;
+    mutable std::mutex core_mutex_;
 
     // This is a dummy core which is returned when affinity is disabled.
     AffinityProcessor null_core_ = {{}};
@@ -23,6 +23,10 @@ struct CpuInfo {
             // else on weird systems.
             std::vector<Processor> processors;
             int core_id;
+
+            // L3 cache and NUMA node of the core, -1 if unknown
+            int cache_id = -1;
+            int node_id  = -1;
         };
 
         std::map<int, Core> cores;
@@ -3,6 +3,7 @@
 #include <array>
 #include <map>
 #include <numeric>
+#include <optional>
 #include <thread>
 #include <vector>
 
@@ -26,4 +27,7 @@ inline CpuInfo getCpuInfo() noexcept {
     return cpu_info;
 }
 
+// Cpu rate limits are not read yet.
+inline std::optional<int> cpuQuota() noexcept { return std::nullopt; }
+
 }  // namespace fastchess::affinity::cpu_info
\ No newline at end of file
@@ -1,22 +1,198 @@
 #pragma once
 
+#include <algorithm>
 #include <array>
 #include <fstream>
 #include <iostream>
+#include <iterator>
 #include <map>
+#include <optional>
 #include <string>
 #include <thread>
 #include <unordered_map>
 #include <vector>
 
+#include <sched.h>
+#include <unistd.h>
+
 #include <affinity/cpuinfo/cpu_info.hpp>
 #include <util/logger/logger.hpp>
 
 namespace fastchess::affinity::cpu_info {
 
-inline CpuInfo getCpuInfo() {
-    Logger::trace("Getting CPU info");
+namespace sysfs {
+
+// Reads a list like "0-3,8,10-11" of the kernel, empty if the file is missing.
+inline std::vector<int> readList(const std::string& path) {
+    std::ifstream file(path);
+
+    std::string list;
+    if (!std::getline(file, list)) return {};
+
+    std::vector<int> ids;
+    std::size_t pos = 0;
+
+    try {
+        while (pos < list.size()) {
+            const auto end   = std::min(list.find(',', pos), list.size());
+            const auto range = list.substr(pos, end - pos);
+            const auto dash  = range.find('-');
+
+            const int first = std::stoi(range.substr(0, dash));
+            const int last  = dash == std::string::npos ? first : std::stoi(range.substr(dash + 1));
+
+            for (int id = first; id <= last; id++) ids.push_back(id);
+
+            pos = end + 1;
+        }
+    } catch (const std::exception&) {
+        return {};
+    }
+
+    return ids;
+}
+
+inline int readInt(const std::string& path) {
+    std::ifstream file(path);
+
+    int value = -1;
+    if (!(file >> value)) return -1;
+
+    return value;
+}
+
+// The topology of the online processors, with the L3 cache and NUMA node of each core.
+inline std::optional<CpuInfo> getCpuInfo() {
+    const std::string root = "/sys/devices/system/cpu/";
+
+    const auto online = readList(root + "online");
+    if (online.empty()) return std::nullopt;
+
+    std::map<int, int> nodes;
+    for (const auto node : readList("/sys/devices/system/node/online")) {
+        for (const auto cpu : readList("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist")) {
+            nodes[cpu] = node;
+        }
+    }
 
+    CpuInfo cpu_info;
+
+    for (const auto cpu : online) {
+        const auto topology = root + "cpu" + std::to_string(cpu) + "/topology/";
+
+        const auto siblings = readList(topology + "thread_siblings_list");
+        const auto package  = readInt(topology + "physical_package_id");
+        if (siblings.empty() || package < 0) return std::nullopt;
+
+        // core ids repeat on different dies, the first sibling names a core uniquely
+        auto& core   = cpu_info.physical_cpus[package].cores[siblings.front()];
+        core.core_id = siblings.front();
+        core.processors.emplace_back(cpu);
+
+        for (int index = 0;; index++) {
+            const auto cache = root + "cpu" + std::to_string(cpu) + "/cache/index" + std::to_string(index) + "/";
+
+            const auto level = readInt(cache + "level");
+            if (level < 0) break;
+            if (level != 3) continue;
+
+            const auto shared = readList(cache + "shared_cpu_list");
+            if (!shared.empty()) core.cache_id = shared.front();
+        }
+
+        if (const auto it = nodes.find(cpu); it != nodes.end()) core.node_id = it->second;
+    }
+
+    for (auto& [id, physical_cpu] : cpu_info.physical_cpus) physical_cpu.physical_id = id;
+
+    return cpu_info;
+}
+
+}  // namespace sysfs
+
+namespace cgroup {
+
+constexpr auto ROOT = "/sys/fs/cgroup";
+
+// Directory of the cgroup v2 of this process, empty without the unified hierarchy.
+inline std::string path() {
+    std::ifstream file("/proc/self/cgroup");
+
+    std::string line;
+    while (std::getline(file, line)) {
+        if (line.rfind("0::", 0) != 0) continue;
+
+        auto dir = ROOT + line.substr(3);
+        while (dir.size() > 1 && dir.back() == '/') dir.pop_back();
+
+        return dir;
+    }
+
+    return {};
+}
+
+// Processors this process may run on, from the affinity mask of its main thread and the
+// cpuset of its cgroup. Empty if neither is known.
+inline std::vector<int> allowedProcessors() {
+    std::vector<int> allowed;
+
+    cpu_set_t mask;
+    CPU_ZERO(&mask);
+
+    // the pid is the main thread, the calling thread may be pinned to a game
+    if (sched_getaffinity(getpid(), sizeof(cpu_set_t), &mask) == 0) {
+        for (int cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+            if (CPU_ISSET(cpu, &mask)) allowed.push_back(cpu);
+        }
+    }
+
+    const auto dir    = path();
+    const auto cpuset = dir.empty() ? std::vector<int>{} : sysfs::readList(dir + "/cpuset.cpus.effective");
+
+    if (allowed.empty()) return cpuset;
+    if (cpuset.empty()) return allowed;
+
+    std::vector<int> both;
+    std::set_intersection(allowed.begin(), allowed.end(), cpuset.begin(), cpuset.end(), std::back_inserter(both));
+
+    return both;
+}
+
+// Whole processors of the lowest cpu.max quota along the cgroup hierarchy.
+inline std::optional<int> cpuQuota() {
+    auto dir = path();
+    if (dir.empty()) return std::nullopt;
+
+    std::optional<int> quota;
+
+    while (true) {
+        std::ifstream file(dir + "/cpu.max");
+
+        std::string max;
+        long long period = 0;
+
+        if (file >> max >> period && max != "max" && period > 0) {
+            try {
+                const auto cpus = static_cast<int>(std::max(1LL, std::stoll(max) / period));
+                quota           = std::min(quota.value_or(cpus), cpus);
+            } catch (const std::exception&) {
+            }
+        }
+
+        if (dir.size() <= std::string(ROOT).size()) break;
+
+        dir = dir.substr(0, dir.rfind('/'));
+    }
+
+    return quota;
+}
+
+}  // namespace cgroup
+
+namespace proc {
+
+// Without sysfs the cores stay in one domain.
+inline CpuInfo getCpuInfo() {
     std::ifstream cpuinfo("/proc/cpuinfo");
 
     std::string line;
@@ -57,4 +233,45 @@ inline CpuInfo getCpuInfo() {
     return cpu_info;
 }
 
+}  // namespace proc
+
+// Drops the processors this process may not run on, and the cores left without one.
+inline void restrictTo(CpuInfo& cpu_info, const std::vector<int>& allowed) {
+    if (allowed.empty()) return;
+
+    for (auto physical = cpu_info.physical_cpus.begin(); physical != cpu_info.physical_cpus.end();) {
+        auto& cores = physical->second.cores;
+
+        for (auto core = cores.begin(); core != cores.end();) {
+            auto& processors = core->second.processors;
+
+            processors.erase(std::remove_if(processors.begin(), processors.end(),
+                                            [&](const auto& processor) {
+                                                return !std::binary_search(allowed.begin(), allowed.end(),
+                                                                           processor.processor_id);
+                                            }),
+                             processors.end());
+
+            core = processors.empty() ? cores.erase(core) : std::next(core);
+        }
+
+        physical = cores.empty() ? cpu_info.physical_cpus.erase(physical) : std::next(physical);
+    }
+}
+
+// The processors this process may run on.
+inline CpuInfo getCpuInfo() {
+    Logger::trace("Getting CPU info");
+
+    auto cpu_info = sysfs::getCpuInfo();
+    if (!cpu_info) cpu_info = proc::getCpuInfo();
+
+    restrictTo(*cpu_info, cgroup::allowedProcessors());
+
+    return *cpu_info;
+}
+
+// Processors the cgroup's cpu quota pays for, if it has one.
+inline std::optional<int> cpuQuota() { return cgroup::cpuQuota(); }
+
 }  // namespace fastchess::affinity::cpu_info
\ No newline at end of file
@@ -4,6 +4,7 @@
 #include <array>
 #include <map>
 #include <memory>
+#include <optional>
 #include <thread>
 #include <vector>
 
@@ -73,4 +74,7 @@ inline CpuInfo getCpuInfo() noexcept(false) {
     return cpu_info;
 }
 
+// Cpu rate limits are not read yet.
+inline std::optional<int> cpuQuota() noexcept { return std::nullopt; }
+
 }  // namespace fastchess::affinity::cpu_info
\ No newline at end of file
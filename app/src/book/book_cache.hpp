@@ -0,0 +1,70 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <tuple>
+#include <variant>
+#include <vector>
+
+#include <pgn/pgn_reader.hpp>
+#include <types/enums.hpp>
+#include <util/file_system.hpp>
+
+namespace fastchess::book {
+
+// Openings of an epd or pgn file in file order.
+using Openings = std::variant<std::vector<std::string>, std::vector<pgn::Opening>>;
+
+// Keeps parsed opening books in memory, so tournaments which use the same book don't read
+// it again. A book is parsed again once the file was modified.
+class BookCache {
+   public:
+    using Loader = std::function<Openings(const std::string &, FormatType, int)>;
+
+    [[nodiscard]] std::shared_ptr<const Openings> get(const std::string &file, FormatType type, int plies,
+                                                      const Loader &load) {
+        const auto modified = lastModified(file);
+        const auto key      = std::make_tuple(file, type, plies);
+
+        // parse under the lock, a second tournament with the same book waits instead of parsing it too
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        const auto it = books_.find(key);
+        if (it != books_.end() && it->second.modified == modified) return it->second.openings;
+
+        auto openings = std::make_shared<const Openings>(load(file, type, plies));
+        books_[key]   = {modified, openings};
+
+        return openings;
+    }
+
+    [[nodiscard]] std::size_t size() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return books_.size();
+    }
+
+   private:
+    struct Entry {
+        std::int64_t modified;
+        std::shared_ptr<const Openings> openings;
+    };
+
+    // without std::filesystem a modified book is only noticed after a restart
+    [[nodiscard]] static std::int64_t lastModified([[maybe_unused]] const std::string &file) {
+#ifndef NO_STD_FILESYSTEM
+        std::error_code ec;
+        const auto time = std::filesystem::last_write_time(file, ec);
+        if (!ec) return static_cast<std::int64_t>(time.time_since_epoch().count());
+#endif
+        return 0;
+    }
+
+    std::mutex mutex_;
+    std::map<std::tuple<std::string, FormatType, int>, Entry> books_;
+};
+
+}  // namespace fastchess::book
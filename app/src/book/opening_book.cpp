@@ -10,7 +10,7 @@
 
 namespace fastchess::book {
 
-OpeningBook::OpeningBook(const config::Tournament& config, std::size_t initial_matchcount) {
+OpeningBook::OpeningBook(const config::Tournament& config, std::size_t initial_matchcount, BookCache* cache) {
     start_  = config.opening.start;
     games_  = config.games;
     rounds_ = config.rounds;
@@ -19,34 +19,43 @@ OpeningBook::OpeningBook(const config::Tournament& config, std::size_t initial_m
 
     // - 1 because start starts at 1 in the opening options
     offset_ = start_ - 1 + initial_matchcount / games_;
-    setup(config.opening.file, config.opening.format);
+    setup(config.opening.file, config.opening.format, cache);
 }
 
-void OpeningBook::setup(const std::string& file, FormatType type) {
-    if (file.empty()) {
-        return;
-    }
+Openings OpeningBook::load(const std::string& file, FormatType type, int plies) {
+    if (type == FormatType::PGN) {
+        auto openings = pgn::PgnReader(file, plies).getOpenings();
 
-    std::visit([](auto&& arg) { arg.clear(); }, book_);
+        if (openings.empty()) throw std::runtime_error("No openings found in PGN file: " + file);
 
-    if (type == FormatType::PGN) {
-        book_ = pgn::PgnReader(file, plies_).getOpenings();
+        return openings;
+    }
+
+    epd_book openings;
 
-        if (std::get<pgn_book>(book_).empty()) throw std::runtime_error("No openings found in PGN file: " + file);
-    } else if (type == FormatType::EPD) {
+    if (type == FormatType::EPD) {
         std::ifstream openingFile;
         openingFile.open(file);
 
         std::string line;
         while (util::safeGetline(openingFile, line))
-            if (!line.empty()) std::get<epd_book>(book_).emplace_back(line);
+            if (!line.empty()) openings.emplace_back(line);
 
         openingFile.close();
 
-        if (std::get<epd_book>(book_).empty()) throw std::runtime_error("No openings found in EPD file: " + file);
+        if (openings.empty()) throw std::runtime_error("No openings found in EPD file: " + file);
+    }
+
+    return openings;
+}
+
+void OpeningBook::setup(const std::string& file, FormatType type, BookCache* cache) {
+    if (file.empty() || type == FormatType::NONE) {
+        return;
     }
 
-    if (type == FormatType::NONE) return;
+    // the cached book is shared, this tournament shuffles its own copy
+    book_ = cache ? *cache->get(file, type, plies_, load) : load(file, type, plies_);
 
     if (order_ == OrderType::RANDOM) {
         Logger::info("Indexing opening suite...");
@@ -5,6 +5,7 @@
 #include <variant>
 #include <vector>
 
+#include <book/book_cache.hpp>
 #include <config/config.hpp>
 #include <pgn/pgn_reader.hpp>
 #include <types/enums.hpp>
@@ -16,7 +17,12 @@ namespace fastchess::book {
 class OpeningBook {
    public:
     OpeningBook() = default;
-    explicit OpeningBook(const config::Tournament& config, std::size_t initial_matchcount = 0);
+    // The parsed file is taken from the cache if one is given.
+    explicit OpeningBook(const config::Tournament& config, std::size_t initial_matchcount = 0,
+                         BookCache* cache = nullptr);
+
+    // Reads the openings of the file in file order.
+    [[nodiscard]] static Openings load(const std::string& file, FormatType type, int plies);
 
     // Fisher-Yates / Knuth shuffle
     void shuffle() {
@@ -81,7 +87,7 @@ class OpeningBook {
     }
 
    private:
-    void setup(const std::string& file, FormatType type);
+    void setup(const std::string& file, FormatType type, BookCache* cache);
 
     using epd_book = std::vector<std::string>;
     using pgn_book = std::vector<pgn::Opening>;
@@ -93,7 +99,7 @@ class OpeningBook {
     int games_;
     int plies_;
     OrderType order_;
-    std::variant<epd_book, pgn_book> book_;
+    Openings book_;
 };
 
 }  // namespace fastchess::book
@@ -1,7 +1,10 @@
 #include <cli/cli.hpp>
 
+#include <algorithm>
 #include <random>
 
+#include <config/planner.hpp>
+#include <matchmaking/journal/journal.hpp>
 #include <matchmaking/output/output_factory.hpp>
 #include <matchmaking/scoreboard.hpp>
 #include <types/engine_config.hpp>
@@ -145,6 +148,27 @@ void parseEngineKeyValues(EngineConfiguration &engineConfig, const std::string &
         engineConfig.dir = value;
     else if (key == "args")
         engineConfig.args = value;
+    else if (key == "sandbox" && is_bool(value))
+        engineConfig.sandbox.enabled = value == "true";
+    else if (key == "sandbox.cpus" || key == "sandbox.memory" || key == "sandbox.pids") {
+        engineConfig.sandbox.enabled = true;
+
+        if (key == "sandbox.cpus") engineConfig.sandbox.cpus = std::stod(value);
+        if (key == "sandbox.memory") engineConfig.sandbox.memory = std::stoull(value);
+        if (key == "sandbox.pids") engineConfig.sandbox.pids = std::stoi(value);
+    } else if (key == "nice")
+        engineConfig.scheduling.nice = std::stoi(value);
+    else if (key == "sched") {
+        if (value == "other")
+            engineConfig.scheduling.policy = SchedulingPolicy::OTHER;
+        else if (value == "fifo")
+            engineConfig.scheduling.policy = SchedulingPolicy::FIFO;
+        else if (value == "rr")
+            engineConfig.scheduling.policy = SchedulingPolicy::RR;
+        else
+            OptionsParser::throwMissing("engine", key, value);
+    } else if (key == "sched.priority")
+        engineConfig.scheduling.priority = std::stoi(value);
     else if (isEngineSettableOption(key)) {
         // Strip option.Name of the option. Part
         const std::size_t pos         = key.find('.');
@@ -191,6 +215,8 @@ void parsePgnOut(const std::vector<std::string> &params, ArgumentData &argument_
                 argument_data.tournament_config.pgn.track_hashfull = value == "true";
             } else if (key == "tbhits" && is_bool(value)) {
                 argument_data.tournament_config.pgn.track_tbhits = value == "true";
+            } else if (key == "usage" && is_bool(value)) {
+                argument_data.tournament_config.pgn.track_usage = value == "true";
             } else if (key == "min" && is_bool(value)) {
                 argument_data.tournament_config.pgn.min = value == "true";
             } else if (key == "notation") {
@@ -233,6 +259,27 @@ void parseEpdOut(const std::vector<std::string> &params, ArgumentData &argument_
         throw std::runtime_error("Please specify filename for epd output.");
 }
 
+void parseDataOut(const std::vector<std::string> &params, ArgumentData &argument_data) {
+    parseDashOptions(params, [&](const std::string &key, const std::string &value) {
+        if (key == "file") {
+            argument_data.tournament_config.dataout.file = value;
+        } else if (key == "skipchecks" && is_bool(value)) {
+            argument_data.tournament_config.dataout.skip_checks = value == "true";
+        } else if (key == "skipcaptures" && is_bool(value)) {
+            argument_data.tournament_config.dataout.skip_captures = value == "true";
+        } else if (key == "maxscore") {
+            argument_data.tournament_config.dataout.max_score = std::stoi(value);
+            if (argument_data.tournament_config.dataout.max_score < 0)
+                throw std::runtime_error("Score cannot be negative.");
+        } else {
+            OptionsParser::throwMissing("dataout", key, value);
+        }
+    });
+
+    if (argument_data.tournament_config.dataout.file.empty())
+        throw std::runtime_error("Please specify filename for data output.");
+}
+
 void parseOpening(const std::vector<std::string> &params, ArgumentData &argument_data) {
     parseDashOptions(params, [&](const std::string &key, const std::string &value) {
         if (key == "file") {
@@ -351,6 +398,167 @@ void parseAutoSaveInterval(const std::vector<std::string> &params, ArgumentData
     parseValue(params, argument_data.tournament_config.autosaveinterval);
 }
 
+void parseJournal(const std::vector<std::string> &params, ArgumentData &argument_data) {
+    parseDashOptions(params, [&](const std::string &key, const std::string &value) {
+        if (key == "file") {
+            argument_data.tournament_config.journal.file = value;
+        } else if (key == "sync") {
+            argument_data.tournament_config.journal.sync_interval = std::stoi(value);
+            if (argument_data.tournament_config.journal.sync_interval < 1)
+                throw std::runtime_error("The sync interval must be at least 1.");
+        } else {
+            OptionsParser::throwMissing("journal", key, value);
+        }
+    });
+
+    if (argument_data.tournament_config.journal.file.empty())
+        throw std::runtime_error("Please specify filename for the journal.");
+}
+
+void parseTrace(const std::vector<std::string> &params, ArgumentData &argument_data) {
+    parseDashOptions(params, [&](const std::string &key, const std::string &value) {
+        if (key == "file") {
+            argument_data.tournament_config.trace.file = value;
+        } else {
+            OptionsParser::throwMissing("trace", key, value);
+        }
+    });
+
+    if (argument_data.tournament_config.trace.file.empty())
+        throw std::runtime_error("Please specify filename for the trace.");
+}
+
+void parseMetrics(const std::vector<std::string> &params, ArgumentData &argument_data) {
+    auto &metrics = argument_data.tournament_config.metrics;
+
+    parseDashOptions(params, [&](const std::string &key, const std::string &value) {
+        if (key == "host") {
+            metrics.host = value;
+        } else if (key == "port" && is_number(value)) {
+            metrics.port = std::stoi(value);
+        } else if (key == "file") {
+            metrics.file = value;
+        } else if (key == "interval" && is_number(value)) {
+            metrics.interval = std::stoi(value);
+        } else {
+            OptionsParser::throwMissing("metrics", key, value);
+        }
+    });
+
+    if (metrics.port == 0 && metrics.file.empty())
+        throw std::runtime_error("Please specify a port or a filename for the metrics.");
+    if (metrics.port < 0 || metrics.port > 65535) throw std::runtime_error("Please specify a valid port.");
+    if (metrics.interval < 1) throw std::runtime_error("The metrics interval must be at least 1.");
+}
+
+void parseShard(const std::vector<std::string> &params, ArgumentData &argument_data) {
+    std::string val;
+    parseValue(params, val);
+
+    const auto slash = val.find('/');
+    if (slash == std::string::npos || !is_number(val.substr(0, slash)) || !is_number(val.substr(slash + 1)))
+        throw std::runtime_error("The shard has to be specified as k/n.");
+
+    auto &shard = argument_data.tournament_config.shard;
+    shard.index = std::stoi(val.substr(0, slash));
+    shard.total = std::stoi(val.substr(slash + 1));
+
+    if (shard.total < 1 || shard.index < 1 || shard.index > shard.total)
+        throw std::runtime_error("The shard index has to be between 1 and the number of shards.");
+}
+
+void parseMerge(const std::vector<std::string> &params, ArgumentData &argument_data) {
+    if (params.empty()) throw std::runtime_error("Please specify the files to merge.");
+
+    argument_data.merge_files.insert(argument_data.merge_files.end(), params.begin(), params.end());
+}
+
+void parseCoordinator(const std::vector<std::string> &params, ArgumentData &argument_data) {
+    auto &coordinator = argument_data.tournament_config.coordinator;
+
+    parseDashOptions(params, [&](const std::string &key, const std::string &value) {
+        if (key == "host") {
+            coordinator.host = value;
+        } else if (key == "port" && is_number(value)) {
+            coordinator.port = std::stoi(value);
+        } else {
+            OptionsParser::throwMissing("coordinator", key, value);
+        }
+    });
+
+    if (coordinator.port < 1 || coordinator.port > 65535) throw std::runtime_error("Please specify a valid port.");
+}
+
+void parseWorker(const std::vector<std::string> &params, ArgumentData &argument_data) {
+    parseDashOptions(params, [&](const std::string &key, const std::string &value) {
+        if (key == "host") {
+            argument_data.worker.host = value;
+        } else if (key == "port" && is_number(value)) {
+            argument_data.worker.port = std::stoi(value);
+        } else {
+            OptionsParser::throwMissing("worker", key, value);
+        }
+    });
+
+    if (argument_data.worker.port < 1 || argument_data.worker.port > 65535)
+        throw std::runtime_error("Please specify the port of the coordinator.");
+}
+
+// -daemon, -submit, -status and -cancel only differ in the command sent to the daemon
+void parseDaemonCommand(const std::vector<std::string> &params, ArgumentData &argument_data,
+                        config::Daemon::Command command, std::string_view name) {
+    argument_data.daemon.command = command;
+
+    parseDashOptions(params, [&](const std::string &key, const std::string &value) {
+        if (key == "socket") {
+            argument_data.daemon.socket = value;
+        } else if (key == "id" && command == config::Daemon::Command::CANCEL && is_number(value)) {
+            argument_data.daemon.id = std::stoull(value);
+        } else {
+            OptionsParser::throwMissing(name, key, value);
+        }
+    });
+
+    if (argument_data.daemon.socket.empty()) throw std::runtime_error("Please specify the socket of the daemon.");
+
+    if (command == config::Daemon::Command::CANCEL && argument_data.daemon.id == 0)
+        throw std::runtime_error("Please specify the id of the test to cancel.");
+}
+
+void parseDaemon(const std::vector<std::string> &params, ArgumentData &argument_data) {
+    parseDaemonCommand(params, argument_data, config::Daemon::Command::SERVE, "daemon");
+}
+
+void parseSubmit(const std::vector<std::string> &params, ArgumentData &argument_data) {
+    parseDaemonCommand(params, argument_data, config::Daemon::Command::SUBMIT, "submit");
+}
+
+void parseStatus(const std::vector<std::string> &params, ArgumentData &argument_data) {
+    parseDaemonCommand(params, argument_data, config::Daemon::Command::STATUS, "status");
+}
+
+void parseCancel(const std::vector<std::string> &params, ArgumentData &argument_data) {
+    parseDaemonCommand(params, argument_data, config::Daemon::Command::CANCEL, "cancel");
+}
+
+void parseTest(const std::vector<std::string> &params, ArgumentData &argument_data) {
+    config::Test test;
+
+    parseDashOptions(params, [&](const std::string &key, const std::string &value) {
+        if (key == "config") {
+            test.file = value;
+        } else if (key == "weight" && is_number(value)) {
+            test.weight = std::stoi(value);
+        } else {
+            OptionsParser::throwMissing("test", key, value);
+        }
+    });
+
+    if (test.file.empty()) throw std::runtime_error("Please specify the config file of the test.");
+
+    argument_data.tests.push_back(test);
+}
+
 void parseLog(const std::vector<std::string> &params, ArgumentData &argument_data) {
     std::string filename;
     parseDashOptions(params, [&](const std::string &key, const std::string &value) {
@@ -397,6 +605,7 @@ void loadJson(ArgumentData &argument_data, const std::string &filename) {
     argument_data.old_tournament_config = argument_data.tournament_config;
 
     argument_data.tournament_config = jsonfile.get<config::Tournament>();
+    argument_data.seed_given        = jsonfile.contains("seed");
 
     argument_data.configs.clear();
 
@@ -444,8 +653,13 @@ void parseReport(const std::vector<std::string> &params, ArgumentData &argument_
 
 void parseOutput(const std::vector<std::string> &params, ArgumentData &argument_data) {
     parseDashOptions(params, [&](const std::string &key, const std::string &value) {
-        if (key == "format" && (value == "cutechess" || value == "fastchess")) {
+        if (key == "format" &&
+            (value == "cutechess" || value == "fastchess" || value == "json" || value == "status")) {
             argument_data.tournament_config.output = OutputFactory::getType(value);
+        } else if (key == "file") {
+            argument_data.tournament_config.output_file = value;
+        } else if (key == "games" && is_bool(value)) {
+            argument_data.tournament_config.output_games = value == "true";
         } else {
             OptionsParser::throwMissing("output", key, value);
         }
@@ -456,6 +670,20 @@ void parseConcurrency(const std::vector<std::string> &params, ArgumentData &argu
     parseValue(params, argument_data.tournament_config.concurrency);
 }
 
+void parseAutoConcurrency(const std::vector<std::string> &, ArgumentData &argument_data) {
+    argument_data.tournament_config.autoconcurrency = true;
+}
+
+void parseWeight(const std::vector<std::string> &params, ArgumentData &argument_data) {
+    parseValue(params, argument_data.tournament_config.weight);
+
+    if (argument_data.tournament_config.weight < 1) throw std::runtime_error("The weight must be at least 1.");
+}
+
+void parseMaxEngines(const std::vector<std::string> &params, ArgumentData &argument_data) {
+    parseValue(params, argument_data.tournament_config.maxengines);
+}
+
 void parseEvent(const std::vector<std::string> &params, ArgumentData &argument_data) {
     argument_data.tournament_config.pgn.event_name = concat(params);
 }
@@ -486,6 +714,7 @@ void parseScoreinterval(const std::vector<std::string> &params, ArgumentData &ar
 
 void parseSRand(const std::vector<std::string> &params, ArgumentData &argument_data) {
     parseValue(params, argument_data.tournament_config.seed);
+    argument_data.seed_given = true;
 }
 
 void parseVersion(const std::vector<std::string> &, ArgumentData &) { OptionsParser::printVersion(); }
@@ -513,10 +742,24 @@ void parseVariant(const std::vector<std::string> &params, ArgumentData &argument
     if (val != "fischerandom" && val != "standard") throw std::runtime_error("Unknown variant.");
 }
 
-void parseTournament(const std::vector<std::string> &params, ArgumentData &) {
+void parseTournament(const std::vector<std::string> &params, ArgumentData &argument_data) {
     std::string val;
-    // Do nothing
+
     parseValue(params, val);
+
+    if (val == "gauntlet") {
+        argument_data.tournament_config.type = TournamentType::GAUNTLET;
+    } else if (val == "adaptive") {
+        argument_data.tournament_config.type = TournamentType::ADAPTIVE;
+    } else if (val == "roundrobin" || val == "round-robin") {
+        argument_data.tournament_config.type = TournamentType::ROUNDROBIN;
+    } else {
+        throw std::runtime_error("Unknown tournament type " + val + ".");
+    }
+}
+
+void parseErrorbar(const std::vector<std::string> &params, ArgumentData &argument_data) {
+    parseValue(params, argument_data.tournament_config.errorbar);
 }
 
 void parseQuick(const std::vector<std::string> &params, ArgumentData &argument_data) {
@@ -552,8 +795,7 @@ void parseQuick(const std::vector<std::string> &params, ArgumentData &argument_d
     argument_data.tournament_config.games  = 2;
     argument_data.tournament_config.rounds = 25000;
 
-    argument_data.tournament_config.concurrency =
-        std::max(static_cast<int>(1), static_cast<int>(std::thread::hardware_concurrency() - 2));
+    argument_data.tournament_config.concurrency = std::max(1, config::Machine::detect().processors - 2);
 
     argument_data.tournament_config.recover = true;
 
@@ -565,8 +807,18 @@ void parseQuick(const std::vector<std::string> &params, ArgumentData &argument_d
     argument_data.tournament_config.output = OutputType::CUTECHESS;
 }
 
-void parseAffinity(const std::vector<std::string> &, ArgumentData &argument_data) {
+void parseAffinity(const std::vector<std::string> &params, ArgumentData &argument_data) {
     argument_data.tournament_config.affinity = true;
+
+    parseDashOptions(params, [&](const std::string &key, const std::string &value) {
+        if (key == "policy" && value == "shared") {
+            argument_data.tournament_config.affinity_policy = AffinityPolicy::SHARED;
+        } else if (key == "policy" && value == "dedicated") {
+            argument_data.tournament_config.affinity_policy = AffinityPolicy::DEDICATED;
+        } else {
+            OptionsParser::throwMissing("use-affinity", key, value);
+        }
+    });
 }
 
 void parseDebug(const std::vector<std::string> &, ArgumentData &) {
@@ -589,17 +841,33 @@ OptionsParser::OptionsParser(int argc, char const *argv[]) {
     addOption("each", parseEach);
     addOption("pgnout", parsePgnOut);
     addOption("epdout", parseEpdOut);
+    addOption("dataout", parseDataOut);
     addOption("openings", parseOpening);
     addOption("sprt", parseSprt);
     addOption("draw", parseDraw);
     addOption("resign", parseResign);
     addOption("maxmoves", parseMaxMoves);
     addOption("autosaveinterval", parseAutoSaveInterval);
+    addOption("journal", parseJournal);
+    addOption("shard", parseShard);
+    addOption("merge", parseMerge);
+    addOption("coordinator", parseCoordinator);
+    addOption("worker", parseWorker);
+    addOption("daemon", parseDaemon);
+    addOption("submit", parseSubmit);
+    addOption("status", parseStatus);
+    addOption("cancel", parseCancel);
+    addOption("test", parseTest);
     addOption("log", parseLog);
+    addOption("trace", parseTrace);
+    addOption("metrics", parseMetrics);
     addOption("config", json_config::parseConfig);
     addOption("report", parseReport);
     addOption("output", parseOutput);
     addOption("concurrency", parseConcurrency);
+    addOption("autoconcurrency", parseAutoConcurrency);
+    addOption("weight", parseWeight);
+    addOption("maxengines", parseMaxEngines);
     addOption("event", parseEvent);
     addOption("site", parseSite);
     addOption("games", parseGames);
@@ -618,6 +886,7 @@ OptionsParser::OptionsParser(int argc, char const *argv[]) {
     addOption("repeat", parseRepeat);
     addOption("variant", parseVariant);
     addOption("tournament", parseTournament);
+    addOption("errorbar", parseErrorbar);
     addOption("quick", parseQuick);
     addOption("use-affinity", parseAffinity);
     addOption("debug", parseDebug);
@@ -628,6 +897,19 @@ OptionsParser::OptionsParser(int argc, char const *argv[]) {
     for (auto &config : argument_data_.configs) {
         config.variant = argument_data_.tournament_config.variant;
     }
+
+    // every shard has to play the openings in the same order
+    if (argument_data_.tournament_config.shard.total > 1 &&
+        argument_data_.tournament_config.opening.order == OrderType::RANDOM && !argument_data_.seed_given) {
+        throw std::runtime_error(
+            "Error; The openings of a sharded tournament are shuffled, use the same -srand for all shards.");
+    }
+
+    // a resumed journal has to use the same seed to replay the same openings
+    if (!argument_data_.tournament_config.journal.file.empty()) {
+        const auto seed = Journal::readSeed(argument_data_.tournament_config.journal.file);
+        if (seed.has_value()) argument_data_.tournament_config.seed = *seed;
+    }
 }
 
 }  // namespace fastchess::cli
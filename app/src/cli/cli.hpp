@@ -16,6 +16,7 @@
 #include <cli/man.hpp>
 #include <config/config.hpp>
 #include <matchmaking/scoreboard.hpp>
+#include <types/daemon.hpp>
 #include <types/engine_config.hpp>
 #include <types/tournament.hpp>
 
@@ -33,12 +34,27 @@ struct ArgumentData {
     /*previous olded values before config*/
     config::Tournament old_tournament_config;
 
+    // the seed was set with -srand or by a config file, not drawn at random
+    bool seed_given = false;
+
     stats_map stats;
 
     // Holds all the engines with their options
     std::vector<EngineConfiguration> configs;
 
     std::vector<EngineConfiguration> old_configs;
+
+    // Result files of shards which should be merged instead of playing a tournament
+    std::vector<std::string> merge_files;
+
+    // Coordinator to play games for instead of running a tournament, port 0 if unused
+    config::Worker worker;
+
+    // Daemon to run or to send the tournament to, Command::NONE if unused
+    config::Daemon daemon;
+
+    // Config files of tests which are played in parallel instead of the tournament
+    std::vector<config::Test> tests;
 };
 
 class OptionsParser {
@@ -106,6 +122,14 @@ class OptionsParser {
 
     [[nodiscard]] stats_map getResults() const { return argument_data_.stats; }
 
+    [[nodiscard]] std::vector<std::string> getMergeFiles() const { return argument_data_.merge_files; }
+
+    [[nodiscard]] config::Worker getWorker() const { return argument_data_.worker; }
+
+    [[nodiscard]] config::Daemon getDaemon() const { return argument_data_.daemon; }
+
+    [[nodiscard]] std::vector<config::Test> getTests() const { return argument_data_.tests; }
+
    private:
     // Adds an option to the parser
     void addOption(const std::string &optionName, parseFunc func) {
@@ -0,0 +1,180 @@
+#include <config/planner.hpp>
+
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <thread>
+
+#include <affinity/affinity_manager.hpp>
+#include <util/logger/logger.hpp>
+
+namespace fastchess::config {
+
+namespace {
+
+// Hash of an engine without the option, the default of most engines
+constexpr int DEFAULT_HASH = 16;
+
+// share of the available memory the engines may use, the rest is left to the system
+constexpr double MEMORY_SHARE = 0.9;
+
+std::optional<std::uint64_t> availableMemory() {
+#ifdef _WIN32
+    MEMORYSTATUSEX status;
+    status.dwLength = sizeof(status);
+    if (!GlobalMemoryStatusEx(&status)) return std::nullopt;
+
+    return status.ullAvailPhys / (1024 * 1024);
+#elif defined(__linux__)
+    std::ifstream meminfo("/proc/meminfo");
+
+    std::string line;
+    while (std::getline(meminfo, line)) {
+        std::istringstream fields(line);
+
+        std::string key;
+        std::uint64_t kib = 0;
+
+        if (fields >> key >> kib && key == "MemAvailable:") return kib / 1024;
+    }
+
+    return std::nullopt;
+#else
+    return std::nullopt;
+#endif
+}
+
+int option(const EngineConfiguration &engine, std::string_view name, int fallback) {
+    try {
+        return engine.getOption<int>(name, [](const std::string &value) { return std::stoi(value); })
+            .value_or(fallback);
+    } catch (const std::exception &) {
+        return fallback;
+    }
+}
+
+}  // namespace
+
+Machine Machine::detect() {
+    Machine machine;
+
+    const auto cpu_info = affinity::cpu_info::getCpuInfo();
+
+    int processors = 0, cores = 0;
+    for (const auto &[physical_id, physical_cpu] : cpu_info.physical_cpus) {
+        for (const auto &[core_id, core] : physical_cpu.cores) {
+            processors += static_cast<int>(core.processors.size());
+            cores++;
+        }
+    }
+
+    // without a topology every processor counts as a core
+    const auto hardware = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+
+    machine.processors = processors > 0 ? processors : hardware;
+    machine.cores      = cores > 0 ? cores : machine.processors;
+    machine.memory     = availableMemory();
+    machine.topology   = cpu_info;
+
+    // a cpu quota pays for fewer processors than the ones the process may run on
+    if (const auto quota = affinity::cpu_info::cpuQuota(); quota && *quota < machine.processors) {
+        machine.processors = *quota;
+        machine.cores      = std::min(machine.cores, *quota);
+    }
+
+    return machine;
+}
+
+Plan plan(const Tournament &config, const std::vector<EngineConfiguration> &engines, const Machine &machine) {
+    Plan plan;
+
+    std::vector<std::uint64_t> hashes;
+    for (const auto &engine : engines) {
+        plan.threads = std::max(plan.threads, option(engine, "Threads", 1));
+        hashes.push_back(std::max(0, option(engine, "Hash", DEFAULT_HASH)));
+    }
+
+    if (config.affinity && config.affinity_policy == AffinityPolicy::DEDICATED) plan.threads *= 2;
+
+    // the two largest hashes may meet in one game
+    std::sort(hashes.rbegin(), hashes.rend());
+    for (std::size_t i = 0; i < std::min<std::size_t>(2, hashes.size()); i++) plan.memory_per_game += hashes[i];
+
+    plan.concurrency = config.concurrency;
+
+    const auto threads = plan.threads;
+    auto by_cores      = machine.processors / threads;
+
+    // pinned games get the sets of the affinity manager, fewer games may get whole cores
+    // and so fewer sets
+    if (config.affinity && !machine.topology.physical_cpus.empty()) {
+        auto concurrency = std::min(plan.concurrency, by_cores);
+
+        for (;;) {
+            const auto sets = static_cast<int>(affinity::AffinityManager::sets(machine.topology, threads, concurrency));
+            if (sets >= concurrency) break;
+
+            concurrency = sets;
+        }
+
+        by_cores = std::min(by_cores, concurrency);
+    }
+
+    if (by_cores < plan.concurrency) {
+        plan.concurrency = std::max(1, by_cores);
+        plan.reason      = fmt::format("{} processors fit {} games with {} processors", machine.processors, by_cores,
+                                       threads);
+    }
+
+    if (!machine.memory) return plan;
+
+    const auto usable = static_cast<std::uint64_t>(*machine.memory * MEMORY_SHARE);
+
+    // the engine cache keeps more engines than two per game with -maxengines
+    const auto idle = [&](int concurrency) -> std::uint64_t {
+        const auto extra = std::max(0, config.maxengines - 2 * concurrency);
+        return extra * (hashes.empty() ? 0 : hashes.front());
+    };
+
+    const auto fits = [&](int concurrency) {
+        return concurrency * plan.memory_per_game + idle(concurrency) <= usable;
+    };
+
+    if (!fits(plan.concurrency)) {
+        while (plan.concurrency > 0 && !fits(plan.concurrency)) plan.concurrency--;
+
+        plan.reason = fmt::format("{} MiB of available memory fit {} games with {} MiB of Hash", *machine.memory,
+                                  plan.concurrency, plan.memory_per_game);
+    }
+
+    plan.memory_idle = idle(std::max(1, plan.concurrency));
+
+    return plan;
+}
+
+Plan applyPlan(Tournament &config, const std::vector<EngineConfiguration> &engines, const Machine &machine) {
+    const auto result = plan(config, engines, machine);
+
+    Logger::trace("Planned {} games at once, {} threads and {} MiB of Hash per game, {} MiB for idle engines",
+                  result.concurrency, result.threads, result.memory_per_game, result.memory_idle);
+
+    if (result.concurrency < 1) {
+        throw std::runtime_error("Error; Not even a single game fits into the available memory, " + result.reason +
+                                 ".");
+    }
+
+    if (result.threads > machine.processors) {
+        Logger::warn("Warning; The engines use {} threads, but the machine only has {} processors.", result.threads,
+                     machine.processors);
+    }
+
+    if (result.concurrency < config.concurrency) {
+        Logger::warn("Warning; Lowering the concurrency from {} to {}, {}.", config.concurrency, result.concurrency,
+                     result.reason);
+        config.concurrency = result.concurrency;
+    }
+
+    return result;
+}
+
+}  // namespace fastchess::config
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <affinity/cpuinfo/cpu_info.hpp>
+#include <types/engine_config.hpp>
+#include <types/tournament.hpp>
+
+namespace fastchess::config {
+
+// Hardware fastchess runs on.
+struct Machine {
+    // logical processors and physical cores this process may use
+    int processors = 1;
+    int cores      = 1;
+
+    // cores of the processors, the pinned games are planned with the sets they get from it
+    affinity::cpu_info::CpuInfo topology;
+
+    // memory which can be used without swapping, in MiB
+    std::optional<std::uint64_t> memory;
+
+    [[nodiscard]] static Machine detect();
+};
+
+// How many games fit on the machine at once.
+struct Plan {
+    // processors of one game, the engines of a game take turns thinking unless they are
+    // pinned to their own cores
+    int threads = 1;
+
+    // Hash of both engines of a game and of the idle engines the cache keeps, in MiB
+    std::uint64_t memory_per_game = 0;
+    std::uint64_t memory_idle     = 0;
+
+    // games at once which neither share a processor nor exceed the memory
+    int concurrency = 1;
+
+    // why the concurrency is lower than requested, empty if it isn't
+    std::string reason;
+};
+
+// The largest concurrency up to the requested one which doesn't oversubscribe the machine.
+[[nodiscard]] Plan plan(const Tournament &config, const std::vector<EngineConfiguration> &engines,
+                        const Machine &machine);
+
+// Lowers the concurrency to the plan, throws if not even a single game fits into the memory.
+Plan applyPlan(Tournament &config, const std::vector<EngineConfiguration> &engines,
+               const Machine &machine = Machine::detect());
+
+}  // namespace fastchess::config
@@ -3,10 +3,10 @@
 #include <algorithm>
 #include <limits>
 #include <random>
-#include <thread>
 #include <utility>
 #include <vector>
 
+#include <config/planner.hpp>
 #include <util/file_system.hpp>
 #include <util/logger/logger.hpp>
 
@@ -27,6 +27,10 @@ void sanitize(config::Tournament& config) {
 
     if (config.report_penta && config.games != 2) config.report_penta = false;
 
+    if (!config.output_file.empty() && config.output != OutputType::JSON) {
+        throw std::runtime_error("Error; Only the json output can be written to a file.");
+    }
+
     // throw error for invalid sprt config
     if (config.sprt.enabled) {
         if (config.sprt.elo0 >= config.sprt.elo1) {
@@ -50,7 +54,25 @@ void sanitize(config::Tournament& config) {
         }
     }
 
-    config.concurrency = std::min(config.concurrency, static_cast<int>(std::thread::hardware_concurrency()));
+    // the games of a coordinator are played by the workers, not on this machine
+    if (config.coordinator.port == 0) {
+        config.concurrency = std::min(config.concurrency, Machine::detect().processors);
+    }
+
+    if (config.autoconcurrency && config.coordinator.port > 0) {
+        throw std::runtime_error("Error; The workers of a coordinator can't use -autoconcurrency.");
+    }
+
+    if (config.type != TournamentType::ROUNDROBIN && config.coordinator.port > 0) {
+        throw std::runtime_error("Error; Only a round robin can be played with -coordinator.");
+    }
+
+    if (config.type == TournamentType::ADAPTIVE) {
+        // the rounds are chosen from the results, they can't be split up front
+        if (config.shard.total > 1) throw std::runtime_error("Error; An adaptive round robin can't be sharded.");
+
+        if (config.errorbar <= 0) throw std::runtime_error("Error; The error bar must be positive.");
+    }
 
     if (config.variant == VariantType::FRC && config.opening.file.empty()) {
         throw std::runtime_error("Error: Please specify a Chess960 opening book");
@@ -72,13 +94,14 @@ void sanitize(config::Tournament& config) {
     if (config.scoreinterval == 0) config.scoreinterval = std::numeric_limits<int>::max();
 }
 
-void sanitize(std::vector<EngineConfiguration>& configs) {
+void sanitize(std::vector<EngineConfiguration>& configs, const config::Tournament& tournament) {
     if (configs.size() < 2) {
         throw std::runtime_error("Error: Need at least two engines to start!");
     }
 
-    if (configs.size() > 2) {
-        throw std::runtime_error("Error: Exceeded -engine limit! Must be 2!");
+    // the SPRT of a round robin would stop the tournament once the first pair is decided
+    if (configs.size() > 2 && tournament.sprt.enabled && tournament.type != TournamentType::GAUNTLET) {
+        throw std::runtime_error("Error; SPRT with more than two engines needs -tournament gauntlet!");
     }
 
     for (std::size_t i = 0; i < configs.size(); i++) {
@@ -98,6 +121,34 @@ void sanitize(std::vector<EngineConfiguration>& configs) {
         }
 #endif
 
+#ifndef __linux__
+        if (configs[i].sandbox.enabled) {
+            Logger::warn("Warning; Sandboxes need the cgroups of Linux, {} runs without one.", configs[i].name);
+        }
+
+        if (configs[i].scheduling.policy != SchedulingPolicy::OTHER) {
+            Logger::warn("Warning; Real time policies are only supported on Linux, {} runs without one.",
+                         configs[i].name);
+        }
+
+#    ifdef _WIN32
+        if (configs[i].scheduling.nice != 0) {
+            Logger::warn("Warning; Nice values are only supported on POSIX systems, {} runs without one.",
+                         configs[i].name);
+        }
+#    endif
+#endif
+
+        const auto &scheduling = configs[i].scheduling;
+
+        if (scheduling.nice < -20 || scheduling.nice > 19) {
+            throw std::runtime_error("Error; The nice value of an engine has to be between -20 and 19.");
+        }
+
+        if (scheduling.policy != SchedulingPolicy::OTHER && (scheduling.priority < 1 || scheduling.priority > 98)) {
+            throw std::runtime_error("Error; The real time priority of an engine has to be between 1 and 98.");
+        }
+
         if (configs[i].name.empty()) {
             throw std::runtime_error("Error; please specify a name for each engine!");
         }
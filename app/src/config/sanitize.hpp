@@ -7,6 +7,6 @@ namespace fastchess::config {
 
 void sanitize(config::Tournament&);
 
-void sanitize(std::vector<EngineConfiguration>&);
+void sanitize(std::vector<EngineConfiguration>&, const config::Tournament&);
 
 }  // namespace fastchess::config
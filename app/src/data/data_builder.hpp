@@ -0,0 +1,37 @@
+#pragma once
+
+#include <sstream>
+#include <string>
+
+#include <chess.hpp>
+
+#include <types/match_data.hpp>
+
+namespace fastchess::data {
+
+// Builds the training data records of a game, one "fen | score | wdl" line per position.
+// The score and the game result are given from white's point of view.
+class DataBuilder {
+   public:
+    DataBuilder(const MatchData &match) {
+        const auto wdl = getWdl(match.players.white.result);
+
+        for (const auto &position : match.positions) {
+            data << position.fen << " | " << position.score << " | " << wdl << "\n";
+        }
+    }
+
+    // Get the newly created data
+    [[nodiscard]] std::string get() const noexcept { return data.str(); }
+
+   private:
+    [[nodiscard]] static const char *getWdl(chess::GameResult white_result) noexcept {
+        if (white_result == chess::GameResult::WIN) return "1.0";
+        if (white_result == chess::GameResult::LOSE) return "0.0";
+        return "0.5";
+    }
+
+    std::stringstream data;
+};
+
+}  // namespace fastchess::data
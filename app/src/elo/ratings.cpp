@@ -0,0 +1,292 @@
+#include <elo/ratings.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+namespace fastchess::elo {
+
+namespace {
+
+// virtual draws between every two players, keep the ratings of players without a single
+// win or loss finite and connect players which didn't play each other yet
+constexpr double PRIOR_GAMES = 0.1;
+
+// virtual samples with the expected variance, a few results can't spread less than that
+constexpr double PRIOR_SAMPLES = 2.0;
+
+// largest change of a natural rating in one Newton step, about 170 Elo
+constexpr double MAX_STEP = 1.0;
+
+constexpr double CI95_ZSCORE = 1.959963984540054;
+
+// natural rating difference to Elo
+const double ELO_SCALE = 400.0 / std::log(10.0);
+
+// Cholesky decomposition of the symmetric positive definite n x n matrix, in place.
+bool cholesky(std::vector<double> &matrix, std::size_t n) {
+    for (std::size_t j = 0; j < n; j++) {
+        double diagonal = matrix[j * n + j];
+        for (std::size_t k = 0; k < j; k++) diagonal -= matrix[j * n + k] * matrix[j * n + k];
+
+        if (diagonal <= 0.0) return false;
+
+        const auto root   = std::sqrt(diagonal);
+        matrix[j * n + j] = root;
+
+        for (std::size_t i = j + 1; i < n; i++) {
+            double value = matrix[i * n + j];
+            for (std::size_t k = 0; k < j; k++) value -= matrix[i * n + k] * matrix[j * n + k];
+            matrix[i * n + j] = value / root;
+        }
+    }
+
+    return true;
+}
+
+// Solves L L^T x = b with the decomposition of cholesky(), b is replaced by x.
+void solveCholesky(const std::vector<double> &lower, std::size_t n, double *b) {
+    for (std::size_t i = 0; i < n; i++) {
+        for (std::size_t k = 0; k < i; k++) b[i] -= lower[i * n + k] * b[k];
+        b[i] /= lower[i * n + i];
+    }
+
+    for (std::size_t i = n; i-- > 0;) {
+        for (std::size_t k = i + 1; k < n; k++) b[i] -= lower[k * n + i] * b[k];
+        b[i] /= lower[i * n + i];
+    }
+}
+
+}  // namespace
+
+Ratings::Ratings(std::size_t players)
+    : players_(players),
+      results_(players * players),
+      dispersion_(players * players, 1.0),
+      ratings_(players, 0.0),
+      covariance_(players * players, 0.0) {}
+
+void Ratings::setResult(std::size_t i, std::size_t j, double score, double games) {
+    // without the single results, only the spread the model expects is known
+    Result result;
+    result.score   = score;
+    result.games   = games;
+    result.samples = 0.0;
+
+    setResult(i, j, result);
+}
+
+void Ratings::setResult(std::size_t i, std::size_t j, const Stats &stats, bool penta) {
+    Result result;
+    result.score = stats.wins + stats.draws / 2.0;
+    result.games = stats.wins + stats.draws + stats.losses;
+
+    if (penta) {
+        result.width   = 2.0;
+        result.samples = stats.penta_WW + stats.penta_WD + stats.penta_WL + stats.penta_DD + stats.penta_LD +
+                         stats.penta_LL;
+        result.squares = 4.0 * stats.penta_WW + 2.25 * stats.penta_WD + stats.penta_WL + stats.penta_DD +
+                         0.25 * stats.penta_LD;
+    } else {
+        result.samples = result.games;
+        result.squares = stats.wins + stats.draws / 4.0;
+    }
+
+    setResult(i, j, result);
+}
+
+void Ratings::setResult(std::size_t i, std::size_t j, const Result &result) {
+    // the same results from the view of the other player
+    Result other  = result;
+    other.score   = result.games - result.score;
+    other.squares = result.samples * result.width * result.width - 2.0 * result.width * result.score +
+                    result.squares;
+
+    results_[i * players_ + j] = result;
+    results_[j * players_ + i] = other;
+}
+
+void Ratings::solve() {
+    if (players_ < 2) return;
+
+    maximize();
+
+    // the spread of the results relative to the model, 1 if they are independent games
+    for (std::size_t i = 0; i < players_; i++) {
+        for (std::size_t j = 0; j < players_; j++) {
+            if (i == j) continue;
+
+            const auto &result   = results_[i * players_ + j];
+            const auto p         = probability(i, j);
+            const auto mean      = result.width * p;
+            const auto expected  = result.width * p * (1.0 - p);
+            const auto deviation = result.squares - 2.0 * mean * result.score + result.samples * mean * mean;
+
+            dispersion_[i * players_ + j] =
+                (std::max(0.0, deviation) + PRIOR_SAMPLES * expected) / ((result.samples + PRIOR_SAMPLES) * expected);
+        }
+    }
+
+    // the information matrix is singular, player 0 is held fixed and the others are inverted
+    const std::size_t n = players_ - 1;
+    std::vector<double> matrix(n * n, 0.0);
+
+    for (std::size_t i = 1; i < players_; i++) {
+        for (std::size_t j = 0; j < players_; j++) {
+            if (i == j) continue;
+
+            const auto info = (results_[i * players_ + j].games + PRIOR_GAMES) * information(i, j);
+            matrix[(i - 1) * n + i - 1] += info;
+            if (j > 0) matrix[(i - 1) * n + j - 1] -= info;
+        }
+    }
+
+    std::fill(covariance_.begin(), covariance_.end(), 0.0);
+
+    if (!cholesky(matrix, n)) return;
+
+    // the inverse is L^-T L^-1, both built row by row to walk the memory in order
+    std::vector<double> inverse(n * n, 0.0);
+    for (std::size_t i = 0; i < n; i++) {
+        auto *row = &inverse[i * n];
+        row[i]    = 1.0;
+
+        for (std::size_t k = 0; k < i; k++) {
+            const auto factor = matrix[i * n + k];
+            for (std::size_t l = 0; l <= k; l++) row[l] -= factor * inverse[k * n + l];
+        }
+
+        for (std::size_t l = 0; l <= i; l++) row[l] /= matrix[i * n + i];
+    }
+
+    for (std::size_t i = 0; i < n; i++) {
+        const auto *row = &inverse[i * n];
+
+        for (std::size_t a = 0; a <= i; a++) {
+            auto *target = &covariance_[(a + 1) * players_ + 1];
+            for (std::size_t b = 0; b <= a; b++) target[b] += row[a] * row[b];
+        }
+    }
+
+    for (std::size_t a = 1; a < players_; a++) {
+        for (std::size_t b = 1; b < a; b++) covariance_[b * players_ + a] = covariance_[a * players_ + b];
+    }
+}
+
+void Ratings::maximize() {
+    const std::size_t n = players_ - 1;
+
+    std::vector<double> hessian(n * n), step(n);
+
+    for (int iteration = 0; iteration < 100; iteration++) {
+        std::fill(hessian.begin(), hessian.end(), 0.0);
+        std::fill(step.begin(), step.end(), 0.0);
+
+        // gradient and negated hessian of the log likelihood, player 0 is held fixed
+        for (std::size_t i = 0; i < players_; i++) {
+            for (std::size_t j = i + 1; j < players_; j++) {
+                const auto &result = results_[i * players_ + j];
+                const auto p       = probability(i, j);
+                const auto games   = result.games + PRIOR_GAMES;
+                const auto weight  = games * p * (1.0 - p);
+
+                if (i > 0) {
+                    step[i - 1] += result.score + PRIOR_GAMES / 2 - games * p;
+                    hessian[(i - 1) * n + i - 1] += weight;
+                    hessian[(i - 1) * n + j - 1] -= weight;
+                    hessian[(j - 1) * n + i - 1] -= weight;
+                }
+
+                step[j - 1] -= result.score + PRIOR_GAMES / 2 - games * p;
+                hessian[(j - 1) * n + j - 1] += weight;
+            }
+        }
+
+        if (!cholesky(hessian, n)) return;
+        solveCholesky(hessian, n, step.data());
+
+        // far from the solution a full step may overshoot, no rating moves by more than
+        // MAX_STEP at once
+        double largest = 0.0;
+        for (const auto delta : step) largest = std::max(largest, std::abs(delta));
+
+        const auto scale = std::min(1.0, MAX_STEP / largest);
+        for (std::size_t i = 1; i < players_; i++) ratings_[i] += scale * step[i - 1];
+
+        // the ratings are only defined up to a constant, keep their average at 0
+        const auto mean = std::accumulate(ratings_.begin(), ratings_.end(), 0.0) / players_;
+        for (auto &rating : ratings_) rating -= mean;
+
+        if (scale * largest < 1e-9) break;
+    }
+}
+
+void Ratings::addGames(std::size_t i, std::size_t j, double games) {
+    // rank one update of the inverse, Sherman-Morrison
+    const auto weight = games * information(i, j);
+
+    std::vector<double> column(players_);
+    for (std::size_t k = 0; k < players_; k++) {
+        column[k] = covariance_[k * players_ + i] - covariance_[k * players_ + j];
+    }
+
+    const auto scale = weight / (1.0 + weight * (column[i] - column[j]));
+
+    for (std::size_t k = 0; k < players_; k++) {
+        for (std::size_t l = 0; l < players_; l++) covariance_[k * players_ + l] -= scale * column[k] * column[l];
+    }
+}
+
+double Ratings::elo(std::size_t i) const noexcept { return ratings_[i] * ELO_SCALE; }
+
+double Ratings::error(std::size_t i) const noexcept {
+    // variance of rating(i) minus the average rating
+    double row = 0.0, total = 0.0;
+
+    for (std::size_t k = 0; k < players_; k++) {
+        row += covariance_[i * players_ + k];
+        for (std::size_t l = 0; l < players_; l++) total += covariance_[k * players_ + l];
+    }
+
+    const auto n        = static_cast<double>(players_);
+    const auto variance = covariance_[i * players_ + i] - 2.0 * row / n + total / (n * n);
+
+    return CI95_ZSCORE * std::sqrt(std::max(0.0, variance)) * ELO_SCALE;
+}
+
+double Ratings::error(std::size_t i, std::size_t j) const noexcept {
+    return CI95_ZSCORE * std::sqrt(std::max(0.0, covariance(i, j, i, j))) * ELO_SCALE;
+}
+
+double Ratings::reduction(std::size_t a, std::size_t b, std::size_t i, std::size_t j, double games) const noexcept {
+    const auto weight = games * information(i, j);
+    const auto shared = covariance(a, b, i, j);
+
+    return weight * shared * shared / (1.0 + weight * covariance(i, j, i, j));
+}
+
+std::vector<std::size_t> Ratings::ranking() const {
+    std::vector<std::size_t> order(players_);
+    std::iota(order.begin(), order.end(), 0);
+
+    std::stable_sort(order.begin(), order.end(),
+                     [this](std::size_t a, std::size_t b) { return ratings_[a] > ratings_[b]; });
+
+    return order;
+}
+
+double Ratings::covariance(std::size_t i, std::size_t j, std::size_t k, std::size_t l) const noexcept {
+    const auto at = [this](std::size_t row, std::size_t col) { return covariance_[row * players_ + col]; };
+    return at(i, k) - at(i, l) - at(j, k) + at(j, l);
+}
+
+double Ratings::probability(std::size_t i, std::size_t j) const noexcept {
+    return 1.0 / (1.0 + std::exp(ratings_[j] - ratings_[i]));
+}
+
+double Ratings::information(std::size_t i, std::size_t j) const noexcept {
+    const auto p = probability(i, j);
+    return p * (1.0 - p) / dispersion_[i * players_ + j];
+}
+
+}  // namespace fastchess::elo
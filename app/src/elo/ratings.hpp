@@ -0,0 +1,93 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include <matchmaking/stats.hpp>
+
+namespace fastchess::elo {
+
+// Joint ratings of all engines of a tournament, the maximum likelihood solution of the
+// Bradley-Terry model over the results of every pair. Draws count as half a win. The
+// covariance of the ratings gives the error bar of the difference between any two engines.
+// The error bars use the spread of the results, with pentanomial results the correlation
+// of the two games of a pair is included.
+// solve() starts from the previous solution, after a few new games it converges in one or
+// two Newton steps.
+class Ratings {
+   public:
+    explicit Ratings(std::size_t players);
+
+    // Results of player i against player j, the score from the view of i.
+    void setResult(std::size_t i, std::size_t j, double score, double games);
+
+    // Results of player i against player j from the view of i, penta uses the game pairs.
+    void setResult(std::size_t i, std::size_t j, const Stats &stats, bool penta);
+
+    // Computes the ratings and their covariance from the results.
+    void solve();
+
+    // Updates the covariance as if i and j played the games with the expected result, the
+    // ratings stay the same.
+    void addGames(std::size_t i, std::size_t j, double games);
+
+    [[nodiscard]] std::size_t size() const noexcept { return players_; }
+
+    // Rating in Elo relative to the average of all players.
+    [[nodiscard]] double elo(std::size_t i) const noexcept;
+
+    // 95% error bar of elo(i).
+    [[nodiscard]] double error(std::size_t i) const noexcept;
+
+    // 95% error bar of elo(i) - elo(j).
+    [[nodiscard]] double error(std::size_t i, std::size_t j) const noexcept;
+
+    // By how much the variance of rating(a) - rating(b) shrinks if i and j play the games.
+    [[nodiscard]] double reduction(std::size_t a, std::size_t b, std::size_t i, std::size_t j,
+                                   double games) const noexcept;
+
+    // Players from the highest to the lowest rating.
+    [[nodiscard]] std::vector<std::size_t> ranking() const;
+
+   private:
+    // Results of one player against another from the view of the first one. A sample is a
+    // game or a game pair.
+    struct Result {
+        double score   = 0.0;
+        double games   = 0.0;
+        double samples = 0.0;
+        double squares = 0.0;
+        double width   = 1.0;
+    };
+
+    void setResult(std::size_t i, std::size_t j, const Result &result);
+
+    // Newton steps on the log likelihood until the ratings don't change anymore.
+    void maximize();
+
+    // Covariance of rating(i) - rating(j) and rating(k) - rating(l), in natural units.
+    [[nodiscard]] double covariance(std::size_t i, std::size_t j, std::size_t k, std::size_t l) const noexcept;
+
+    // Expected score of i against j.
+    [[nodiscard]] double probability(std::size_t i, std::size_t j) const noexcept;
+
+    // Fisher information of one game between i and j, smaller if the results spread more
+    // than the model expects.
+    [[nodiscard]] double information(std::size_t i, std::size_t j) const noexcept;
+
+    std::size_t players_;
+
+    // players x players
+    std::vector<Result> results_;
+
+    // ratio of the observed to the expected variance of the results of each pair
+    std::vector<double> dispersion_;
+
+    // natural ratings, the average is 0
+    std::vector<double> ratings_;
+
+    // covariance of the ratings with the rating of player 0 held fixed
+    std::vector<double> covariance_;
+};
+
+}  // namespace fastchess::elo
@@ -0,0 +1,257 @@
+#include <engine/process/cgroup.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <fstream>
+#include <mutex>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+#ifdef __linux__
+#    include <dirent.h>
+#    include <linux/magic.h>
+#    include <sys/stat.h>
+#    include <sys/vfs.h>
+#    include <unistd.h>
+#endif
+
+#include <util/logger/logger.hpp>
+
+namespace fastchess::engine::process {
+
+#ifdef __linux__
+
+namespace {
+
+constexpr auto ROOT = "/sys/fs/cgroup";
+
+// period of cpu.max in microseconds, the kernel's default
+constexpr long long CPU_PERIOD = 100000;
+
+// leaf of the delegated cgroup fastchess moves itself into, shared by all fastchess processes
+constexpr auto LEAF = "/fastchess";
+
+bool write(const std::string &file, const std::string &value) {
+    std::ofstream out(file);
+    out << value;
+    out.flush();
+
+    return static_cast<bool>(out);
+}
+
+// Value of a "key value" line of a flat keyed file like cpu.stat.
+std::uint64_t keyed(const std::string &file, const std::string &key) {
+    std::ifstream in(file);
+
+    std::string name;
+    std::uint64_t value = 0;
+
+    while (in >> name >> value) {
+        if (name == key) return value;
+    }
+
+    return 0;
+}
+
+std::string read(const std::string &file) {
+    std::ifstream in(file);
+
+    std::stringstream content;
+    content << in.rdbuf();
+
+    return content.str();
+}
+
+// The cgroup the engines are created in. At exit fastchess leaves its leaf again and restores
+// the cgroup, unless another fastchess process still uses it.
+struct Delegation {
+    std::optional<std::string> dir;
+
+    // disables the controllers fastchess enabled for the children
+    std::string restore;
+
+    Delegation() = default;
+
+    Delegation(const Delegation &)            = delete;
+    Delegation &operator=(const Delegation &) = delete;
+
+    ~Delegation() {
+        if (!dir) return;
+
+        std::istringstream procs(read(*dir + LEAF + "/cgroup.procs"));
+        std::string pid;
+        while (procs >> pid) {
+            if (pid != std::to_string(getpid())) return;
+        }
+
+        // engine cgroups of other processes need the controllers
+        if (auto *handle = opendir(dir->c_str())) {
+            bool children = false;
+
+            while (const auto *entry = readdir(handle)) {
+                const std::string name = entry->d_name;
+                if (entry->d_type == DT_DIR && name != "." && name != ".." && "/" + name != LEAF) children = true;
+            }
+
+            closedir(handle);
+
+            if (children) return;
+        }
+
+        // a cgroup with controllers enabled for its children can't hold processes
+        if (!restore.empty() && !write(*dir + "/cgroup.subtree_control", restore)) return;
+
+        if (write(*dir + "/cgroup.procs", std::to_string(getpid()))) rmdir((*dir + LEAF).c_str());
+    }
+};
+
+// Sets up the cgroup fastchess was started in, dir stays empty if it isn't delegated.
+// Fastchess moves itself into a leaf first, cgroups with processes can't enable controllers
+// for children.
+void delegate(Delegation &delegation) {
+    // hybrid hierarchies mount a tmpfs at the root and cgroup v1 below it
+    struct statfs fs;
+    if (statfs(ROOT, &fs) != 0 || fs.f_type != CGROUP2_SUPER_MAGIC) return;
+
+    std::ifstream file("/proc/self/cgroup");
+
+    std::string line, own;
+    while (std::getline(file, line)) {
+        if (line.rfind("0::", 0) == 0) own = line.substr(3);
+    }
+
+    if (own.empty()) return;
+
+    auto dir = ROOT + own;
+    while (dir.size() > 1 && dir.back() == '/') dir.pop_back();
+
+    if (mkdir((dir + LEAF).c_str(), 0755) != 0 && errno != EEXIST) return;
+
+    if (!write(dir + LEAF + "/cgroup.procs", std::to_string(getpid()))) return;
+
+    // the controllers which were already enabled stay so at exit
+    std::istringstream enabled(read(dir + "/cgroup.subtree_control"));
+    std::vector<std::string> before;
+    for (std::string controller; enabled >> controller;) before.push_back(controller);
+
+    for (const std::string controller : {"cpu", "memory", "pids"}) {
+        if (std::find(before.begin(), before.end(), controller) != before.end()) continue;
+        delegation.restore += (delegation.restore.empty() ? "-" : " -") + controller;
+    }
+
+    if (!write(dir + "/cgroup.subtree_control", "+cpu +memory +pids")) {
+        write(dir + "/cgroup.procs", std::to_string(getpid()));
+        rmdir((dir + LEAF).c_str());
+        return;
+    }
+
+    delegation.dir = dir;
+}
+
+}  // namespace
+
+std::unique_ptr<Cgroup> Cgroup::create(const Limits &limits) {
+    static std::mutex mutex;
+    static std::optional<Delegation> root;
+    static std::atomic<int> count = 0;
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+
+        if (!root) {
+            delegate(root.emplace());
+
+            if (!root->dir) {
+                Logger::warn(
+                    "Warning; cgroup v2 is not mounted or not delegated to fastchess, the engines run without a "
+                    "sandbox. Start fastchess with systemd-run --user --scope -p Delegate=yes.");
+            }
+        }
+    }
+
+    if (!root->dir) return nullptr;
+
+    const auto path = *root->dir + "/engine-" + std::to_string(getpid()) + "-" + std::to_string(count++);
+    if (mkdir(path.c_str(), 0755) != 0) {
+        Logger::warn<true>("Warning; Cannot create the cgroup {}", path);
+        return nullptr;
+    }
+
+    auto cgroup = std::unique_ptr<Cgroup>(new Cgroup(path));
+
+    bool ok = true;
+
+    if (limits.cpus > 0) {
+        const auto quota = static_cast<long long>(limits.cpus * CPU_PERIOD);
+        ok &= write(path + "/cpu.max", std::to_string(quota) + " " + std::to_string(CPU_PERIOD));
+    }
+
+    if (limits.memory > 0) {
+        ok &= write(path + "/memory.max", std::to_string(limits.memory));
+
+        // a leak ends with the oom killer instead of swapping, not every kernel has swap accounting
+        write(path + "/memory.swap.max", "0");
+    }
+
+    if (limits.pids > 0) ok &= write(path + "/pids.max", std::to_string(limits.pids));
+
+    if (!ok) {
+        Logger::warn<true>("Warning; Cannot set the limits of the cgroup {}", path);
+        return nullptr;
+    }
+
+    return cgroup;
+}
+
+Cgroup::~Cgroup() {
+    // engines may have started processes of their own
+    write(path_ + "/cgroup.kill", "1");
+
+    // the killed processes leave the cgroup asynchronously
+    for (int i = 0; i < 100; i++) {
+        if (rmdir(path_.c_str()) == 0 || errno == ENOENT) return;
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+
+    Logger::trace("Cannot remove the cgroup {}", path_);
+}
+
+bool Cgroup::add(int pid) const { return write(path_ + "/cgroup.procs", std::to_string(pid)); }
+
+std::optional<CgroupUsage> Cgroup::usage() const {
+    CgroupUsage usage;
+
+    std::ifstream stat(path_ + "/cpu.stat");
+    if (!stat) return std::nullopt;
+
+    usage.cpu       = std::chrono::microseconds(keyed(path_ + "/cpu.stat", "usage_usec"));
+    usage.throttled = std::chrono::microseconds(keyed(path_ + "/cpu.stat", "throttled_usec"));
+
+    // memory.peak is only known since Linux 5.19
+    std::ifstream peak(path_ + "/memory.peak");
+    std::ifstream current(path_ + "/memory.current");
+    if (!(peak >> usage.memory_peak)) current >> usage.memory_peak;
+
+    usage.oom_kills   = keyed(path_ + "/memory.events", "oom_kill");
+    usage.pids_denied = keyed(path_ + "/pids.events", "max");
+
+    return usage;
+}
+
+#else
+
+std::unique_ptr<Cgroup> Cgroup::create(const Limits &) { return nullptr; }
+
+Cgroup::~Cgroup() = default;
+
+bool Cgroup::add(int) const { return false; }
+
+std::optional<CgroupUsage> Cgroup::usage() const { return std::nullopt; }
+
+#endif
+
+}  // namespace fastchess::engine::process
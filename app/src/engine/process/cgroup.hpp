@@ -0,0 +1,37 @@
+#pragma once
+
+#include <memory>
+#include <optional>
+#include <string>
+
+#include <engine/process/iprocess.hpp>
+
+namespace fastchess::engine::process {
+
+// A cgroup v2 of one engine process with its limits. The cgroups are children of the cgroup
+// fastchess was started in, which has to be delegated to the user, e.g. by
+// systemd-run --user --scope -p Delegate=yes. Fastchess moves itself into a leaf of it to
+// enable the cpu, memory and pids controllers for its children, and back at exit.
+class Cgroup {
+   public:
+    // Creates a cgroup with the limits, nullptr if cgroups can't be used.
+    [[nodiscard]] static std::unique_ptr<Cgroup> create(const Limits &limits);
+
+    // Kills whatever still runs in the cgroup and removes it.
+    ~Cgroup();
+
+    Cgroup(const Cgroup &)            = delete;
+    Cgroup &operator=(const Cgroup &) = delete;
+
+    // Moves the process into the cgroup.
+    [[nodiscard]] bool add(int pid) const;
+
+    [[nodiscard]] std::optional<CgroupUsage> usage() const;
+
+   private:
+    explicit Cgroup(std::string path) : path_(std::move(path)) {}
+
+    std::string path_;
+};
+
+}  // namespace fastchess::engine::process
@@ -2,10 +2,13 @@
 
 #include <chrono>
 #include <cstdint>
+#include <optional>
 #include <string>
 #include <string_view>
 #include <vector>
 
+#include <types/engine_config.hpp>
+
 namespace fastchess::engine::process {
 
 enum class Standard { INPUT, OUTPUT, ERR };
@@ -17,6 +20,39 @@ struct Line {
     Standard std = Standard::OUTPUT;
 };
 
+// Limits of the cgroup of a sandboxed process, 0 for no limit.
+struct Limits {
+    double cpus          = 0.0;
+    std::uint64_t memory = 0;  // bytes
+    int pids             = 0;
+};
+
+// Accounting of the cgroup of a sandboxed process since it was started.
+struct CgroupUsage {
+    std::chrono::microseconds cpu       = {};
+    std::chrono::microseconds throttled = {};
+
+    // largest memory use in bytes
+    std::uint64_t memory_peak = 0;
+
+    // processes killed for exceeding memory.max and forks refused by pids.max
+    std::uint64_t oom_kills   = 0;
+    std::uint64_t pids_denied = 0;
+};
+
+// Accounting of a process and all of its threads, like the rusage of wait4.
+struct Rusage {
+    std::chrono::microseconds user   = {};
+    std::chrono::microseconds system = {};
+
+    // the threads waited for something, or were preempted by the scheduler
+    std::uint64_t voluntary_switches   = 0;
+    std::uint64_t involuntary_switches = 0;
+
+    // largest resident set in bytes
+    std::uint64_t max_rss = 0;
+};
+
 class IProcess {
    public:
     virtual ~IProcess() = default;
@@ -29,6 +65,12 @@ class IProcess {
 
     void setRealtimeLogging(bool realtime_logging) noexcept { realtime_logging_ = realtime_logging; }
 
+    // Puts the process into its own cgroup with these limits when it is started next.
+    void setLimits(const std::optional<Limits> &limits) noexcept { limits_ = limits; }
+
+    // Niceness and policy of the process when it is started next.
+    void setScheduling(const Scheduling &scheduling) noexcept { scheduling_ = scheduling; }
+
     // Initialize the process
     virtual Status init(const std::string &command, const std::string &args, const std::string &log_name) = 0;
 
@@ -37,6 +79,16 @@ class IProcess {
 
     virtual void setAffinity(const std::vector<int> &cpus) noexcept = 0;
 
+    // CPU time the process used so far, nullopt if it can't be measured
+    [[nodiscard]] virtual std::optional<std::chrono::milliseconds> cpuTime() const = 0;
+
+    // Accounting of the process so far, or of its whole life once it exited, nullopt if it
+    // can't be measured
+    [[nodiscard]] virtual std::optional<Rusage> rusage() const = 0;
+
+    // Accounting of the cgroup of the process, nullopt without a sandbox
+    [[nodiscard]] virtual std::optional<CgroupUsage> cgroupUsage() const = 0;
+
     virtual void restart() = 0;
 
    protected:
@@ -49,6 +101,10 @@ class IProcess {
     virtual Status writeProcess(const std::string &input) noexcept = 0;
 
     bool realtime_logging_ = true;
+
+    std::optional<Limits> limits_;
+
+    Scheduling scheduling_;
 };
 
 }  // namespace fastchess::engine::process
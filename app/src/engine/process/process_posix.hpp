@@ -2,25 +2,30 @@
 
 #ifndef _WIN64
 
+#    include <engine/process/cgroup.hpp>
 #    include <engine/process/iprocess.hpp>
 
 #    include <array>
 #    include <cassert>
 #    include <chrono>
 #    include <cstdint>
+#    include <fstream>
 #    include <iostream>
 #    include <memory>
+#    include <sstream>
 #    include <stdexcept>
 #    include <string>
 #    include <thread>
 #    include <vector>
 
+#    include <dirent.h>
 #    include <errno.h>
 #    include <fcntl.h>  // fcntl
 #    include <poll.h>   // poll
 #    include <signal.h>
 #    include <spawn.h>
 #    include <string.h>
+#    include <sys/resource.h>
 #    include <sys/types.h>  // pid_t
 #    include <sys/wait.h>
 #    include <unistd.h>  // _exit, fork
@@ -34,6 +39,7 @@
 #    include <affinity/affinity.hpp>
 #    include <globals/globals.hpp>
 #    include <util/logger/logger.hpp>
+#    include <util/scheduling.hpp>
 #    include <util/thread_vector.hpp>
 
 #    include <argv_split.hpp>
@@ -62,6 +68,8 @@ class Process : public IProcess {
         is_initalized_ = true;
         startup_error_ = false;
 
+        exit_rusage_.reset();
+
         current_line_.reserve(300);
 
         argv_split parser(command);
@@ -98,6 +106,24 @@ class Process : public IProcess {
         // which are killed when the program exits, as a last resort
         process_list.push(ProcessInformation{process_pid_, in_pipe_.write_end()});
 
+        // the engine runs for a moment outside of its cgroup, before it allocates its hash
+        if (limits_) {
+            cgroup_ = Cgroup::create(*limits_);
+
+            if (cgroup_ && !cgroup_->add(process_pid_)) {
+                Logger::warn<true>("Warning; Cannot move engine {} into its cgroup", log_name_);
+                cgroup_.reset();
+            }
+        }
+
+        // the threads the engine starts for its search inherit the scheduling of its main thread
+        if (!scheduling::setProcess(process_pid_, scheduling_)) {
+            Logger::warn<true>(
+                "Warning; Cannot change the scheduling of engine {}, real time policies and negative nice values "
+                "need CAP_SYS_NICE or a raised RLIMIT_RTPRIO / RLIMIT_NICE.",
+                log_name_);
+        }
+
         return Status::OK;
     }
 
@@ -105,7 +131,7 @@ class Process : public IProcess {
         assert(is_initalized_);
 
         int status;
-        const pid_t r = waitpid(process_pid_, &status, WNOHANG);
+        const pid_t r = reap(&status, WNOHANG);
 
         return r == 0 ? Status::OK : Status::ERR;
     }
@@ -142,6 +168,32 @@ class Process : public IProcess {
         }
     }
 
+    [[nodiscard]] std::optional<std::chrono::milliseconds> cpuTime() const override {
+        const auto usage = rusage();
+        if (!usage) return std::nullopt;
+
+        return std::chrono::duration_cast<std::chrono::milliseconds>(usage->user + usage->system);
+    }
+
+    [[nodiscard]] std::optional<Rusage> rusage() const override {
+        if (!is_initalized_ || startup_error_) return std::nullopt;
+
+        // wait4 accounted for the whole life of the process when it was reaped
+        if (exit_rusage_) return exit_rusage_;
+
+#    ifdef __linux__
+        return sample(process_pid_);
+#    else
+        return std::nullopt;
+#    endif
+    }
+
+    [[nodiscard]] std::optional<CgroupUsage> cgroupUsage() const override {
+        if (!cgroup_) return std::nullopt;
+
+        return cgroup_->usage();
+    }
+
     void killProcess() {
         if (startup_error_) {
             is_initalized_ = false;
@@ -153,7 +205,7 @@ class Process : public IProcess {
         process_list.remove_if([this](const ProcessInformation &pi) { return pi.identifier == process_pid_; });
 
         int status;
-        const pid_t pid = waitpid(process_pid_, &status, WNOHANG);
+        const pid_t pid = reap(&status, WNOHANG);
 
         // log the status of the process
         Logger::readFromEngine(signalToString(status), util::time::datetime_precise(), log_name_, true);
@@ -161,9 +213,11 @@ class Process : public IProcess {
         // If the process is still running, kill it
         if (pid == 0) {
             kill(process_pid_, SIGKILL);
-            wait(nullptr);
+            reap(nullptr, 0);
         }
 
+        cgroup_.reset();
+
         is_initalized_ = false;
     }
 
@@ -254,6 +308,103 @@ class Process : public IProcess {
     }
 
    private:
+    // waitpid which keeps the accounting of the reaped process
+    pid_t reap(int *status, int options) const noexcept {
+        struct rusage usage;
+
+        const pid_t pid = wait4(process_pid_, status, options, &usage);
+        if (pid != process_pid_) return pid;
+
+        const auto micros = [](const timeval &time) {
+            return std::chrono::seconds(time.tv_sec) + std::chrono::microseconds(time.tv_usec);
+        };
+
+        exit_rusage_                       = Rusage{};
+        exit_rusage_->user                 = micros(usage.ru_utime);
+        exit_rusage_->system               = micros(usage.ru_stime);
+        exit_rusage_->voluntary_switches   = usage.ru_nvcsw;
+        exit_rusage_->involuntary_switches = usage.ru_nivcsw;
+
+        // bytes on macOS, KiB everywhere else
+#    ifdef __APPLE__
+        exit_rusage_->max_rss = usage.ru_maxrss;
+#    else
+        exit_rusage_->max_rss = static_cast<std::uint64_t>(usage.ru_maxrss) * 1024;
+#    endif
+
+        return pid;
+    }
+
+#    ifdef __linux__
+    // Accounting of a running process. The cpu time and the peak of the resident set are kept
+    // for the whole process, the context switches only per thread.
+    static std::optional<Rusage> sample(pid_t pid) {
+        const auto dir = "/proc/" + std::to_string(pid);
+
+        std::ifstream file(dir + "/stat");
+
+        std::string stat;
+        if (!std::getline(file, stat)) return std::nullopt;
+
+        // the command in parentheses may contain spaces, the state is the first field after it
+        const auto end = stat.rfind(')');
+        if (end == std::string::npos) return std::nullopt;
+
+        std::istringstream fields(stat.substr(end + 1));
+
+        // utime and stime are the fields 14 and 15, the state is field 3
+        std::string skip;
+        for (int field = 3; field < 14; field++) fields >> skip;
+
+        unsigned long long utime = 0, stime = 0;
+        if (!(fields >> utime >> stime)) return std::nullopt;
+
+        const auto ticks = sysconf(_SC_CLK_TCK);
+        if (ticks <= 0) return std::nullopt;
+
+        Rusage usage;
+        usage.user   = std::chrono::microseconds(utime * 1000000 / ticks);
+        usage.system = std::chrono::microseconds(stime * 1000000 / ticks);
+
+        readStatus(dir + "/status", usage, false);
+
+        // switches of threads which already exited are lost
+        if (DIR *tasks = opendir((dir + "/task").c_str())) {
+            while (const dirent *task = readdir(tasks)) {
+                if (task->d_name[0] == '.') continue;
+
+                readStatus(dir + "/task/" + task->d_name + "/status", usage, true);
+            }
+
+            closedir(tasks);
+        }
+
+        return usage;
+    }
+
+    // Adds the "key: value" lines of a /proc status file to the usage.
+    static void readStatus(const std::string &path, Rusage &usage, bool switches) {
+        std::ifstream file(path);
+
+        std::string line;
+        while (std::getline(file, line)) {
+            std::istringstream fields(line);
+
+            std::string key;
+            std::uint64_t value = 0;
+            if (!(fields >> key >> value)) continue;
+
+            if (switches && key == "voluntary_ctxt_switches:") {
+                usage.voluntary_switches += value;
+            } else if (switches && key == "nonvoluntary_ctxt_switches:") {
+                usage.involuntary_switches += value;
+            } else if (!switches && key == "VmHWM:") {
+                usage.max_rss = value * 1024;
+            }
+        }
+    }
+#    endif
+
     void setup_spawn_file_actions(posix_spawn_file_actions_t &file_actions, int fd, int target_fd) {
         if (posix_spawn_file_actions_adddup2(&file_actions, fd, target_fd) != 0) {
             throw std::runtime_error("posix_spawn_file_actions_add* failed");
@@ -328,6 +479,12 @@ class Process : public IProcess {
     // The process id of the engine
     pid_t process_pid_;
 
+    // only with a sandbox
+    std::unique_ptr<Cgroup> cgroup_;
+
+    // accounting of the process once it was reaped
+    mutable std::optional<Rusage> exit_rusage_;
+
     Pipe in_pipe_ = {}, out_pipe_ = {}, err_pipe_ = {};
 };
 }  // namespace engine::process
@@ -88,6 +88,26 @@ class Process : public IProcess {
         if (!cpus.empty()) affinity::setAffinity(cpus, pi_.hProcess);
     }
 
+    [[nodiscard]] std::optional<std::chrono::milliseconds> cpuTime() const override {
+        if (!is_initalized_ || startup_error_) return std::nullopt;
+
+        FILETIME creation, exit, kernel, user;
+        if (!GetProcessTimes(pi_.hProcess, &creation, &exit, &kernel, &user)) return std::nullopt;
+
+        // in units of 100 ns
+        const auto ticks = [](const FILETIME &time) {
+            return (static_cast<std::uint64_t>(time.dwHighDateTime) << 32) | time.dwLowDateTime;
+        };
+
+        return std::chrono::milliseconds((ticks(kernel) + ticks(user)) / 10000);
+    }
+
+    // Windows doesn't count the context switches of a process
+    [[nodiscard]] std::optional<Rusage> rusage() const override { return std::nullopt; }
+
+    // sandboxes need cgroups
+    [[nodiscard]] std::optional<CgroupUsage> cgroupUsage() const override { return std::nullopt; }
+
     void killProcess() {
         if (!is_initalized_) return;
 
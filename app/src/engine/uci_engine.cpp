@@ -10,6 +10,7 @@
 #include <util/file_system.hpp>
 #include <util/helper.hpp>
 #include <util/logger/logger.hpp>
+#include <util/tracer/tracer.hpp>
 
 namespace fastchess::engine {
 
@@ -143,6 +144,9 @@ bool UciEngine::go(const TimeControl &our_tc, const TimeControl &enemy_tc, chess
 }
 
 bool UciEngine::ucinewgame() {
+    Tracer::Span span("ucinewgame", "engine");
+    span.arg("engine", config_.name);
+
     Logger::trace<true>("Sending ucinewgame to engine {}", config_.name);
     auto res = writeEngine("ucinewgame");
 
@@ -167,6 +171,9 @@ bool UciEngine::uci() {
 }
 
 bool UciEngine::uciok(std::chrono::milliseconds threshold) {
+    Tracer::Span span("uciok", "engine");
+    span.arg("engine", config_.name);
+
     Logger::trace<true>("Waiting for uciok from engine {}", config_.name);
 
     const auto res = readEngine("uciok", threshold) == process::Status::OK;
@@ -188,7 +195,33 @@ bool UciEngine::uciok(std::chrono::milliseconds threshold) {
     return res;
 }
 
-void UciEngine::loadConfig(const EngineConfiguration &config) { config_ = config; }
+void UciEngine::loadConfig(const EngineConfiguration &config) {
+    config_ = config;
+
+    setScheduling(config.scheduling);
+
+    if (!config.sandbox.enabled) return;
+
+    // memory of an engine besides its hash, in MiB
+    constexpr std::uint64_t MEMORY_HEADROOM = 512;
+
+    const auto option = [&config](std::string_view name, int fallback) {
+        try {
+            return config.getOption<int>(name, [](const std::string &value) { return std::stoi(value); })
+                .value_or(fallback);
+        } catch (const std::exception &) {
+            return fallback;
+        }
+    };
+
+    process::Limits limits;
+    limits.cpus   = config.sandbox.cpus > 0 ? config.sandbox.cpus : option("Threads", 1);
+    limits.memory = (config.sandbox.memory > 0 ? config.sandbox.memory : option("Hash", 16) + MEMORY_HEADROOM) *
+                    1024 * 1024;
+    limits.pids   = config.sandbox.pids;
+
+    setLimits(limits);
+}
 
 void UciEngine::quit() {
     if (!initialized_) return;
@@ -228,11 +261,16 @@ bool UciEngine::start() {
     Logger::trace<true>("Starting engine {} at {}", config_.name, path);
 
     // Creates the engine process and sets the pipes
-    if (init(path, config_.args, config_.name) != process::Status::OK) {
-        Logger::warn<true>("Warning: Cannot start engine {}:", config_.name);
-        Logger::warn<true>("Cannot execute command: {}", path);
+    {
+        Tracer::Span span("spawn", "engine");
+        span.arg("engine", config_.name);
 
-        return false;
+        if (init(path, config_.args, config_.name) != process::Status::OK) {
+            Logger::warn<true>("Warning: Cannot start engine {}:", config_.name);
+            Logger::warn<true>("Cannot execute command: {}", path);
+
+            return false;
+        }
     }
 
     // Wait for the engine to start
@@ -70,6 +70,15 @@ class UciEngine : protected process::Process {
 
     void setCpus(const std::vector<int> &cpus) { setAffinity(cpus); }
 
+    // CPU time the engine used since it was started, nullopt if unknown.
+    [[nodiscard]] std::optional<std::chrono::milliseconds> cpuTime() const { return Process::cpuTime(); }
+
+    // Accounting of the engine process since it was started, nullopt if unknown.
+    [[nodiscard]] std::optional<process::Rusage> rusage() const { return Process::rusage(); }
+
+    // Accounting of the engine's sandbox since it was started, nullopt without one.
+    [[nodiscard]] std::optional<process::CgroupUsage> cgroupUsage() const { return Process::cgroupUsage(); }
+
     // Get the bestmove from the last output.
     [[nodiscard]] std::optional<std::string> bestmove() const;
 
@@ -1,50 +1,154 @@
+#include <algorithm>
 #include <cstdlib>
-#include <thread>
 
 #include <cli/cli.hpp>
 #include <config/config.hpp>
+#include <config/planner.hpp>
 #include <config/sanitize.hpp>
 #include <globals/globals.hpp>
+#include <matchmaking/daemon/daemon.hpp>
+#include <matchmaking/distributed/worker.hpp>
+#include <matchmaking/merge/merge.hpp>
+#include <matchmaking/output/output_json.hpp>
 #include <matchmaking/tournament/tournament_manager.hpp>
 #include <util/rand.hpp>
+#include <util/tracer/tracer.hpp>
 
 using namespace fastchess;
 
+namespace {
+
+// Opens the log and trace files of a run. Once the run is over, the engines which are still
+// alive are killed and the trace is completed.
+class Session {
+   public:
+    explicit Session(const config::Tournament& config) {
+        Logger::setLevel(config.log.level);
+        Logger::setCompress(config.log.compress);
+        Logger::openFile(config.log.file);
+        Tracer::openFile(config.trace.file);
+    }
+
+    ~Session() {
+        stopProcesses();
+        Tracer::closeFile();
+    }
+
+    Session(const Session&)            = delete;
+    Session& operator=(const Session&) = delete;
+};
+
+}  // namespace
+
 int main(int argc, char const* argv[]) {
     setCtrlCHandler();
 
     try {
         auto options = cli::OptionsParser(argc, argv);
 
+        // the warnings about the config come before the output exists
+        if (const auto config = options.getTournamentConfig();
+            config.output == OutputType::JSON && config.output_file.empty()) {
+            JsonLines::redirectLog();
+        }
+
+        // merging the results of shards doesn't play any games
+        if (!options.getMergeFiles().empty()) {
+            auto merger = Merger(options.getTournamentConfig(), options.getMergeFiles());
+            merger.print();
+
+            return 0;
+        }
+
+        // a worker plays the games of a coordinator, the tournament settings are sent by it
+        if (options.getWorker().port > 0) {
+            const auto local = options.getTournamentConfig();
+            const Session session(local);
+
+            auto worker = distributed::Worker(options.getWorker(), local);
+            worker.run();
+
+            return 0;
+        }
+
+        // the daemon plays the submitted tournaments, the other commands talk to it
+        const auto command = options.getDaemon();
+
+        if (command.command == config::Daemon::Command::SERVE) {
+            auto local        = options.getTournamentConfig();
+            local.concurrency = std::min(local.concurrency, config::Machine::detect().processors);
+
+            const Session session(local);
+
+            auto server = daemon::Daemon(command.socket, local.concurrency, local.affinity);
+            server.run();
+
+            return 0;
+        }
+
+        if (command.command != config::Daemon::Command::NONE) {
+            nlohmann::ordered_json request;
+
+            if (command.command == config::Daemon::Command::SUBMIT) {
+                request = daemon::submitRequest(options.getTournamentConfig(), options.getEngineConfigs(),
+                                                options.getResults());
+            } else if (command.command == config::Daemon::Command::STATUS) {
+                request = {{"type", daemon::message::STATUS}};
+            } else {
+                request = {{"type", daemon::message::CANCEL}, {"id", command.id}};
+            }
+
+            return daemon::printResponse(daemon::request(command.socket, request)) ? 0 : EXIT_FAILURE;
+        }
+
+        // several tests share the slots of -concurrency and the cores of -use-affinity
+        if (!options.getTests().empty()) {
+            if (!options.getEngineConfigs().empty()) {
+                throw std::runtime_error("Error; The engines of a -test are read from its config file.");
+            }
+
+            auto local        = options.getTournamentConfig();
+            local.concurrency = std::min(local.concurrency, config::Machine::detect().processors);
+
+            {
+                const Session session(local);
+
+                auto tour = TournamentManager(local, options.getTests());
+
+                tour.start();
+            }
+
+            Logger::info("Finished match");
+
+            return 0;
+        }
+
         config::TournamentConfig.setup([&options]() -> std::unique_ptr<config::Tournament> {
             auto cnf = options.getTournamentConfig();
 
             config::sanitize(cnf);
 
+            // the games of a coordinator are played by the workers
+            if (cnf.coordinator.port == 0) config::applyPlan(cnf, options.getEngineConfigs());
+
             return std::make_unique<config::Tournament>(cnf);
         });
 
         config::EngineConfigs.setup([&options]() -> std::unique_ptr<std::vector<EngineConfiguration>> {
             auto cnf = options.getEngineConfigs();
 
-            config::sanitize(cnf);
+            config::sanitize(cnf, options.getTournamentConfig());
 
             return std::make_unique<std::vector<EngineConfiguration>>(cnf);
         });
 
-        Logger::setLevel(config::TournamentConfig.get().log.level);
-        Logger::setCompress(config::TournamentConfig.get().log.compress);
-        Logger::openFile(config::TournamentConfig.get().log.file);
+        const Session session(config::TournamentConfig.get());
 
         util::random::seed(config::TournamentConfig.get().seed);
 
-        {
-            auto tour = TournamentManager(options.getResults());
-
-            tour.start();
-        }
+        auto tour = TournamentManager(options.getResults());
 
-        stopProcesses();
+        tour.start();
     } catch (const std::exception& e) {
         std::cerr << e.what() << std::endl;
         return EXIT_FAILURE;
@@ -0,0 +1,148 @@
+#include <matchmaking/concurrency/controller.hpp>
+
+#include <algorithm>
+#include <fstream>
+
+#include <config/planner.hpp>
+#include <util/logger/logger.hpp>
+
+namespace fastchess {
+
+namespace {
+
+// games of a window, at least two per slot
+constexpr int MIN_WINDOW = 8;
+
+// share of the games lost on time above which the machine counts as overloaded
+constexpr double TIMEOUT_RATE = 0.02;
+
+// the engines got less than this share of the best cpu time per thinking time
+constexpr double CPU_RATIO = 0.9;
+
+// the time between the moves grew by this factor, and by at least MIN_OVERHEAD ms
+constexpr double OVERHEAD_FACTOR = 2.0;
+constexpr double MIN_OVERHEAD    = 5.0;
+
+// system load per core above which the limit is lowered, and below which it may be raised
+constexpr double MAX_LOAD  = 1.0;
+constexpr double HIGH_LOAD = 0.9;
+
+}  // namespace
+
+ConcurrencyController::ConcurrencyController(int maximum, std::function<std::optional<double>()> load)
+    : load_(std::move(load)), maximum_(std::max(1, maximum)), limit_(std::max(1, (maximum + 1) / 2)) {
+    Logger::info("Starting with a concurrency of {}, at most {}", limit_, maximum_);
+}
+
+std::optional<ConcurrencyController::Slot> ConcurrencyController::acquire(const std::function<bool()> &stopped) {
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    // poll the stop flag, it is not signalled through the condition variable
+    while (running_ >= limit_) {
+        if (stopped()) return std::nullopt;
+
+        cv_.wait_for(lock, std::chrono::milliseconds(100));
+    }
+
+    running_++;
+
+    return std::optional<Slot>(std::in_place, *this);
+}
+
+void ConcurrencyController::release() {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    running_--;
+    cv_.notify_all();
+}
+
+void ConcurrencyController::report(const GameLoad &game) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    games_++;
+    timeouts_ += game.timeout;
+    overhead_ += game.overhead;
+    thinking_ += game.thinking;
+
+    if (game.cpu) {
+        cpu_ += *game.cpu;
+    } else {
+        cpu_known_ = false;
+    }
+
+    adjust();
+}
+
+void ConcurrencyController::adjust() {
+    if (games_ < std::max(MIN_WINDOW, 2 * limit_)) return;
+
+    const auto load     = load_();
+    const auto overhead = overhead_ / games_;
+
+    std::optional<double> ratio;
+    if (cpu_known_ && thinking_.count() > 0) ratio = static_cast<double>(cpu_.count()) / thinking_.count();
+
+    std::string reason;
+
+    if (timeouts_ > TIMEOUT_RATE * games_) {
+        reason = fmt::format("{} of {} games were lost on time", timeouts_, games_);
+    } else if (ratio && best_cpu_ratio_ && *ratio < CPU_RATIO * *best_cpu_ratio_) {
+        reason = fmt::format("the engines used {:.2f} cpu seconds per second of thinking, {:.2f} before", *ratio,
+                             *best_cpu_ratio_);
+    } else if (load && *load > MAX_LOAD) {
+        reason = fmt::format("the system load is {:.2f} per core", *load);
+    } else if (best_overhead_ && overhead > OVERHEAD_FACTOR * *best_overhead_ &&
+               overhead > *best_overhead_ + MIN_OVERHEAD) {
+        reason = fmt::format("{:.1f} ms passed between the moves, {:.1f} ms before", overhead, *best_overhead_);
+    }
+
+    // the best values are the baseline of an idle machine
+    if (ratio) best_cpu_ratio_ = std::max(best_cpu_ratio_.value_or(0.0), *ratio);
+    best_overhead_ = std::min(best_overhead_.value_or(overhead), overhead);
+
+    if (!reason.empty()) {
+        setLimit(std::max(1, limit_ - std::max(1, limit_ / 4)), reason);
+    } else if (limit_ < maximum_ && (!load || *load < HIGH_LOAD)) {
+        setLimit(limit_ + 1, "no sign of overload");
+    } else {
+        Logger::trace("Keeping a concurrency of {}", limit_);
+    }
+
+    games_     = 0;
+    timeouts_  = 0;
+    overhead_  = 0.0;
+    thinking_  = {};
+    cpu_       = {};
+    cpu_known_ = true;
+}
+
+void ConcurrencyController::setLimit(int limit, const std::string &reason) {
+    if (limit == limit_) {
+        Logger::trace("Keeping a concurrency of {}, {}", limit_, reason);
+        return;
+    }
+
+    Logger::info("{} the concurrency from {} to {}, {}", limit < limit_ ? "Lowering" : "Raising", limit_, limit,
+                 reason);
+
+    limit_ = limit;
+    cv_.notify_all();
+}
+
+std::optional<double> ConcurrencyController::systemLoad() {
+#ifdef __linux__
+    std::ifstream file("/proc/loadavg");
+
+    double load = 0.0;
+    if (!(file >> load)) return std::nullopt;
+
+    // measured against the processors the process may use, not all processors of the host
+    static const auto processors = config::Machine::detect().processors;
+
+    return load / processors;
+#else
+    return std::nullopt;
+#endif
+}
+
+}  // namespace fastchess
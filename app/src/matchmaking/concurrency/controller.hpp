@@ -0,0 +1,108 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <utility>
+
+namespace fastchess {
+
+// Measurements of a finished game.
+struct GameLoad {
+    bool timeout = false;
+
+    // time the engines spent thinking and the cpu time they used, unknown if the platform
+    // can't measure the cpu time of a process
+    std::chrono::milliseconds thinking = {};
+    std::optional<std::chrono::milliseconds> cpu;
+
+    // wall time of the game which no engine spent thinking, per move
+    double overhead = 0.0;
+};
+
+// Number of games played at the same time, between 1 and the configured concurrency, starting
+// in the middle. After each window of games the limit is lowered by a quarter if the machine
+// is overloaded: games were lost on time, the engines got less cpu time while thinking than
+// before, the system load is above the number of cores or the time between the moves grew.
+// Otherwise it is raised by one, unless the system load is close to the number of cores.
+class ConcurrencyController {
+   public:
+    // Gives the game slot back when it goes out of scope.
+    class Slot {
+       public:
+        explicit Slot(ConcurrencyController &controller) : controller_(&controller) {}
+
+        Slot(const Slot &)            = delete;
+        Slot &operator=(const Slot &) = delete;
+
+        Slot(Slot &&other) noexcept : controller_(std::exchange(other.controller_, nullptr)) {}
+
+        Slot &operator=(Slot &&other) noexcept {
+            if (this == &other) return *this;
+
+            if (controller_) controller_->release();
+            controller_ = std::exchange(other.controller_, nullptr);
+            return *this;
+        }
+
+        ~Slot() {
+            if (controller_) controller_->release();
+        }
+
+       private:
+        ConcurrencyController *controller_;
+    };
+
+    // load returns the system load relative to the number of cores, nullopt if unknown
+    ConcurrencyController(int maximum, std::function<std::optional<double>()> load = systemLoad);
+
+    // Blocks until fewer games than the limit are played, nullopt if stopped() returned true
+    // while waiting.
+    [[nodiscard]] std::optional<Slot> acquire(const std::function<bool()> &stopped);
+
+    // Adds the finished game to the window, adjusts the limit once the window is full.
+    void report(const GameLoad &game);
+
+    [[nodiscard]] int limit() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return limit_;
+    }
+
+    // One minute load average divided by the number of cores, Linux only.
+    [[nodiscard]] static std::optional<double> systemLoad();
+
+   private:
+    void release();
+
+    // Decides on the limit from the games of the window, with the lock held.
+    void adjust();
+
+    void setLimit(int limit, const std::string &reason);
+
+    std::mutex mutex_;
+    std::condition_variable cv_;
+
+    std::function<std::optional<double>()> load_;
+
+    const int maximum_;
+    int limit_;
+    int running_ = 0;
+
+    // games of the current window
+    int games_                          = 0;
+    int timeouts_                       = 0;
+    double overhead_                    = 0.0;
+    std::chrono::milliseconds thinking_ = {};
+    std::chrono::milliseconds cpu_      = {};
+    bool cpu_known_                     = true;
+
+    // best values of previous windows, what the engines get on an idle machine
+    std::optional<double> best_cpu_ratio_;
+    std::optional<double> best_overhead_;
+};
+
+}  // namespace fastchess
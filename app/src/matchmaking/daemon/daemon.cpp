@@ -0,0 +1,292 @@
+#include <matchmaking/daemon/daemon.hpp>
+
+#include <chrono>
+#include <iostream>
+
+#include <config/planner.hpp>
+#include <config/sanitize.hpp>
+#include <matchmaking/tournament/tournament_manager.hpp>
+#include <util/file_system.hpp>
+#include <util/logger/logger.hpp>
+#include <util/rand.hpp>
+
+namespace fastchess::daemon {
+
+namespace {
+// a client which doesn't send its request in time is dropped, it would hold up all others
+constexpr auto REQUEST_TIMEOUT = std::chrono::seconds(5);
+}  // namespace
+
+Daemon::Daemon(const std::string &socket, int slots, bool affinity)
+    : path_(socket), server_(util::net::Socket::listenUnix(socket)), resources_(slots, affinity) {
+    Logger::info("Daemon listening on {} with {} slots", path_, slots);
+}
+
+Daemon::~Daemon() {
+    Logger::trace("~Daemon()");
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (auto &[id, test] : tests_) {
+            if (test->tournament) test->tournament->stop();
+        }
+    }
+
+    for (auto &[id, test] : tests_) {
+        if (test->thread.joinable()) test->thread.join();
+    }
+
+    server_.close();
+
+#ifndef _WIN64
+    ::unlink(path_.c_str());
+#endif
+}
+
+void Daemon::run() {
+    while (!atomic::stop) {
+        auto connection = server_.accept(std::chrono::milliseconds(100));
+        if (!connection.valid()) continue;
+
+        connection.setReceiveTimeout(REQUEST_TIMEOUT);
+
+        // one request per connection, the requests are answered right away
+        std::string line;
+        if (!connection.receive(line)) continue;
+
+        const auto json = nlohmann::ordered_json::parse(line, nullptr, false);
+
+        if (json.is_discarded()) {
+            connection.send(nlohmann::ordered_json{{"type", message::FAILURE}, {"message", "Invalid request."}}.dump());
+            continue;
+        }
+
+        connection.send(handle(json).dump());
+    }
+}
+
+nlohmann::ordered_json Daemon::handle(const nlohmann::ordered_json &request) {
+    const auto type = request.value("type", "");
+
+    try {
+        if (type == message::SUBMIT) return submit(request.at("config"));
+        if (type == message::STATUS) return status();
+        if (type == message::CANCEL) return cancel(request.at("id").get<std::uint64_t>());
+    } catch (const std::exception &e) {
+        return {{"type", message::FAILURE}, {"message", e.what()}};
+    }
+
+    return {{"type", message::FAILURE}, {"message", "Unknown request type \"" + type + "\"."}};
+}
+
+TestConfig parseTest(const nlohmann::ordered_json &json) {
+    TestConfig test;
+    test.tournament = json.get<config::Tournament>();
+    test.engines    = json.at("engines").get<std::vector<EngineConfiguration>>();
+
+    // the stats of a saved config file resume the tournament
+    if (json.contains("stats")) test.stats = nlohmann::json::parse(json["stats"].dump()).get<stats_map>();
+
+    config::sanitize(test.tournament);
+    config::sanitize(test.engines, test.tournament);
+
+    if (test.tournament.coordinator.port > 0) {
+        throw std::runtime_error("Error; A coordinator can't share the process with other tournaments.");
+    }
+
+    // the slots of the daemon are fixed and shared by all tests
+    if (test.tournament.autoconcurrency) {
+        throw std::runtime_error("Error; The tests of a daemon can't use -autoconcurrency.");
+    }
+
+    // the slots are shared, but the hash of a test's games must still fit into the memory
+    config::applyPlan(test.tournament, test.engines);
+
+    return test;
+}
+
+nlohmann::ordered_json Daemon::submit(const nlohmann::ordered_json &json) {
+    auto [config, engines, stats] = parseTest(json);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    // threads of tests which are done
+    for (auto &[id, test] : tests_) {
+        if (test->state != "running" && test->thread.joinable()) test->thread.join();
+    }
+
+    const auto id = next_id_;
+
+    // tests must not overwrite each others results
+    if (config.config_name.empty()) config.config_name = "test-" + std::to_string(id) + ".json";
+
+    // the opening book is shuffled with the seed of the test
+    util::random::seed(config.seed);
+
+    auto test        = std::make_unique<Test>();
+    test->id         = id;
+    test->engines    = engines;
+    test->tournament = TournamentManager::create(config, engines, stats, &resources_);
+
+    next_id_++;
+
+    auto &entry  = *tests_.emplace(id, std::move(test)).first->second;
+    entry.thread = std::thread(&Daemon::play, this, std::ref(entry));
+
+    Logger::info("Test {} submitted: {} vs {}", id, engines[0].name, engines[1].name);
+
+    return {{"type", message::SUBMITTED}, {"id", id}};
+}
+
+nlohmann::ordered_json Daemon::status() {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    auto tests = nlohmann::ordered_json::array();
+
+    for (const auto &[id, test] : tests_) {
+        nlohmann::ordered_json entry;
+        entry["id"]    = id;
+        entry["state"] = test->state;
+
+        auto &names = entry["engines"] = nlohmann::ordered_json::array();
+        for (const auto &engine : test->engines) names.push_back(engine.name);
+
+        if (test->tournament) {
+            entry["played"] = test->tournament->played();
+            entry["total"]  = test->tournament->total();
+            entry["stats"]  = test->tournament->getResults();
+        } else {
+            entry["played"] = test->played;
+            entry["total"]  = test->total;
+            entry["stats"]  = test->results;
+        }
+
+        if (!test->error.empty()) entry["error"] = test->error;
+
+        tests.push_back(entry);
+    }
+
+    return {{"type", message::STATUS}, {"tests", tests}};
+}
+
+nlohmann::ordered_json Daemon::cancel(std::uint64_t id) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    const auto it = tests_.find(id);
+    if (it == tests_.end()) throw std::runtime_error("Error; Unknown test " + std::to_string(id) + ".");
+
+    auto &test = *it->second;
+    if (test.state == "running") {
+        test.state = "cancelled";
+        test.tournament->stop();
+    }
+
+    return {{"type", message::CANCELLED}, {"id", id}};
+}
+
+void Daemon::play(Test &test) {
+    std::string error;
+
+    try {
+        test.tournament->start();
+    } catch (const std::exception &e) {
+        error = e.what();
+    }
+
+    std::unique_ptr<RoundRobin> tournament;
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        test.results = test.tournament->getResults();
+        test.played  = test.tournament->played();
+        test.total   = test.tournament->total();
+        test.error   = error;
+
+        if (!error.empty()) {
+            test.state = "failed";
+        } else if (test.state == "running") {
+            test.state = "finished";
+        }
+
+        tournament = std::move(test.tournament);
+    }
+
+    Logger::info("Test {} {}", test.id, test.state);
+
+    // saves the results and waits for the remaining games
+    tournament.reset();
+}
+
+nlohmann::ordered_json request(const std::string &socket, const nlohmann::ordered_json &request) {
+    auto connection = util::net::Socket::connectUnix(socket);
+
+    std::string line;
+    if (!connection.send(request.dump()) || !connection.receive(line)) {
+        throw std::runtime_error("Error; The daemon at " + socket + " closed the connection.");
+    }
+
+    return nlohmann::ordered_json::parse(line);
+}
+
+nlohmann::ordered_json submitRequest(config::Tournament config, std::vector<EngineConfiguration> engines,
+                                     const stats_map &stats) {
+#ifndef NO_STD_FILESYSTEM
+    const auto absolute = [](std::string &path) {
+        if (!path.empty()) path = std::filesystem::absolute(path).string();
+    };
+
+    for (auto *file : {&config.opening.file, &config.pgn.file, &config.epd.file, &config.dataout.file,
+                       &config.journal.file, &config.config_name}) {
+        absolute(*file);
+    }
+
+    for (auto &engine : engines) {
+        if (!engine.dir.empty()) {
+            absolute(engine.dir);
+        } else if (std::filesystem::exists(engine.cmd)) {
+            // commands without a directory may also be found in the PATH
+            absolute(engine.cmd);
+        }
+    }
+#endif
+
+    nlohmann::ordered_json json = config;
+    json["engines"]             = engines;
+    if (!stats.empty()) json["stats"] = stats;
+
+    return {{"type", message::SUBMIT}, {"config", json}};
+}
+
+bool printResponse(const nlohmann::ordered_json &response) {
+    const auto type = response.value("type", "");
+
+    if (type == message::FAILURE) {
+        std::cerr << response.value("message", "Unknown error.") << std::endl;
+        return false;
+    }
+
+    if (type == message::SUBMITTED) {
+        std::cout << "Submitted test " << response["id"].get<std::uint64_t>() << std::endl;
+    } else if (type == message::CANCELLED) {
+        std::cout << "Cancelled test " << response["id"].get<std::uint64_t>() << std::endl;
+    } else if (type == message::STATUS) {
+        for (const auto &test : response["tests"]) {
+            std::cout << "Test " << test["id"].get<std::uint64_t>() << " (" << test["state"].get<std::string>()
+                      << "): " << test["played"].get<std::uint64_t>() << "/" << test["total"].get<std::uint64_t>()
+                      << " games" << std::endl;
+
+            const auto stats = nlohmann::json::parse(test["stats"].dump()).get<stats_map>();
+            for (const auto &[pair, result] : stats) {
+                std::cout << "  " << pair.first << " vs " << pair.second << ": W: " << result.wins
+                          << " L: " << result.losses << " D: " << result.draws << std::endl;
+            }
+
+            if (test.contains("error")) std::cout << "  " << test["error"].get<std::string>() << std::endl;
+        }
+    }
+
+    return true;
+}
+
+}  // namespace fastchess::daemon
@@ -0,0 +1,111 @@
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <json.hpp>
+
+#include <matchmaking/daemon/resources.hpp>
+#include <matchmaking/scoreboard.hpp>
+#include <matchmaking/tournament/roundrobin/roundrobin.hpp>
+#include <types/engine_config.hpp>
+#include <types/tournament.hpp>
+#include <util/socket.hpp>
+
+namespace fastchess::daemon {
+
+// Clients send a single line json request and receive a single line response, the "type"
+// field selects the request:
+//   submit {config}  -> submitted {id}, config uses the schema of the saved config file
+//   status           -> status {tests}
+//   cancel {id}      -> cancelled {id}
+// A request which fails is answered with error {message}.
+namespace message {
+constexpr auto SUBMIT    = "submit";
+constexpr auto SUBMITTED = "submitted";
+constexpr auto STATUS    = "status";
+constexpr auto CANCEL    = "cancel";
+constexpr auto CANCELLED = "cancelled";
+constexpr auto FAILURE   = "error";
+}  // namespace message
+
+// Tournament in the schema of the saved config file, the tournament settings with the
+// "engines" and optionally the "stats" of a previous run.
+struct TestConfig {
+    config::Tournament tournament;
+    std::vector<EngineConfiguration> engines;
+    stats_map stats;
+};
+
+// Reads and sanitizes the test, throws if it is invalid.
+[[nodiscard]] TestConfig parseTest(const nlohmann::ordered_json &json);
+
+// Long running server which plays the submitted tournaments in parallel. The tournaments
+// share the game slots fairly, parsed opening books and running engines are kept between
+// submissions.
+class Daemon {
+   public:
+    // slots is the number of games played in parallel over all tournaments, affinity pins
+    // the engines of all tournaments
+    Daemon(const std::string &socket, int slots, bool affinity);
+
+    ~Daemon();
+
+    // Serves requests until fastchess is stopped.
+    void run();
+
+    // Answers a single request, also used by the socket connections.
+    [[nodiscard]] nlohmann::ordered_json handle(const nlohmann::ordered_json &request);
+
+    [[nodiscard]] Resources &resources() noexcept { return resources_; }
+
+   private:
+    struct Test {
+        std::uint64_t id;
+        std::vector<EngineConfiguration> engines;
+        std::unique_ptr<RoundRobin> tournament;
+        std::thread thread;
+
+        // running, finished, cancelled or failed
+        std::string state = "running";
+        std::string error;
+
+        // kept once the tournament is gone
+        stats_map results;
+        std::uint64_t played = 0;
+        std::uint64_t total  = 0;
+    };
+
+    [[nodiscard]] nlohmann::ordered_json submit(const nlohmann::ordered_json &json);
+    [[nodiscard]] nlohmann::ordered_json status();
+    [[nodiscard]] nlohmann::ordered_json cancel(std::uint64_t id);
+
+    void play(Test &test);
+
+    std::string path_;
+    util::net::Socket server_;
+
+    Resources resources_;
+
+    std::mutex mutex_;
+    std::map<std::uint64_t, std::unique_ptr<Test>> tests_;
+    std::uint64_t next_id_ = 1;
+};
+
+// Sends one request to the daemon listening on the socket and returns its response.
+[[nodiscard]] nlohmann::ordered_json request(const std::string &socket, const nlohmann::ordered_json &request);
+
+// Submit request for the tournament. Relative paths are resolved here, the daemon may run
+// in another directory.
+[[nodiscard]] nlohmann::ordered_json submitRequest(config::Tournament config,
+                                                   std::vector<EngineConfiguration> engines, const stats_map &stats);
+
+// Prints the response of the daemon, returns false if it reported an error.
+bool printResponse(const nlohmann::ordered_json &response);
+
+}  // namespace fastchess::daemon
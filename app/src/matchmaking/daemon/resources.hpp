@@ -0,0 +1,34 @@
+#pragma once
+
+#include <memory>
+#include <string>
+
+#include <affinity/affinity_manager.hpp>
+#include <book/book_cache.hpp>
+#include <engine/uci_engine.hpp>
+#include <matchmaking/daemon/scheduler.hpp>
+#include <util/cache.hpp>
+
+namespace fastchess::daemon {
+
+// State which is shared by the tournaments running in one process, the daemon also keeps
+// it between submissions.
+struct Resources {
+    Resources(int slots, bool affinity)
+        : scheduler(slots),
+          cores(std::make_unique<affinity::AffinityManager>(affinity, 1, slots)),
+          engines(2 * slots) {}
+
+    SlotScheduler scheduler;
+
+    // one map for all tournaments, so no two games are pinned to the same core
+    std::unique_ptr<affinity::AffinityManager> cores;
+
+    book::BookCache books;
+
+    // running engine processes, identified by their serialized configuration, idle ones
+    // are stopped once there are more than two per slot
+    util::CachePool<engine::UciEngine, std::string> engines;
+};
+
+}  // namespace fastchess::daemon
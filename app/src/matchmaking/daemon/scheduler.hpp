@@ -0,0 +1,149 @@
+#pragma once
+
+#include <chrono>
+#include <algorithm>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <utility>
+
+namespace fastchess::daemon {
+
+// Hands out a fixed number of game slots to the tournaments of one process. A free slot goes
+// to the waiting tournament which currently plays the fewest games relative to its weight,
+// so the tests share the machine by weight no matter how high their own concurrency is.
+// Slots of a finished test are taken over by the remaining ones right away.
+class SlotScheduler {
+   public:
+    // Returns the slot to the scheduler when it goes out of scope.
+    class Slot {
+       public:
+        Slot(SlotScheduler &scheduler, const void *owner) : scheduler_(&scheduler), owner_(owner) {}
+
+        Slot(const Slot &)            = delete;
+        Slot &operator=(const Slot &) = delete;
+
+        Slot(Slot &&other) noexcept : scheduler_(other.scheduler_), owner_(other.owner_) { other.scheduler_ = nullptr; }
+
+        Slot &operator=(Slot &&other) noexcept {
+            if (this == &other) return *this;
+
+            if (scheduler_) scheduler_->release(owner_);
+            scheduler_ = std::exchange(other.scheduler_, nullptr);
+            owner_     = other.owner_;
+            return *this;
+        }
+
+        ~Slot() {
+            if (scheduler_) scheduler_->release(owner_);
+        }
+
+       private:
+        SlotScheduler *scheduler_;
+        const void *owner_;
+    };
+
+    explicit SlotScheduler(int slots) : slots_(slots), free_(slots) {}
+
+    [[nodiscard]] int slots() const noexcept { return slots_; }
+
+    void add(const void *owner, int weight = 1) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        owners_.emplace(owner, Usage{added_++, std::max(weight, 1)});
+    }
+
+    void remove(const void *owner) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        owners_.erase(owner);
+        cv_.notify_all();
+    }
+
+    // Blocks until the owner gets a slot, nullopt if stopped() returned true while waiting.
+    [[nodiscard]] std::optional<Slot> acquire(const void *owner, const std::function<bool()> &stopped) {
+        std::unique_lock<std::mutex> lock(mutex_);
+
+        auto &usage = owners_.at(owner);
+        usage.waiting++;
+
+        // poll the stop flag, it is not signalled through the condition variable
+        while (free_ <= 0 || next() != owner) {
+            if (stopped()) {
+                usage.waiting--;
+                cv_.notify_all();
+                return std::nullopt;
+            }
+
+            cv_.wait_for(lock, std::chrono::milliseconds(100));
+        }
+
+        usage.waiting--;
+        usage.running++;
+        free_--;
+
+        // another owner may be next in line for a remaining free slot
+        cv_.notify_all();
+
+        return std::optional<Slot>(std::in_place, *this, owner);
+    }
+
+    // Number of games the owner currently plays.
+    [[nodiscard]] int running(const void *owner) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        const auto it = owners_.find(owner);
+        return it == owners_.end() ? 0 : it->second.running;
+    }
+
+   private:
+    struct Usage {
+        std::uint64_t order;
+        int weight;
+        int running = 0;
+        int waiting = 0;
+    };
+
+    // The waiting owner with the fewest running games per weight, ties go to the owner added first.
+    [[nodiscard]] const void *next() const {
+        const void *best   = nullptr;
+        const Usage *least = nullptr;
+
+        for (const auto &[owner, usage] : owners_) {
+            if (usage.waiting == 0) continue;
+
+            if (least == nullptr || fewer(usage, *least)) {
+                best  = owner;
+                least = &usage;
+            }
+        }
+
+        return best;
+    }
+
+    // running / weight of a is lower, compared without division
+    [[nodiscard]] static bool fewer(const Usage &a, const Usage &b) noexcept {
+        const auto lhs = static_cast<std::int64_t>(a.running) * b.weight;
+        const auto rhs = static_cast<std::int64_t>(b.running) * a.weight;
+        return lhs < rhs || (lhs == rhs && a.order < b.order);
+    }
+
+    void release(const void *owner) {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        const auto it = owners_.find(owner);
+        if (it != owners_.end()) it->second.running--;
+
+        free_++;
+        cv_.notify_all();
+    }
+
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::map<const void *, Usage> owners_;
+    std::uint64_t added_ = 0;
+    const int slots_;
+    int free_;
+};
+
+}  // namespace fastchess::daemon
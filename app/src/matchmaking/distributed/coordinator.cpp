@@ -0,0 +1,266 @@
+#include <matchmaking/distributed/coordinator.hpp>
+
+#include <algorithm>
+#include <chrono>
+
+#include <config/config.hpp>
+#include <matchmaking/distributed/protocol.hpp>
+#include <util/logger/logger.hpp>
+
+namespace fastchess::distributed {
+
+namespace {
+// a connection which doesn't announce itself as worker in time is dropped
+constexpr auto HELLO_TIMEOUT = std::chrono::seconds(10);
+}  // namespace
+
+Coordinator::Coordinator(const config::Tournament &config, const std::vector<EngineConfiguration> &engine_configs,
+                         const stats_map &results)
+    : RoundRobin(config, engine_configs, results) {
+    for (const auto &engine : engine_configs) {
+        engines_[engine.name] = std::make_unique<engine::UciEngine>(engine, false);
+    }
+
+    server_ = util::net::Socket::listen(config.coordinator.host, config.coordinator.port);
+    Logger::info("Coordinator listening on {}:{}", config.coordinator.host, server_.port());
+
+    acceptor_ = std::thread(&Coordinator::accept, this);
+}
+
+Coordinator::~Coordinator() {
+    Logger::trace("~Coordinator()");
+
+    // the games wait for results of the workers, they have to finish before the connections are gone
+    stop_ = true;
+    pool_.kill();
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        closing_ = true;
+
+        for (const auto &worker : workers_) {
+            worker->send(nlohmann::ordered_json{{"type", message::STOP}}.dump());
+        }
+
+        for (const auto &reader : readers_) reader.connection->socket.shutdown();
+    }
+
+    if (acceptor_.joinable()) acceptor_.join();
+
+    // the acceptor is gone, nothing adds readers anymore
+    for (auto &reader : readers_) {
+        if (reader.thread.joinable()) reader.thread.join();
+    }
+}
+
+void Coordinator::playGame(const GamePair<EngineConfiguration, EngineConfiguration> &configs, start_callback start,
+                           finished_callback finish, const pgn::Opening &opening, std::size_t round_id,
+                           std::size_t game_id) {
+    if (stopped()) return;
+
+    start();
+
+    const auto match_data = play(configs, opening);
+    if (!match_data.has_value()) return;
+
+    const auto crashed = match_data->termination == MatchTermination::DISCONNECT ||
+                         match_data->termination == MatchTermination::RESOURCE_LIMIT;
+
+    if (crashed && !config_.recover) {
+        Logger::trace<true>("Game {} between {} and {} crashed / disconnected", game_id, configs.white.name,
+                            configs.black.name);
+        stop();
+        return;
+    }
+
+    const auto &white = *engines_.at(configs.white.name);
+    const auto &black = *engines_.at(configs.black.name);
+
+    finishGame(*match_data, finish, {white, black}, round_id, game_id);
+}
+
+std::optional<MatchData> Coordinator::play(const GamePair<EngineConfiguration, EngineConfiguration> &configs,
+                                           const pgn::Opening &opening) {
+    auto request       = nlohmann::ordered_json{{"type", message::GAME}};
+    request["white"]   = configs.white;
+    request["black"]   = configs.black;
+    request["opening"] = toJson(opening);
+
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    while (!stopped()) {
+        // the least loaded worker with a free slot
+        std::shared_ptr<Connection> worker;
+        for (const auto &candidate : workers_) {
+            if (candidate->busy >= candidate->slots) continue;
+            if (!worker || candidate->busy * worker->slots < worker->busy * candidate->slots) worker = candidate;
+        }
+
+        // poll the stop flag, it is not signalled through the condition variable
+        if (!worker) {
+            cv_.wait_for(lock, std::chrono::milliseconds(100));
+            continue;
+        }
+
+        const auto id = next_id_++;
+        assignments_[id].worker = worker;
+        worker->busy++;
+
+        request["id"] = id;
+
+        lock.unlock();
+        const auto sent = worker->send(request.dump());
+        lock.lock();
+
+        // a failed send means the connection is broken, the worker must not be picked again
+        // until its reader notices
+        if (!sent) {
+            workers_.erase(std::remove(workers_.begin(), workers_.end(), worker), workers_.end());
+            worker->socket.shutdown();
+        }
+
+        while (sent && !assignments_[id].result && !assignments_[id].lost && !stopped()) {
+            cv_.wait_for(lock, std::chrono::milliseconds(100));
+        }
+
+        auto assignment = std::move(assignments_[id]);
+        assignments_.erase(id);
+        worker->busy--;
+
+        if (assignment.result) return assignment.result;
+
+        if (!stopped()) Logger::warn("Warning; Worker {} didn't finish the game, reassigning it.", worker->peer);
+    }
+
+    return std::nullopt;
+}
+
+void Coordinator::accept() {
+    while (true) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (closing_) return;
+        }
+
+        auto socket = server_.accept(std::chrono::milliseconds(100));
+        if (!socket.valid()) continue;
+
+        socket.setReceiveTimeout(HELLO_TIMEOUT);
+
+        auto connection    = std::make_shared<Connection>();
+        connection->peer   = socket.peer();
+        connection->socket = std::move(socket);
+
+        std::unique_lock<std::mutex> lock(mutex_);
+        if (closing_) return;
+
+        // join the readers of closed connections, so they don't pile up over a long run
+        std::vector<std::thread> finished;
+        for (auto it = readers_.begin(); it != readers_.end();) {
+            if (!it->connection->done) {
+                ++it;
+                continue;
+            }
+
+            finished.push_back(std::move(it->thread));
+            it = readers_.erase(it);
+        }
+
+        readers_.push_back({connection, std::thread(&Coordinator::serve, this, connection)});
+
+        lock.unlock();
+
+        for (auto &thread : finished) thread.join();
+    }
+}
+
+void Coordinator::serve(std::shared_ptr<Connection> connection) {
+    receive(connection);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    connection->done = true;
+}
+
+void Coordinator::receive(const std::shared_ptr<Connection> &connection) {
+    std::string line;
+
+    // the worker announces how many games it plays in parallel
+    if (!connection->socket.receive(line)) {
+        Logger::trace("Connection from {} closed without hello", connection->peer);
+        return;
+    }
+
+    const auto hello = nlohmann::ordered_json::parse(line, nullptr, false);
+    if (hello.is_discarded() || hello.value("type", "") != message::HELLO || hello.value("slots", 0) < 1) {
+        Logger::warn("Warning; Ignoring connection from {}, it is not a fastchess worker.", connection->peer);
+        return;
+    }
+
+    connection->slots = hello["slots"].get<int>();
+
+    auto setup          = nlohmann::ordered_json{{"type", message::SETUP}};
+    setup["tournament"] = config_;
+    setup["engines"]    = engine_configs_;
+
+    if (!connection->send(setup.dump())) return;
+
+    // results arrive once a game is over, which can take arbitrarily long
+    connection->socket.setReceiveTimeout(std::chrono::milliseconds(0));
+
+    Logger::info("Worker {} connected with {} slots", connection->peer, connection->slots);
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (closing_) return;
+        workers_.push_back(connection);
+    }
+
+    cv_.notify_all();
+
+    while (connection->socket.receive(line)) {
+        const auto json = nlohmann::ordered_json::parse(line, nullptr, false);
+
+        const auto type = json.is_object() ? json.value("type", "") : "";
+
+        if ((type != message::RESULT && type != message::FAILED) || !json.contains("id") ||
+            !json["id"].is_number_unsigned()) {
+            Logger::warn("Warning; Invalid message from worker {}: {}", connection->peer, line);
+            continue;
+        }
+
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        const auto it = assignments_.find(json["id"].get<std::uint64_t>());
+        if (it == assignments_.end() || it->second.worker != connection) continue;
+
+        if (type == message::FAILED) {
+            Logger::warn("Warning; Worker {} could not play the game: {}", connection->peer,
+                         json.value("reason", ""));
+            it->second.lost = true;
+        } else {
+            try {
+                it->second.result = matchFromJson(json["match"]);
+            } catch (const std::exception &e) {
+                Logger::warn("Warning; Invalid result from worker {}: {}", connection->peer, e.what());
+                it->second.lost = true;
+            }
+        }
+
+        cv_.notify_all();
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    workers_.erase(std::remove(workers_.begin(), workers_.end(), connection), workers_.end());
+
+    // all unfinished games of this worker are played again by other workers
+    for (auto &[id, assignment] : assignments_) {
+        if (assignment.worker == connection && !assignment.result) assignment.lost = true;
+    }
+
+    if (!closing_) Logger::info("Worker {} disconnected", connection->peer);
+
+    cv_.notify_all();
+}
+
+}  // namespace fastchess::distributed
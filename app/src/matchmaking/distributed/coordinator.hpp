@@ -0,0 +1,95 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include <engine/uci_engine.hpp>
+#include <matchmaking/tournament/roundrobin/roundrobin.hpp>
+#include <types/match_data.hpp>
+#include <util/socket.hpp>
+
+namespace fastchess::distributed {
+
+// Round robin which doesn't play the games itself. The tournament state (scoreboard, sprt,
+// opening book, output files) stays in this process, the games are handed out to worker
+// processes which connect over TCP. Games of a worker which disconnects are given to
+// another worker.
+class Coordinator : public RoundRobin {
+   public:
+    Coordinator(const config::Tournament &config, const std::vector<EngineConfiguration> &engine_configs,
+                const stats_map &results);
+
+    ~Coordinator() override;
+
+    // Port the coordinator listens on, useful if it was started with port 0.
+    [[nodiscard]] int port() const { return server_.port(); }
+
+   protected:
+    void playGame(const GamePair<EngineConfiguration, EngineConfiguration> &configs, start_callback start,
+                  finished_callback finish, const pgn::Opening &opening, std::size_t round_id,
+                  std::size_t game_id) override;
+
+   private:
+    struct Connection {
+        util::net::Socket socket;
+        std::mutex send_mutex;
+        std::string peer;
+
+        // number of games the worker plays in parallel and currently plays
+        int slots = 0;
+        int busy  = 0;
+
+        // the reader thread of this connection returned and can be joined
+        bool done = false;
+
+        bool send(const std::string &message) {
+            std::lock_guard<std::mutex> lock(send_mutex);
+            return socket.send(message);
+        }
+    };
+
+    struct Assignment {
+        std::shared_ptr<Connection> worker;
+        std::optional<MatchData> result;
+        // the worker disconnected before it returned the result
+        bool lost = false;
+    };
+
+    // Blocks until a worker returned the game, nullopt if the tournament was stopped.
+    std::optional<MatchData> play(const GamePair<EngineConfiguration, EngineConfiguration> &configs,
+                                  const pgn::Opening &opening);
+
+    struct Reader {
+        std::shared_ptr<Connection> connection;
+        std::thread thread;
+    };
+
+    void accept();
+    void serve(std::shared_ptr<Connection> connection);
+    void receive(const std::shared_ptr<Connection> &connection);
+
+    // engines are never started on the coordinator, they only provide their config to the output
+    std::map<std::string, std::unique_ptr<engine::UciEngine>> engines_;
+
+    util::net::Socket server_;
+    std::thread acceptor_;
+
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    // every accepted connection, also the ones which didn't send their hello yet
+    std::vector<Reader> readers_;
+    std::vector<std::shared_ptr<Connection>> workers_;
+    std::unordered_map<std::uint64_t, Assignment> assignments_;
+    std::uint64_t next_id_ = 0;
+    bool closing_          = false;
+};
+
+}  // namespace fastchess::distributed
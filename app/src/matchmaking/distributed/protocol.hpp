@@ -0,0 +1,182 @@
+#pragma once
+
+#include <string>
+
+#include <chess.hpp>
+#include <json.hpp>
+
+#include <pgn/pgn_reader.hpp>
+#include <types/match_data.hpp>
+
+namespace fastchess::distributed {
+
+// The coordinator and the workers exchange single line json objects, the "type" field
+// selects the message:
+//   worker      -> coordinator: hello {slots}, result {id, match}, failed {id, reason}
+//   coordinator -> worker:      setup {tournament, engines}, game {id, white, black, opening}, stop
+// A game the worker couldn't play is answered with failed, the coordinator gives it to
+// another worker.
+namespace message {
+constexpr auto HELLO  = "hello";
+constexpr auto RESULT = "result";
+constexpr auto FAILED = "failed";
+constexpr auto SETUP  = "setup";
+constexpr auto GAME   = "game";
+constexpr auto STOP   = "stop";
+}  // namespace message
+
+[[nodiscard]] inline nlohmann::ordered_json toJson(const pgn::Opening &opening) {
+    nlohmann::ordered_json json;
+    json["fen"] = opening.fen;
+    json["stm"] = static_cast<int>(opening.stm);
+
+    // raw move encoding, castling and promotions survive without a board
+    auto &moves = json["moves"] = nlohmann::ordered_json::array();
+    for (const auto &move : opening.moves) moves.push_back(move.move());
+
+    return json;
+}
+
+[[nodiscard]] inline pgn::Opening openingFromJson(const nlohmann::ordered_json &json) {
+    pgn::Opening opening;
+    opening.fen = json.at("fen").get<std::string>();
+    opening.stm = chess::Color(json.at("stm").get<int>());
+
+    for (const auto &move : json.at("moves")) opening.moves.emplace_back(move.get<std::uint16_t>());
+
+    return opening;
+}
+
+[[nodiscard]] inline nlohmann::ordered_json toJson(const MatchData &data) {
+    const auto player = [](const MatchData::PlayerInfo &info) {
+        nlohmann::ordered_json json;
+        json["config"] = info.config;
+        json["result"] = static_cast<int>(info.result);
+        json["color"]  = static_cast<int>(info.color);
+
+        if (info.usage) {
+            json["usage"] = {{"cpu_millis", info.usage->cpu_millis},
+                             {"throttled_millis", info.usage->throttled_millis},
+                             {"memory_peak", info.usage->memory_peak}};
+        }
+
+        if (info.process) {
+            json["process"] = {{"user_millis", info.process->user_millis},
+                               {"system_millis", info.process->system_millis},
+                               {"voluntary_switches", info.process->voluntary_switches},
+                               {"involuntary_switches", info.process->involuntary_switches},
+                               {"max_rss", info.process->max_rss}};
+        }
+
+        return json;
+    };
+
+    nlohmann::ordered_json json;
+    json["white"]      = player(data.players.white);
+    json["black"]      = player(data.players.black);
+    json["start_time"] = data.start_time;
+    json["end_time"]   = data.end_time;
+    json["duration"]   = data.duration;
+    json["date"]       = data.date;
+    json["fen"]        = data.fen;
+    json["reason"]     = data.reason;
+
+    auto &moves = json["moves"] = nlohmann::ordered_json::array();
+    for (const auto &move : data.moves) {
+        moves.push_back({{"move", move.move},
+                         {"score_string", move.score_string},
+                         {"elapsed_millis", move.elapsed_millis},
+                         {"nodes", move.nodes},
+                         {"seldepth", move.seldepth},
+                         {"depth", move.depth},
+                         {"score", move.score},
+                         {"nps", move.nps},
+                         {"hashfull", move.hashfull},
+                         {"tbhits", move.tbhits},
+                         {"legal", move.legal},
+                         {"book", move.book},
+                         {"cpu_millis", move.cpu_millis},
+                         {"involuntary_switches", move.involuntary_switches},
+                         {"clock_millis", move.clock_millis}});
+    }
+
+    auto &positions = json["positions"] = nlohmann::ordered_json::array();
+    for (const auto &position : data.positions) {
+        positions.push_back({{"fen", position.fen}, {"score", position.score}});
+    }
+
+    json["termination"]   = static_cast<int>(data.termination);
+    json["variant"]       = data.variant;
+    json["needs_restart"] = data.needs_restart;
+
+    return json;
+}
+
+[[nodiscard]] inline MatchData matchFromJson(const nlohmann::ordered_json &json) {
+    const auto player = [](const nlohmann::ordered_json &j) {
+        MatchData::PlayerInfo info;
+        info.config = j.at("config").get<EngineConfiguration>();
+        info.result = static_cast<chess::GameResult>(j.at("result").get<int>());
+        info.color  = chess::Color(j.at("color").get<int>());
+
+        if (j.contains("usage")) {
+            const auto &usage = j.at("usage");
+
+            info.usage                   = ResourceUsage{};
+            info.usage->cpu_millis       = usage.at("cpu_millis").get<int64_t>();
+            info.usage->throttled_millis = usage.at("throttled_millis").get<int64_t>();
+            info.usage->memory_peak      = usage.at("memory_peak").get<uint64_t>();
+        }
+
+        if (j.contains("process")) {
+            const auto &process = j.at("process");
+
+            info.process                       = ProcessUsage{};
+            info.process->user_millis          = process.at("user_millis").get<int64_t>();
+            info.process->system_millis        = process.at("system_millis").get<int64_t>();
+            info.process->voluntary_switches   = process.at("voluntary_switches").get<uint64_t>();
+            info.process->involuntary_switches = process.at("involuntary_switches").get<uint64_t>();
+            info.process->max_rss              = process.at("max_rss").get<uint64_t>();
+        }
+
+        return info;
+    };
+
+    MatchData data;
+    data.players.white = player(json.at("white"));
+    data.players.black = player(json.at("black"));
+    data.start_time    = json.at("start_time").get<std::string>();
+    data.end_time      = json.at("end_time").get<std::string>();
+    data.duration      = json.at("duration").get<std::string>();
+    data.date          = json.at("date").get<std::string>();
+    data.fen           = json.at("fen").get<std::string>();
+    data.reason        = json.at("reason").get<std::string>();
+
+    for (const auto &move : json.at("moves")) {
+        auto &entry = data.moves.emplace_back(move.at("move").get<std::string>(),
+                                              move.at("score_string").get<std::string>(),
+                                              move.at("elapsed_millis").get<int64_t>(), move.at("depth").get<int>(),
+                                              move.at("seldepth").get<int>(), move.at("score").get<int>(), 0,
+                                              move.at("legal").get<bool>(), move.at("book").get<bool>());
+
+        entry.nodes                = move.at("nodes").get<uint64_t>();
+        entry.nps                  = move.at("nps").get<int>();
+        entry.hashfull             = move.at("hashfull").get<int>();
+        entry.tbhits               = move.at("tbhits").get<uint64_t>();
+        entry.cpu_millis           = move.at("cpu_millis").get<int64_t>();
+        entry.involuntary_switches = move.at("involuntary_switches").get<uint64_t>();
+        entry.clock_millis         = move.at("clock_millis").get<int64_t>();
+    }
+
+    for (const auto &position : json.at("positions")) {
+        data.positions.push_back({position.at("fen").get<std::string>(), position.at("score").get<int>()});
+    }
+
+    data.termination   = static_cast<MatchTermination>(json.at("termination").get<int>());
+    data.variant       = json.at("variant").get<VariantType>();
+    data.needs_restart = json.at("needs_restart").get<bool>();
+
+    return data;
+}
+
+}  // namespace fastchess::distributed
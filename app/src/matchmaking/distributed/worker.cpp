@@ -0,0 +1,153 @@
+#include <matchmaking/distributed/worker.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <thread>
+
+#include <affinity/affinity.hpp>
+#include <config/config.hpp>
+#include <config/planner.hpp>
+#include <matchmaking/distributed/protocol.hpp>
+#include <matchmaking/match/match.hpp>
+#include <util/logger/logger.hpp>
+#include <util/scheduling.hpp>
+#include <util/scope_guard.hpp>
+
+namespace fastchess::distributed {
+
+Worker::Worker(const config::Worker &worker, const config::Tournament &local) : worker_(worker), local_(local) {
+    local_.concurrency = std::min(local_.concurrency, config::Machine::detect().processors);
+}
+
+Worker::~Worker() {
+    Logger::trace("~Worker()");
+
+    atomic::stop = true;
+    pool_.kill();
+}
+
+void Worker::run() {
+    // the coordinator might still be starting up
+    for (int attempt = 1;; attempt++) {
+        try {
+            socket_ = util::net::Socket::connect(worker_.host, worker_.port);
+            break;
+        } catch (const std::exception &) {
+            if (attempt == 10 || atomic::stop) throw;
+            std::this_thread::sleep_for(std::chrono::seconds(1));
+        }
+    }
+
+    Logger::info("Connected to coordinator {}:{}", worker_.host, worker_.port);
+
+    socket_.send(nlohmann::ordered_json{{"type", message::HELLO}, {"slots", local_.concurrency}}.dump());
+
+    std::string line;
+    while (!atomic::stop && socket_.receive(line)) {
+        const auto json = nlohmann::ordered_json::parse(line, nullptr, false);
+        const auto type = json.is_discarded() ? "" : json.value("type", "");
+
+        if (type == message::SETUP) {
+            setup(json);
+        } else if (type == message::GAME) {
+            pool_.enqueue(&Worker::play, this, json);
+        } else if (type == message::STOP) {
+            break;
+        } else {
+            Logger::warn("Warning; Invalid message from coordinator: {}", line);
+        }
+    }
+
+    Logger::info("Disconnected from coordinator");
+
+    // running games are lost anyway, the coordinator gives them to other workers
+    atomic::stop = true;
+    pool_.kill();
+}
+
+void Worker::setup(const nlohmann::ordered_json &json) {
+    auto tournament = json.at("tournament").get<config::Tournament>();
+    auto engines    = json.at("engines").get<std::vector<EngineConfiguration>>();
+
+    // machine specific settings are taken from this process
+    tournament.concurrency     = local_.concurrency;
+    tournament.affinity        = local_.affinity;
+    tournament.affinity_policy = local_.affinity_policy;
+    tournament.log             = local_.log;
+    tournament.maxengines      = local_.maxengines;
+    tournament.coordinator     = {};
+
+    // the engines of the coordinator may need fewer games at once on this machine, games beyond the
+    // announced slots then wait in the pool
+    const auto plan = config::applyPlan(tournament, engines);
+
+    config::TournamentConfig.setup([tournament]() { return std::make_unique<config::Tournament>(tournament); });
+    config::EngineConfigs.setup(
+        [engines]() { return std::make_unique<std::vector<EngineConfiguration>>(engines); });
+
+    // a game is pinned to one processor per thread of its larger engine, or of both with dedicated cores
+    cores_ = std::make_unique<affinity::AffinityManager>(tournament.affinity, plan.threads, tournament.concurrency);
+    pool_.resize(tournament.concurrency);
+    engine_cache_.setCapacity(std::max(tournament.maxengines, 2 * tournament.concurrency));
+}
+
+void Worker::play(const nlohmann::ordered_json &game) {
+    const auto id = game.value("id", nlohmann::ordered_json());
+
+    nlohmann::ordered_json reply;
+
+    // a game which isn't answered would keep its slot on the coordinator forever
+    try {
+        const auto match_data = playMatch(game);
+        if (!match_data) return;
+
+        reply = {{"type", message::RESULT}, {"id", id}, {"match", toJson(*match_data)}};
+    } catch (const std::exception &e) {
+        Logger::warn<true>("Warning; Could not play game {}: {}", id.dump(), e.what());
+
+        reply = {{"type", message::FAILED}, {"id", id}, {"reason", e.what()}};
+    }
+
+    std::lock_guard<std::mutex> lock(send_mutex_);
+    socket_.send(reply.dump());
+}
+
+std::optional<MatchData> Worker::playMatch(const nlohmann::ordered_json &game) {
+    if (atomic::stop) return std::nullopt;
+    if (!cores_) throw std::runtime_error("Error; The coordinator sent a game before the setup.");
+
+    const auto &config = config::TournamentConfig.get();
+    const auto core    = util::ScopeGuard(cores_->consume());
+
+    affinity::setThreadAffinity(core.get().domain);
+
+    const auto white_config = game.at("white").get<EngineConfiguration>();
+    const auto black_config = game.at("black").get<EngineConfiguration>();
+
+    const scheduling::ArbiterPriority arbiter(white_config.scheduling, black_config.scheduling);
+
+    auto &white_engine = engine_cache_.getEntry(white_config.name, white_config, config.log.realtime);
+    auto &black_engine = engine_cache_.getEntry(black_config.name, black_config, config.log.realtime);
+
+    util::ScopeGuard lock1(white_engine);
+    util::ScopeGuard lock2(black_engine);
+
+    // the match only keeps a reference to the opening
+    const auto opening = openingFromJson(game.at("opening"));
+
+    auto match = Match(config, opening, atomic::stop);
+    match.start(white_engine.get(), black_engine.get(), core.get().cpus);
+
+    // the coordinator decides whether the tournament continues, the engines are always restarted
+    if (match.isCrashOrDisconnect()) {
+        if (!white_engine.get().isready()) white_engine.get().refreshUci();
+        if (!black_engine.get().isready()) black_engine.get().refreshUci();
+    }
+
+    const auto match_data = match.get();
+    if (match_data.termination == MatchTermination::INTERRUPT || atomic::stop) return std::nullopt;
+
+    return match_data;
+}
+
+}  // namespace fastchess::distributed
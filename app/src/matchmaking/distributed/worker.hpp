@@ -0,0 +1,50 @@
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+
+#include <json.hpp>
+
+#include <affinity/affinity_manager.hpp>
+#include <engine/uci_engine.hpp>
+#include <types/distributed.hpp>
+#include <types/match_data.hpp>
+#include <types/tournament.hpp>
+#include <util/cache.hpp>
+#include <util/socket.hpp>
+#include <util/threadpool.hpp>
+
+namespace fastchess::distributed {
+
+// Plays the games a coordinator hands out. The tournament settings and engines are sent
+// by the coordinator, only the concurrency, affinity and logging of this process are kept.
+class Worker {
+   public:
+    Worker(const config::Worker &worker, const config::Tournament &local);
+
+    ~Worker();
+
+    // Connects to the coordinator and plays games until it sends stop or disconnects.
+    void run();
+
+   private:
+    void setup(const nlohmann::ordered_json &json);
+    void play(const nlohmann::ordered_json &game);
+
+    // Plays the game, nullopt if it was interrupted.
+    std::optional<MatchData> playMatch(const nlohmann::ordered_json &game);
+
+    config::Worker worker_;
+    config::Tournament local_;
+
+    util::net::Socket socket_;
+    std::mutex send_mutex_;
+
+    std::unique_ptr<affinity::AffinityManager> cores_;
+    util::CachePool<engine::UciEngine, std::string> engine_cache_ = util::CachePool<engine::UciEngine, std::string>();
+    util::ThreadPool pool_                                        = util::ThreadPool(1);
+};
+
+}  // namespace fastchess::distributed
@@ -0,0 +1,167 @@
+#include <matchmaking/journal/journal.hpp>
+
+#include <fstream>
+#include <stdexcept>
+
+#ifdef _WIN64
+#    include <io.h>
+#else
+#    include <unistd.h>
+#endif
+
+#include <json.hpp>
+
+#include <util/logger/logger.hpp>
+#include <util/safe_getline.hpp>
+
+namespace fastchess {
+
+namespace {
+std::string formatResult(const Stats &stats) {
+    if (stats.wins) return "1-0";
+    if (stats.losses) return "0-1";
+    return "1/2-1/2";
+}
+
+std::optional<Stats> parseResult(const std::string &result) {
+    if (result == "1-0") return Stats(1, 0, 0);
+    if (result == "0-1") return Stats(0, 1, 0);
+    if (result == "1/2-1/2") return Stats(0, 0, 1);
+    return std::nullopt;
+}
+
+bool endsWithNewline(const std::string &file) {
+    std::ifstream in(file, std::ios::binary | std::ios::ate);
+    if (!in || in.tellg() == 0) return true;
+
+    in.seekg(-1, std::ios::end);
+    return in.get() == '\n';
+}
+}  // namespace
+
+Journal::Journal(const std::string &file, int sync_interval, uint64_t seed) : sync_interval_(sync_interval) {
+    std::ifstream in(file);
+    std::string line;
+    std::size_t line_number = 0;
+
+    while (util::safeGetline(in, line)) {
+        line_number++;
+
+        if (line.empty()) continue;
+
+        if (line_number == 1 && line.find("\"seed\"") != std::string::npos) continue;
+
+        // an entry which was only partially written before a crash
+        auto entry = deserialize(line);
+        if (!entry.has_value()) {
+            Logger::warn("Warning; Skipping invalid journal entry in {} on line {}", file, line_number);
+            continue;
+        }
+
+        entries_.push_back(std::move(*entry));
+    }
+
+    in.close();
+
+    file_ = std::fopen(file.c_str(), "a");
+    if (file_ == nullptr) throw std::runtime_error("Error; Could not open journal file: " + file);
+
+    // terminate a partially written last line, otherwise the next entry would be appended to it
+    if (!endsWithNewline(file)) std::fputc('\n', file_);
+
+    // new journal, the header stores the seed for the opening book
+    if (line_number == 0) {
+        const auto header = nlohmann::json{{"seed", seed}}.dump() + "\n";
+        std::fputs(header.c_str(), file_);
+        syncUnlocked();
+    }
+
+    Logger::trace("Loaded {} games from journal {}", entries_.size(), file);
+}
+
+Journal::~Journal() {
+    if (file_ == nullptr) return;
+
+    sync();
+    std::fclose(file_);
+}
+
+void Journal::append(const JournalEntry &entry) {
+    const auto line = serialize(entry) + "\n";
+
+    std::lock_guard<std::mutex> lock(file_mutex_);
+
+    std::fputs(line.c_str(), file_);
+    std::fflush(file_);
+
+    if (++unsynced_ >= sync_interval_) syncUnlocked();
+}
+
+void Journal::sync() {
+    std::lock_guard<std::mutex> lock(file_mutex_);
+    syncUnlocked();
+}
+
+void Journal::syncUnlocked() {
+    std::fflush(file_);
+
+#ifdef _WIN64
+    _commit(_fileno(file_));
+#else
+    fsync(fileno(file_));
+#endif
+
+    unsynced_ = 0;
+}
+
+std::optional<uint64_t> Journal::readSeed(const std::string &file) {
+    std::ifstream in(file);
+    std::string line;
+
+    if (!util::safeGetline(in, line)) return std::nullopt;
+
+    const auto json = nlohmann::json::parse(line, nullptr, false);
+    if (json.is_discarded() || !json.contains("seed")) return std::nullopt;
+
+    return json["seed"].get<uint64_t>();
+}
+
+std::string Journal::serialize(const JournalEntry &entry) {
+    nlohmann::ordered_json json;
+
+    json["white"]   = entry.white;
+    json["black"]   = entry.black;
+    json["round"]   = entry.round_id;
+    json["game"]    = entry.game;
+    json["opening"] = entry.opening;
+    json["result"]  = formatResult(entry.stats);
+
+    return json.dump();
+}
+
+std::optional<JournalEntry> Journal::deserialize(const std::string &line) {
+    const auto json = nlohmann::json::parse(line, nullptr, false);
+
+    if (json.is_discarded() || !json.is_object()) return std::nullopt;
+
+    try {
+        JournalEntry entry;
+
+        entry.white    = json.at("white").get<std::string>();
+        entry.black    = json.at("black").get<std::string>();
+        entry.round_id = json.at("round").get<std::size_t>();
+        entry.game     = json.at("game").get<int>();
+        entry.opening  = json.at("opening").get<int64_t>();
+
+        const auto stats = parseResult(json.at("result").get<std::string>());
+        if (!stats.has_value()) return std::nullopt;
+
+        entry.stats = *stats;
+
+        return entry;
+    } catch (const nlohmann::json::exception &) {
+        return std::nullopt;
+    }
+}
+
+}  // namespace fastchess
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <matchmaking/stats.hpp>
+
+namespace fastchess {
+
+// A single finished game, the stats are from white's point of view.
+struct JournalEntry {
+    std::string white;
+    std::string black;
+
+    std::size_t round_id = 0;
+    // index of the game inside the round
+    int game = 0;
+    // -1 if the game was played from the starting position
+    int64_t opening = -1;
+
+    Stats stats;
+};
+
+// Append-only record of all finished games. Every game adds one line to the file,
+// which is much cheaper than rewriting the whole config. The file is synced to disk
+// in batches of sync_interval games. Reopening an existing journal replays its entries,
+// so a tournament can be resumed with exactly the games which are still missing.
+class Journal {
+   public:
+    Journal(const std::string &file, int sync_interval, uint64_t seed);
+
+    ~Journal();
+
+    Journal(const Journal &)            = delete;
+    Journal &operator=(const Journal &) = delete;
+
+    // Thread safe, appends the entry and syncs the file if the batch is full.
+    void append(const JournalEntry &entry);
+
+    // Flush and fsync all pending entries.
+    void sync();
+
+    // Entries which were already in the file when it was opened.
+    [[nodiscard]] const std::vector<JournalEntry> &entries() const noexcept { return entries_; }
+
+    // Returns the seed stored in the header of an existing journal, the opening book
+    // has to be shuffled with the same seed to replay the same openings.
+    [[nodiscard]] static std::optional<uint64_t> readSeed(const std::string &file);
+
+    [[nodiscard]] static std::string serialize(const JournalEntry &entry);
+    [[nodiscard]] static std::optional<JournalEntry> deserialize(const std::string &line);
+
+   private:
+    void syncUnlocked();
+
+    std::FILE *file_ = nullptr;
+    std::mutex file_mutex_;
+
+    std::vector<JournalEntry> entries_;
+
+    int sync_interval_;
+    int unsynced_ = 0;
+};
+
+}  // namespace fastchess
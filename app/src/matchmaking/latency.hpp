@@ -0,0 +1,137 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <mutex>
+#include <string_view>
+
+#include <util/histogram.hpp>
+#include <util/logger/logger.hpp>
+
+namespace fastchess {
+
+// What fastchess does for a move besides waiting for the engine to think.
+enum class Phase {
+    // game over detection with the legal move generation and the adjudication
+    GAME_OVER,
+    // isready before the position
+    PING,
+    POSITION,
+    // isready after the position
+    READY,
+    GO,
+    // isready after the bestmove
+    CONFIRM,
+    // parsing the bestmove and the info lines, checking the pv and making the move
+    MOVE,
+    // from receiving a bestmove to sending the opponent's go, everything above together
+    HANDOFF,
+};
+
+inline constexpr std::size_t PHASES = 8;
+
+[[nodiscard]] inline std::string_view phaseName(Phase phase) noexcept {
+    switch (phase) {
+        case Phase::GAME_OVER:
+            return "game over";
+        case Phase::PING:
+            return "isready";
+        case Phase::POSITION:
+            return "position";
+        case Phase::READY:
+            return "readyok";
+        case Phase::GO:
+            return "go";
+        case Phase::CONFIRM:
+            return "bestmove isready";
+        case Phase::MOVE:
+            return "move";
+        case Phase::HANDOFF:
+            return "handoff";
+    }
+
+    return "";
+}
+
+// Histograms of the phases of the moves of a game, in microseconds.
+class Latency {
+   public:
+    void record(Phase phase, std::chrono::steady_clock::duration duration) noexcept {
+        const auto micros = std::chrono::duration_cast<std::chrono::microseconds>(duration).count();
+        histograms_[static_cast<std::size_t>(phase)].record(micros > 0 ? micros : 0);
+    }
+
+    void merge(const Latency &other) noexcept {
+        for (std::size_t i = 0; i < PHASES; i++) histograms_[i].merge(other.histograms_[i]);
+    }
+
+    [[nodiscard]] const util::Histogram &get(Phase phase) const noexcept {
+        return histograms_[static_cast<std::size_t>(phase)];
+    }
+
+   private:
+    std::array<util::Histogram, PHASES> histograms_ = {};
+};
+
+// Collects the latency of the finished games.
+class LatencyBoard {
+   public:
+    // the 99th percentile of the handoff fastchess may take before it warns
+    static constexpr std::chrono::microseconds OVERHEAD_BUDGET = std::chrono::milliseconds(5);
+
+    void add(const Latency &latency) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        latency_.merge(latency);
+    }
+
+    [[nodiscard]] Latency get() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return latency_;
+    }
+
+    // One line about the handoff, for the rating interval.
+    void printSummary() const {
+        const auto latency  = get();
+        const auto &handoff = latency.get(Phase::HANDOFF);
+        if (handoff.count() == 0) return;
+
+        Logger::info("Arbiter overhead per move: p50 {:.3f} ms, p99 {:.3f} ms, max {:.3f} ms",
+                     ms(handoff.percentile(50)), ms(handoff.percentile(99)), ms(handoff.max()));
+    }
+
+    // A line per phase and a warning if the handoff is over the budget.
+    void print() const {
+        const auto latency = get();
+        if (latency.get(Phase::HANDOFF).count() == 0) return;
+
+        Logger::info("{:<30} {:>9} {:>9} {:>9} {:>9} {:>9}", "Arbiter overhead (ms)", "Moves", "p50", "p90", "p99",
+                     "max");
+
+        for (std::size_t i = 0; i < PHASES; i++) {
+            const auto phase      = static_cast<Phase>(i);
+            const auto &histogram = latency.get(phase);
+
+            Logger::info("{:<30} {:>9} {:>9.3f} {:>9.3f} {:>9.3f} {:>9.3f}", phaseName(phase), histogram.count(),
+                         ms(histogram.percentile(50)), ms(histogram.percentile(90)), ms(histogram.percentile(99)),
+                         ms(histogram.max()));
+        }
+
+        const auto p99 = latency.get(Phase::HANDOFF).percentile(99);
+
+        if (p99 > static_cast<std::uint64_t>(OVERHEAD_BUDGET.count())) {
+            Logger::warn(
+                "Warning; 1% of the moves took fastchess more than {:.3f} ms from the bestmove to the next go, the "
+                "budget is {:.3f} ms. The machine may be overloaded.",
+                ms(p99), ms(OVERHEAD_BUDGET.count()));
+        }
+    }
+
+   private:
+    static double ms(std::uint64_t micros) noexcept { return micros / 1000.0; }
+
+    Latency latency_;
+    mutable std::mutex mutex_;
+};
+
+}  // namespace fastchess
@@ -6,6 +6,7 @@
 #include <util/date.hpp>
 #include <util/helper.hpp>
 #include <util/logger/logger.hpp>
+#include <util/tracer/tracer.hpp>
 
 namespace fastchess {
 
@@ -15,6 +16,9 @@ extern std::atomic_bool stop;
 
 namespace {
 bool isFen(const std::string& line) { return line.find(';') == std::string::npos; }
+
+// the switches of threads which exited are no longer counted
+uint64_t switchesSince(uint64_t now, uint64_t then) { return now > then ? now - then : 0; }
 }  // namespace
 
 namespace chrono = std::chrono;
@@ -65,8 +69,23 @@ void Match::addMoveData(const Player& player, int64_t measured_time_ms, bool leg
     uci_moves_.push_back(move);
 }
 
+void Match::addPositionData(const Player& player, Move move) {
+    const auto& dataout = config_.dataout;
+
+    // mate scores cannot be used as a training target
+    if (player.engine.lastScoreType() != engine::ScoreType::CP) return;
+
+    const auto score = player.engine.lastScore();
+
+    if (dataout.skip_checks && board_.inCheck()) return;
+    if (dataout.skip_captures && board_.isCapture(move)) return;
+    if (dataout.max_score > 0 && std::abs(score) > dataout.max_score) return;
+
+    data_.positions.push_back({board_.getFen(), board_.sideToMove() == Color::WHITE ? score : -score});
+}
+
 void Match::prepare() {
-    board_.set960(config::TournamentConfig.get().variant == VariantType::FRC);
+    board_.set960(config_.variant == VariantType::FRC);
 
     if (isFen(opening_.fen))
         board_.setFen(opening_.fen);
@@ -86,9 +105,9 @@ void Match::prepare() {
 
     std::transform(opening_.moves.begin(), opening_.moves.end(), std::back_inserter(data_.moves), insert_move);
 
-    draw_tracker_     = DrawTracker();
-    resign_tracker_   = ResignTracker();
-    maxmoves_tracker_ = MaxMovesTracker();
+    draw_tracker_     = DrawTracker(config_);
+    resign_tracker_   = ResignTracker(config_);
+    maxmoves_tracker_ = MaxMovesTracker(config_);
 }
 
 void Match::start(engine::UciEngine& white, engine::UciEngine& black, const std::vector<int>& cpus) {
@@ -105,25 +124,39 @@ void Match::start(engine::UciEngine& white, engine::UciEngine& black, const std:
 
     if (!white_player.engine.start()) {
         Logger::trace<true>("Failed to start engines, stopping tournament.");
-        atomic::stop = true;
+        stop_ = true;
         return;
     }
 
-    if (atomic::stop.load()) {
+    if (stopped()) {
         return;
     }
 
     if (!black_player.engine.start()) {
         Logger::trace<true>("Failed to start engines, stopping tournament.");
-        atomic::stop = true;
+        stop_ = true;
         return;
     }
 
     white_player.engine.refreshUci();
     black_player.engine.refreshUci();
 
-    white_player.engine.setCpus(cpus);
-    black_player.engine.setCpus(cpus);
+    // with dedicated cores white gets the first half of the set and black the second
+    if (config_.affinity_policy == AffinityPolicy::DEDICATED && cpus.size() >= 2) {
+        const auto half = cpus.begin() + cpus.size() / 2;
+
+        white_player.engine.setCpus(std::vector<int>(cpus.begin(), half));
+        black_player.engine.setCpus(std::vector<int>(half, cpus.end()));
+    } else {
+        white_player.engine.setCpus(cpus);
+        black_player.engine.setCpus(cpus);
+    }
+
+    white_player.usage_start = white_player.engine.cgroupUsage();
+    black_player.usage_start = black_player.engine.cgroupUsage();
+
+    white_player.rusage_start = white_player.engine.rusage();
+    black_player.rusage_start = black_player.engine.rusage();
 
     auto& first  = board_.sideToMove() == Color::WHITE ? white_player : black_player;
     auto& second = board_.sideToMove() == Color::WHITE ? black_player : white_player;
@@ -132,14 +165,14 @@ void Match::start(engine::UciEngine& white, engine::UciEngine& black, const std:
 
     try {
         while (true) {
-            if (atomic::stop.load()) {
+            if (stopped()) {
                 data_.termination = MatchTermination::INTERRUPT;
                 break;
             }
 
             if (!playMove(first, second)) break;
 
-            if (atomic::stop.load()) {
+            if (stopped()) {
                 data_.termination = MatchTermination::INTERRUPT;
                 break;
             }
@@ -151,17 +184,63 @@ void Match::start(engine::UciEngine& white, engine::UciEngine& black, const std:
 
     const auto end = clock::now();
 
-    data_.variant = config::TournamentConfig.get().variant;
+    data_.variant = config_.variant;
 
     data_.end_time = util::time::datetime("%Y-%m-%dT%H:%M:%S %z");
     data_.duration = util::time::duration(chrono::duration_cast<chrono::seconds>(end - start));
 
-    data_.players =
-        GamePair(MatchData::PlayerInfo{white_player.engine.getConfig(), white_player.getResult(), white_player.color},
-                 MatchData::PlayerInfo{black_player.engine.getConfig(), black_player.getResult(), black_player.color});
+    data_.players = GamePair(MatchData::PlayerInfo{white_player.engine.getConfig(), white_player.getResult(),
+                                                   white_player.color, resourceUsage(white_player),
+                                                   processUsage(white_player)},
+                             MatchData::PlayerInfo{black_player.engine.getConfig(), black_player.getResult(),
+                                                   black_player.color, resourceUsage(black_player),
+                                                   processUsage(black_player)});
+}
+
+std::optional<ResourceUsage> Match::resourceUsage(const Player& player) {
+    const auto usage = player.engine.cgroupUsage();
+    if (!usage || !player.usage_start) return std::nullopt;
+
+    const auto millis = [](auto duration) { return chrono::duration_cast<chrono::milliseconds>(duration).count(); };
+
+    ResourceUsage result;
+    result.cpu_millis       = millis(usage->cpu - player.usage_start->cpu);
+    result.throttled_millis = millis(usage->throttled - player.usage_start->throttled);
+    result.memory_peak      = usage->memory_peak / (1024 * 1024);
+
+    return result;
+}
+
+std::optional<ProcessUsage> Match::processUsage(const Player& player) {
+    const auto usage  = player.engine.rusage();
+    const auto& start = player.rusage_start;
+    if (!usage || !start) return std::nullopt;
+
+    // the engine was restarted during the game
+    if (usage->user < start->user || usage->system < start->system) return std::nullopt;
+
+    const auto millis = [](auto duration) { return chrono::duration_cast<chrono::milliseconds>(duration).count(); };
+
+    ProcessUsage result;
+    result.user_millis          = millis(usage->user - start->user);
+    result.system_millis        = millis(usage->system - start->system);
+    result.voluntary_switches   = switchesSince(usage->voluntary_switches, start->voluntary_switches);
+    result.involuntary_switches = switchesSince(usage->involuntary_switches, start->involuntary_switches);
+    result.max_rss              = usage->max_rss / (1024 * 1024);
+
+    return result;
 }
 
 bool Match::playMove(Player& us, Player& them) {
+    auto mark = chrono::steady_clock::now();
+
+    // time since the previous phase ended
+    const auto lap = [this, &mark](Phase phase) {
+        const auto now = chrono::steady_clock::now();
+        latency_.record(phase, now - mark);
+        mark = now;
+    };
+
     const auto gameover = isGameOver();
     const auto name     = us.engine.getConfig().name;
 
@@ -186,12 +265,16 @@ bool Match::playMove(Player& us, Player& them) {
         return false;
     }
 
+    lap(Phase::GAME_OVER);
+
     // disconnect
     if (!us.engine.isready()) {
         setEngineCrashStatus(us, them);
         return false;
     }
 
+    lap(Phase::PING);
+
     // write new uci position
     auto success = us.engine.position(uci_moves_, start_position_);
     if (!success) {
@@ -199,12 +282,16 @@ bool Match::playMove(Player& us, Player& them) {
         return false;
     }
 
+    lap(Phase::POSITION);
+
     // wait for readyok
     if (!us.engine.isready()) {
         setEngineCrashStatus(us, them);
         return false;
     }
 
+    lap(Phase::READY);
+
     // write go command
     success = us.engine.go(us.getTimeControl(), them.getTimeControl(), board_.sideToMove());
     if (!success) {
@@ -212,20 +299,33 @@ bool Match::playMove(Player& us, Player& them) {
         return false;
     }
 
+    lap(Phase::GO);
+
+    if (last_bestmove_) latency_.record(Phase::HANDOFF, mark - *last_bestmove_);
+
     Logger::trace<true>("Engine {} is thinking", name);
 
     // wait for bestmove
+    const auto usage_before = config_.pgn.track_usage ? us.engine.rusage() : std::nullopt;
+
     auto t0     = clock::now();
     auto status = us.engine.readEngine("bestmove", us.getTimeoutThreshold());
     auto t1     = clock::now();
 
+    const auto think = mark;
+    mark             = chrono::steady_clock::now();
+
+    if (Tracer::enabled()) {
+        Tracer::complete("think", "engine", think, mark, {{"engine", name}, {"ply", data_.moves.size()}});
+    }
+
     Logger::trace<true>("Engine {} is done thinking", name);
 
-    if (!config::TournamentConfig.get().log.realtime) {
+    if (!config_.log.realtime) {
         us.engine.writeLog();
     }
 
-    if (atomic::stop) {
+    if (stopped()) {
         data_.termination = MatchTermination::INTERRUPT;
 
         return false;
@@ -240,15 +340,30 @@ bool Match::playMove(Player& us, Player& them) {
 
     Logger::trace<true>("Engine {} is in a ready state", name);
 
+    const auto bestmove_at = mark;
+    lap(Phase::CONFIRM);
+
     const auto elapsed_millis = chrono::duration_cast<chrono::milliseconds>(t1 - t0).count();
 
     const auto best_move = us.engine.bestmove();
     const auto move      = best_move ? uci::uciToMove(board_, *best_move) : Move::NO_MOVE;
     const auto legal     = isLegal(move);
 
-    const auto timeout = !us.updateTime(elapsed_millis);
+    const auto clock_millis = us.getTimeControl().getTimeLeft();
+    const auto timeout      = !us.updateTime(elapsed_millis);
 
     addMoveData(us, elapsed_millis, legal);
+    data_.moves.back().clock_millis = clock_millis;
+
+    if (const auto usage_after = usage_before ? us.engine.rusage() : std::nullopt; usage_after) {
+        auto& move_data = data_.moves.back();
+
+        const auto cpu = (usage_after->user + usage_after->system) - (usage_before->user + usage_before->system);
+
+        move_data.cpu_millis           = chrono::duration_cast<chrono::milliseconds>(cpu).count();
+        move_data.involuntary_switches = switchesSince(usage_after->involuntary_switches,
+                                                       usage_before->involuntary_switches);
+    }
 
     // there are two reasons why best_move could be empty
     // 1. the engine crashed
@@ -277,6 +392,11 @@ bool Match::playMove(Player& us, Player& them) {
         return false;
     }
 
+    // record the position before the move is made, so the score belongs to it
+    if (!config_.dataout.file.empty()) {
+        addPositionData(us, move);
+    }
+
     board_.makeMove(move);
 
     // CuteChess uses plycount/2 for its movenumber, which is wrong for epd books as it doesnt take
@@ -290,6 +410,9 @@ bool Match::playMove(Player& us, Player& them) {
     resign_tracker_.update(score, type, ~board_.sideToMove());
     maxmoves_tracker_.update();
 
+    lap(Phase::MOVE);
+    last_bestmove_ = bestmove_at;
+
     return true;
 }
 
@@ -325,6 +448,21 @@ void Match::setEngineCrashStatus(Player& loser, Player& winner) {
     const auto name  = loser.engine.getConfig().name;
     const auto color = getColorString();
 
+    // the oom killer or a refused fork of the sandbox are the likely cause
+    const auto usage    = loser.engine.cgroupUsage();
+    const auto breached = usage && loser.usage_start &&
+                          (usage->oom_kills > loser.usage_start->oom_kills ||
+                           usage->pids_denied > loser.usage_start->pids_denied);
+
+    if (breached) {
+        data_.termination = MatchTermination::RESOURCE_LIMIT;
+        data_.reason      = color + Match::RESOURCE_LIMIT_MSG;
+
+        Logger::warn<true>("Warning; Engine {} exceeds the limits of its sandbox, {} oom kills, {} refused forks",
+                           name, usage->oom_kills, usage->pids_denied);
+        return;
+    }
+
     data_.termination = MatchTermination::DISCONNECT;
     data_.reason      = color + Match::DISCONNECT_MSG;
 
@@ -424,7 +562,7 @@ void Match::verifyPvLines(const Player& us) {
 }
 
 bool Match::adjudicate(Player& us, Player& them) noexcept {
-    if (config::TournamentConfig.get().resign.enabled && resign_tracker_.resignable() && us.engine.lastScore() < 0) {
+    if (config_.resign.enabled && resign_tracker_.resignable() && us.engine.lastScore() < 0) {
         us.setLost();
         them.setWon();
 
@@ -436,7 +574,7 @@ bool Match::adjudicate(Player& us, Player& them) noexcept {
         return true;
     }
 
-    if (config::TournamentConfig.get().draw.enabled && draw_tracker_.adjudicatable(board_.fullMoveNumber() - 1)) {
+    if (config_.draw.enabled && draw_tracker_.adjudicatable(board_.fullMoveNumber() - 1)) {
         us.setDraw();
         them.setDraw();
 
@@ -446,7 +584,7 @@ bool Match::adjudicate(Player& us, Player& them) noexcept {
         return true;
     }
 
-    if (config::TournamentConfig.get().maxmoves.enabled && maxmoves_tracker_.maxmovesreached()) {
+    if (config_.maxmoves.enabled && maxmoves_tracker_.maxmovesreached()) {
         us.setDraw();
         them.setDraw();
 
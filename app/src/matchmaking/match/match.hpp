@@ -1,9 +1,13 @@
 #pragma once
 
+#include <chrono>
+#include <optional>
+
 #include <chess.hpp>
 
 #include <cli/cli.hpp>
 #include <config/config.hpp>
+#include <matchmaking/latency.hpp>
 #include <matchmaking/player.hpp>
 #include <pgn/pgn_reader.hpp>
 #include <types/match_data.hpp>
@@ -12,10 +16,10 @@ namespace fastchess {
 
 class DrawTracker {
    public:
-    DrawTracker() noexcept {
-        move_number_ = config::TournamentConfig.get().draw.move_number;
-        move_count_  = config::TournamentConfig.get().draw.move_count;
-        draw_score   = config::TournamentConfig.get().draw.score;
+    explicit DrawTracker(const config::Tournament& config) noexcept {
+        move_number_ = config.draw.move_number;
+        move_count_  = config.draw.move_count;
+        draw_score   = config.draw.score;
     }
 
     void update(const int score, engine::ScoreType score_type, const int hmvc) noexcept {
@@ -47,10 +51,10 @@ class DrawTracker {
 
 class ResignTracker {
    public:
-    ResignTracker() noexcept {
-        resign_score = config::TournamentConfig.get().resign.score;
-        move_count_  = config::TournamentConfig.get().resign.move_count;
-        twosided_    = config::TournamentConfig.get().resign.twosided;
+    explicit ResignTracker(const config::Tournament& config) noexcept {
+        resign_score = config.resign.score;
+        move_count_  = config.resign.move_count;
+        twosided_    = config.resign.twosided;
     }
 
     void update(const int score, engine::ScoreType score_type, chess::Color color) noexcept {
@@ -92,7 +96,7 @@ class ResignTracker {
 
 class MaxMovesTracker {
    public:
-    MaxMovesTracker() noexcept { move_count_ = config::TournamentConfig.get().maxmoves.move_count; }
+    explicit MaxMovesTracker(const config::Tournament& config) noexcept { move_count_ = config.maxmoves.move_count; }
 
     void update() noexcept { max_moves++; }
 
@@ -105,7 +109,15 @@ class MaxMovesTracker {
 
 class Match {
    public:
-    Match(const pgn::Opening& opening) : opening_(opening) {}
+    // The match is interrupted when stop or the global stop flag is set, it sets stop if the
+    // engines can't be started.
+    Match(const config::Tournament& config, const pgn::Opening& opening, std::atomic_bool& stop)
+        : config_(config),
+          opening_(opening),
+          stop_(stop),
+          draw_tracker_(config),
+          resign_tracker_(config),
+          maxmoves_tracker_(config) {}
 
     // starts the match
     void start(engine::UciEngine& white, engine::UciEngine& black, const std::vector<int>& cpus);
@@ -115,6 +127,9 @@ class Match {
 
     [[nodiscard]] bool isCrashOrDisconnect() const noexcept { return crash_or_disconnect_; }
 
+    // time fastchess spent on the phases of the moves
+    [[nodiscard]] const Latency& latency() const noexcept { return latency_; }
+
    private:
     // returns the reason and the result of the game, different order than chess lib function
     [[nodiscard]] std::pair<chess::GameResultReason, chess::GameResult> isGameOver() const;
@@ -123,6 +138,12 @@ class Match {
     void setEngineTimeoutStatus(Player& loser, Player& winner);
     void setEngineIllegalMoveStatus(Player& loser, Player& winner, const std::optional<std::string>& best_move);
 
+    // What the engine's sandbox accounted for since the game started.
+    [[nodiscard]] static std::optional<ResourceUsage> resourceUsage(const Player& player);
+
+    // What the kernel accounted for the engine process since the game started.
+    [[nodiscard]] static std::optional<ProcessUsage> processUsage(const Player& player);
+
     static bool isUciMove(const std::string& move) noexcept;
     void verifyPvLines(const Player& us);
 
@@ -132,6 +153,9 @@ class Match {
     // append the move data to the match data
     void addMoveData(const Player& player, int64_t measured_time_ms, bool legal);
 
+    // append the current position to the match data if it passes the data output filters
+    void addPositionData(const Player& player, chess::Move move);
+
     // returns false if the next move could not be played
     [[nodiscard]] bool playMove(Player& us, Player& them);
 
@@ -151,14 +175,18 @@ class Match {
 
     bool isLegal(chess::Move move) const noexcept;
 
+    [[nodiscard]] bool stopped() const noexcept { return stop_.load() || atomic::stop.load(); }
+
+    const config::Tournament& config_;
     const pgn::Opening& opening_;
+    std::atomic_bool& stop_;
 
     MatchData data_     = {};
     chess::Board board_ = chess::Board();
 
-    DrawTracker draw_tracker_         = DrawTracker();
-    ResignTracker resign_tracker_     = ResignTracker();
-    MaxMovesTracker maxmoves_tracker_ = MaxMovesTracker();
+    DrawTracker draw_tracker_;
+    ResignTracker resign_tracker_;
+    MaxMovesTracker maxmoves_tracker_;
 
     std::vector<std::string> uci_moves_;
 
@@ -168,6 +196,11 @@ class Match {
 
     bool crash_or_disconnect_ = false;
 
+    Latency latency_;
+
+    // when the last bestmove arrived, the handoff ends with the next go
+    std::optional<std::chrono::steady_clock::time_point> last_bestmove_;
+
     inline static constexpr char INSUFFICIENT_MSG[]     = "Draw by insufficient mating material";
     inline static constexpr char REPETITION_MSG[]       = "Draw by 3-fold repetition";
     inline static constexpr char ILLEGAL_MSG[]          = " makes an illegal move";
@@ -178,5 +211,6 @@ class Match {
     inline static constexpr char CHECKMATE_MSG[]        = /*..*/ " mates";
     inline static constexpr char TIMEOUT_MSG[]          = /*.. */ " loses on time";
     inline static constexpr char DISCONNECT_MSG[]       = /*.. */ " disconnects";
+    inline static constexpr char RESOURCE_LIMIT_MSG[]   = /*.. */ " exceeds the limits of its sandbox";
 };
 }  // namespace fastchess
@@ -0,0 +1,139 @@
+#include <matchmaking/merge/merge.hpp>
+
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+
+#include <engine/uci_engine.hpp>
+#include <matchmaking/journal/journal.hpp>
+#include <matchmaking/output/output_factory.hpp>
+#include <matchmaking/sprt/sprt.hpp>
+#include <util/logger/logger.hpp>
+
+namespace fastchess {
+
+Merger::Merger(const config::Tournament &config, const std::vector<std::string> &files) : config_(config) {
+    has_sprt_ = config_.sprt.enabled;
+
+    for (const auto &file : files) {
+        std::ifstream in(file);
+        if (!in) throw std::runtime_error("Error; Could not open file to merge: " + file);
+
+        // config files are a single json object, journals have one json object per line
+        const auto json = nlohmann::json::parse(in, nullptr, false);
+
+        if (!json.is_discarded() && json.is_object() && json.contains("stats")) {
+            addConfig(json, file);
+        } else {
+            addJournal(file);
+        }
+    }
+}
+
+void Merger::addConfig(const nlohmann::json &json, const std::string &file) {
+    Logger::info("Merging config file: {}", file);
+
+    const auto tournament = json.get<config::Tournament>();
+
+    if (tournament.shard.total > 1 && !shards_.insert({tournament.shard.total, tournament.shard.index}).second) {
+        throw std::runtime_error("Error; Shard " + std::to_string(tournament.shard.index) + "/" +
+                                 std::to_string(tournament.shard.total) + " is merged twice: " + file);
+    }
+
+    if (!has_sprt_ && tournament.sprt.enabled) {
+        config_.sprt = tournament.sprt;
+        has_sprt_    = true;
+    }
+
+    for (const auto &engine : json["engines"]) {
+        addEngine(engine.get<EngineConfiguration>());
+    }
+
+    for (const auto &[players, stats] : json["stats"].get<stats_map>()) {
+        EngineConfiguration first, second;
+        first.name  = players.first;
+        second.name = players.second;
+
+        scoreboard_.updateNonPair({first, second}, stats);
+    }
+}
+
+void Merger::addJournal(const std::string &file) {
+    Logger::info("Merging journal: {}", file);
+
+    // read the lines directly, opening a Journal would append to the file
+    std::ifstream in(file);
+    std::vector<JournalEntry> entries;
+
+    std::string line;
+    while (std::getline(in, line)) {
+        if (auto entry = Journal::deserialize(line)) entries.push_back(*entry);
+    }
+
+    if (entries.empty()) {
+        throw std::runtime_error("Error; File is neither a config file nor a journal: " + file);
+    }
+
+    for (const auto &entry : entries) {
+        if (!games_.insert({entry.white, entry.black, entry.round_id, entry.game}).second) {
+            Logger::warn("Warning; Skipping duplicated game {} vs {} of round {} in {}", entry.white, entry.black,
+                         entry.round_id + 1, file);
+            continue;
+        }
+
+        EngineConfiguration white, black;
+        white.name = entry.white;
+        black.name = entry.black;
+
+        addEngine(white);
+        addEngine(black);
+
+        // the round ids are global, so pairs of different shards never collide
+        if (config_.report_penta) {
+            scoreboard_.updatePair({white, black}, entry.stats, entry.round_id);
+        } else {
+            scoreboard_.updateNonPair({white, black}, entry.stats);
+        }
+    }
+}
+
+void Merger::addEngine(const EngineConfiguration &engine) {
+    for (const auto &existing : engines_) {
+        if (existing.name == engine.name) return;
+    }
+
+    engines_.push_back(engine);
+}
+
+void Merger::print() {
+    const auto output = OutputFactory::create(config_.output, config_.report_penta, config_.output_file,
+                                              config_.output_games);
+    const auto sprt   = SPRT(config_.sprt.alpha, config_.sprt.beta, config_.sprt.elo0, config_.sprt.elo1,
+                             config_.sprt.model, has_sprt_);
+
+    for (std::size_t i = 0; i < engines_.size(); i++) {
+        for (std::size_t j = i + 1; j < engines_.size(); j++) {
+            const auto &first  = engines_[i].name;
+            const auto &second = engines_[j].name;
+            const auto stats   = scoreboard_.getStats(first, second);
+
+            if (stats.sum() == 0) continue;
+
+            // the engines are never started, they only provide their config to the output
+            const engine::UciEngine engine1(engines_[i], false);
+            const engine::UciEngine engine2(engines_[j], false);
+
+            output->printResult(stats, first, second);
+            output->printInterval(sprt, stats, first, second, {engine1, engine2}, config_.opening.file);
+
+            if (!sprt.isEnabled()) continue;
+
+            const auto result = sprt.getResult(sprt.getLLR(stats, config_.report_penta));
+
+            std::cout << "SPRT " << first << " vs " << second << ": " << SPRT::describe(result) << std::endl;
+        }
+    }
+}
+
+}  // namespace fastchess
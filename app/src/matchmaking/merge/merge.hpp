@@ -0,0 +1,47 @@
+#pragma once
+
+#include <set>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include <matchmaking/scoreboard.hpp>
+#include <types/engine_config.hpp>
+#include <types/tournament.hpp>
+
+namespace fastchess {
+
+// Combines the results of the shards of one tournament, which were played by independent
+// fastchess processes, into one result. Accepts the config files written by each shard
+// as well as their journals.
+class Merger {
+   public:
+    // The SPRT and report settings are taken from the given config, if SPRT is not enabled
+    // there, the settings of the first merged config file are used.
+    Merger(const config::Tournament &config, const std::vector<std::string> &files);
+
+    // Prints the combined results of every engine pair and the final SPRT verdict.
+    void print();
+
+    [[nodiscard]] stats_map getResults() { return scoreboard_.getResults(); }
+
+   private:
+    void addConfig(const nlohmann::json &json, const std::string &file);
+    void addJournal(const std::string &file);
+
+    void addEngine(const EngineConfiguration &engine);
+
+    config::Tournament config_;
+    bool has_sprt_ = false;
+
+    ScoreBoard scoreboard_;
+    std::vector<EngineConfiguration> engines_;
+
+    // (total, index) of the merged shards
+    std::set<std::pair<int, int>> shards_;
+    // (white, black, round_id, game) of the merged journal entries
+    std::set<std::tuple<std::string, std::string, std::size_t, int>> games_;
+};
+
+}  // namespace fastchess
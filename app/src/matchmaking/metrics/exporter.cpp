@@ -0,0 +1,105 @@
+#include <matchmaking/metrics/exporter.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+
+#include <util/logger/logger.hpp>
+
+namespace fastchess {
+
+namespace {
+// how long the thread waits for a connection before it checks the file and the stop flag
+constexpr auto POLL_INTERVAL = std::chrono::milliseconds(200);
+
+constexpr auto REQUEST_TIMEOUT = std::chrono::seconds(5);
+}  // namespace
+
+MetricsExporter::MetricsExporter(const config::Metrics &config, std::function<std::string()> render)
+    : config_(config), render_(std::move(render)) {
+    if (config_.port > 0) socket_ = util::net::Socket::listen(config_.host, config_.port);
+
+    thread_ = std::thread(&MetricsExporter::run, this);
+}
+
+MetricsExporter::~MetricsExporter() {
+    stop_ = true;
+    if (thread_.joinable()) thread_.join();
+
+    if (!config_.file.empty()) writeFile();
+}
+
+void MetricsExporter::run() {
+    const auto interval = std::chrono::seconds(std::max(1, config_.interval));
+    auto next_write     = std::chrono::steady_clock::now();
+
+    while (!stop_) {
+        if (!config_.file.empty() && std::chrono::steady_clock::now() >= next_write) {
+            writeFile();
+            next_write += interval;
+        }
+
+        if (!socket_.valid()) {
+            std::this_thread::sleep_for(POLL_INTERVAL);
+            continue;
+        }
+
+        auto client = socket_.accept(POLL_INTERVAL);
+        if (client.valid()) serve(client);
+    }
+}
+
+void MetricsExporter::serve(util::net::Socket &client) const {
+    client.setReceiveTimeout(REQUEST_TIMEOUT);
+
+    std::string request;
+    if (!client.receive(request)) return;
+
+    // the headers end with an empty line
+    std::string header;
+    while (client.receive(header) && !header.empty() && header != "\r") {
+    }
+
+    // GET /metrics HTTP/1.1
+    const auto begin = request.find(' ');
+    const auto end   = request.find(' ', begin + 1);
+    const auto path  = begin == std::string::npos ? "" : request.substr(begin + 1, end - begin - 1);
+
+    const auto found = path == "/" || path == "/metrics" || path.rfind("/metrics?", 0) == 0;
+    const auto body  = found ? render_() : std::string("not found\n");
+
+    const auto response = fmt::format(
+        "HTTP/1.1 {}\r\nContent-Type: text/plain; version=0.0.4; charset=utf-8\r\nContent-Length: {}\r\n"
+        "Connection: close\r\n\r\n{}",
+        found ? "200 OK" : "404 Not Found", body.size(), body);
+
+    // send appends the newline the body ends with
+    client.send(response.substr(0, response.size() - 1));
+}
+
+void MetricsExporter::writeFile() const {
+    // scrapers never see a partly written file
+    const auto temporary = config_.file + ".tmp";
+
+    {
+        std::ofstream file(temporary, std::ios::trunc);
+        file << render_();
+
+        if (!file) {
+            Logger::warn("Warning; Cannot write the metrics file {}", config_.file);
+            return;
+        }
+    }
+
+#ifdef _WIN64
+    // rename doesn't replace an existing file on Windows
+    std::remove(config_.file.c_str());
+#endif
+
+    if (std::rename(temporary.c_str(), config_.file.c_str()) != 0) {
+        Logger::warn("Warning; Cannot replace the metrics file {}", config_.file);
+    }
+}
+
+}  // namespace fastchess
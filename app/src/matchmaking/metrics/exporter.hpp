@@ -0,0 +1,45 @@
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <string>
+#include <thread>
+
+#include <types/metrics.hpp>
+#include <util/socket.hpp>
+
+namespace fastchess {
+
+// Publishes the metrics of a tournament from a thread of its own, for Prometheus to scrape
+// them from http://host:port/metrics and/or as a file which is replaced every interval.
+class MetricsExporter {
+   public:
+    MetricsExporter(const config::Metrics &config, std::function<std::string()> render);
+
+    // The file is written a last time with the final metrics.
+    ~MetricsExporter();
+
+    MetricsExporter(const MetricsExporter &)            = delete;
+    MetricsExporter &operator=(const MetricsExporter &) = delete;
+
+    // Port of the HTTP server, 0 if it doesn't serve the metrics.
+    [[nodiscard]] int port() const { return socket_.valid() ? socket_.port() : 0; }
+
+   private:
+    void run();
+
+    // Answers one HTTP request, any path besides / and /metrics is not found.
+    void serve(util::net::Socket &client) const;
+
+    void writeFile() const;
+
+    config::Metrics config_;
+    std::function<std::string()> render_;
+
+    util::net::Socket socket_;
+
+    std::atomic_bool stop_ = false;
+    std::thread thread_;
+};
+
+}  // namespace fastchess
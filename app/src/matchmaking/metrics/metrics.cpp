@@ -0,0 +1,195 @@
+#include <matchmaking/metrics/metrics.hpp>
+
+#include <algorithm>
+#include <string_view>
+
+#include <util/logger/logger.hpp>
+
+namespace fastchess {
+
+namespace {
+// label values are quoted, backslashes, quotes and newlines have to be escaped
+std::string escape(std::string_view value) {
+    std::string escaped;
+
+    for (const auto c : value) {
+        if (c == '\n') {
+            escaped += "\\n";
+            continue;
+        }
+
+        if (c == '\\' || c == '"') escaped += '\\';
+        escaped += c;
+    }
+
+    return escaped;
+}
+}  // namespace
+
+TournamentMetrics::TournamentMetrics(const std::vector<EngineConfiguration> &configs) {
+    for (const auto &config : configs) engines_.try_emplace(config.name);
+}
+
+void TournamentMetrics::setLlr(const std::string &engine, double llr) noexcept {
+    const auto it = engines_.find(engine);
+    if (it == engines_.end()) return;
+
+    it->second.llr.store(llr, std::memory_order_relaxed);
+    it->second.tested.store(true, std::memory_order_relaxed);
+}
+
+void TournamentMetrics::add(const MatchData &data) noexcept {
+    finished_.fetch_add(1, std::memory_order_relaxed);
+
+    // the side to move is the second field of the fen, it plays the first move
+    const auto space       = data.fen.find(' ');
+    const auto black_first = space != std::string::npos && data.fen.compare(space + 1, 1, "b") == 0;
+
+    for (const auto *player : {&data.players.white, &data.players.black}) {
+        const auto it = engines_.find(player->config.name);
+        if (it == engines_.end()) continue;
+
+        auto &engine = it->second;
+        engine.games.fetch_add(1, std::memory_order_relaxed);
+
+        if (player->result == chess::GameResult::LOSE) {
+            switch (data.termination) {
+                case MatchTermination::TIMEOUT:
+                    engine.timeouts.fetch_add(1, std::memory_order_relaxed);
+                    break;
+                case MatchTermination::DISCONNECT:
+                case MatchTermination::RESOURCE_LIMIT:
+                    engine.crashes.fetch_add(1, std::memory_order_relaxed);
+                    break;
+                case MatchTermination::ILLEGAL_MOVE:
+                    engine.illegal_moves.fetch_add(1, std::memory_order_relaxed);
+                    break;
+                default:
+                    break;
+            }
+        }
+
+        const std::size_t first = (player->color == chess::Color::BLACK) != black_first;
+
+        std::uint64_t moves = 0, nodes = 0, millis = 0, depth = 0;
+
+        for (auto i = first; i < data.moves.size(); i += 2) {
+            const auto &move = data.moves[i];
+            if (move.book) continue;
+
+            moves++;
+            nodes += move.nodes;
+            millis += static_cast<std::uint64_t>(std::max<int64_t>(0, move.elapsed_millis));
+            depth += static_cast<std::uint64_t>(std::max(0, move.depth));
+        }
+
+        engine.moves.fetch_add(moves, std::memory_order_relaxed);
+        engine.nodes.fetch_add(nodes, std::memory_order_relaxed);
+        engine.search_millis.fetch_add(millis, std::memory_order_relaxed);
+        engine.depth.fetch_add(depth, std::memory_order_relaxed);
+    }
+}
+
+std::string TournamentMetrics::render(std::size_t processes) const {
+    std::string out;
+
+    const auto metric = [&out](std::string_view name, std::string_view type, std::string_view help) {
+        out += fmt::format("# HELP fastchess_{} {}\n# TYPE fastchess_{} {}\n", name, help, name, type);
+    };
+
+    const auto sample = [&out](std::string_view name, std::string_view labels, auto value) {
+        if (labels.empty()) {
+            out += fmt::format("fastchess_{} {}\n", name, value);
+        } else {
+            out += fmt::format("fastchess_{}{{{}}} {}\n", name, labels, value);
+        }
+    };
+
+    // one sample per engine
+    const auto per_engine = [&](std::string_view name, std::string_view type, std::string_view help,
+                                const auto &value) {
+        metric(name, type, help);
+        for (const auto &[engine, counters] : engines_) {
+            sample(name, fmt::format("engine=\"{}\"", escape(engine)), value(counters));
+        }
+    };
+
+    const auto load = [](const std::atomic<std::uint64_t> &counter) {
+        return counter.load(std::memory_order_relaxed);
+    };
+
+    const auto finished = load(finished_);
+    const auto minutes  = std::chrono::duration<double, std::ratio<60>>(std::chrono::steady_clock::now() - begin_);
+
+    metric("games_finished_total", "counter", "Games which finished.");
+    sample("games_finished_total", "", finished);
+
+    metric("games_per_minute", "gauge", "Finished games per minute since the tournament started.");
+    sample("games_per_minute", "", minutes.count() > 0 ? finished / minutes.count() : 0.0);
+
+    metric("games_active", "gauge", "Games which are being played.");
+    sample("games_active", "", active_.load(std::memory_order_relaxed));
+
+    metric("games_queued", "gauge", "Games which wait for a free thread.");
+    sample("games_queued", "", load(queued_));
+
+    metric("engine_processes", "gauge", "Engine processes which are running.");
+    sample("engine_processes", "", processes);
+
+    per_engine("engine_games_total", "counter", "Finished games of the engine.",
+               [&](const EngineCounters &engine) { return load(engine.games); });
+    per_engine("engine_timeouts_total", "counter", "Games the engine lost on time.",
+               [&](const EngineCounters &engine) { return load(engine.timeouts); });
+    per_engine("engine_crashes_total", "counter", "Games the engine lost by a disconnect or a sandbox limit.",
+               [&](const EngineCounters &engine) { return load(engine.crashes); });
+    per_engine("engine_illegal_moves_total", "counter", "Games the engine lost by an illegal move.",
+               [&](const EngineCounters &engine) { return load(engine.illegal_moves); });
+    per_engine("engine_moves_total", "counter", "Moves the engine searched.",
+               [&](const EngineCounters &engine) { return load(engine.moves); });
+
+    per_engine("engine_move_seconds_mean", "gauge", "Mean time the engine took for a move.",
+               [&](const EngineCounters &engine) {
+                   const auto moves = load(engine.moves);
+                   return moves > 0 ? load(engine.search_millis) / 1000.0 / moves : 0.0;
+               });
+    per_engine("engine_nps", "gauge", "Nodes per second of the engine over all its moves.",
+               [&](const EngineCounters &engine) {
+                   const auto millis = load(engine.search_millis);
+                   return millis > 0 ? load(engine.nodes) * 1000.0 / millis : 0.0;
+               });
+    per_engine("engine_depth_mean", "gauge", "Mean depth the engine reached.", [&](const EngineCounters &engine) {
+        const auto moves = load(engine.moves);
+        return moves > 0 ? double(load(engine.depth)) / moves : 0.0;
+    });
+
+    metric("move_overhead_seconds", "summary",
+           "Time fastchess took from a bestmove to the go of the opponent, of the finished games.");
+
+    const auto handoff = handoff_.snapshot();
+    for (const auto quantile : {0.5, 0.9, 0.99}) {
+        sample("move_overhead_seconds", fmt::format("quantile=\"{}\"", quantile),
+               handoff.percentile(quantile * 100) / 1e6);
+    }
+
+    sample("move_overhead_seconds_sum", "", handoff.mean() * handoff.count() / 1e6);
+    sample("move_overhead_seconds_count", "", handoff.count());
+
+    if (sprt_.load(std::memory_order_relaxed)) {
+        metric("sprt_llr", "gauge", "Log likelihood ratio of the SPRT of the engine.");
+        for (const auto &[engine, counters] : engines_) {
+            if (!counters.tested.load(std::memory_order_relaxed)) continue;
+            const auto llr = counters.llr.load(std::memory_order_relaxed);
+            sample("sprt_llr", fmt::format("engine=\"{}\"", escape(engine)), llr);
+        }
+
+        metric("sprt_lower_bound", "gauge", "LLR at which the SPRT accepts H0.");
+        sample("sprt_lower_bound", "", lower_.load(std::memory_order_relaxed));
+
+        metric("sprt_upper_bound", "gauge", "LLR at which the SPRT accepts H1.");
+        sample("sprt_upper_bound", "", upper_.load(std::memory_order_relaxed));
+    }
+
+    return out;
+}
+
+}  // namespace fastchess
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+#include <matchmaking/latency.hpp>
+#include <types/engine_config.hpp>
+#include <types/match_data.hpp>
+#include <util/histogram.hpp>
+
+namespace fastchess {
+
+// Counters of a tournament for the metrics exporter. The game threads only touch atomics,
+// the rates and averages are computed when the metrics are read.
+class TournamentMetrics {
+   public:
+    explicit TournamentMetrics(const std::vector<EngineConfiguration> &configs);
+
+    void gameStarted() noexcept { active_.fetch_add(1, std::memory_order_relaxed); }
+    void gameEnded() noexcept { active_.fetch_sub(1, std::memory_order_relaxed); }
+
+    void setQueued(std::size_t games) noexcept { queued_.store(games, std::memory_order_relaxed); }
+
+    void setSprtBounds(double lower, double upper) noexcept {
+        lower_.store(lower, std::memory_order_relaxed);
+        upper_.store(upper, std::memory_order_relaxed);
+        sprt_.store(true, std::memory_order_relaxed);
+    }
+
+    // LLR of the engine against its opponent, the first engine of the test or a gauntlet candidate.
+    void setLlr(const std::string &engine, double llr) noexcept;
+
+    // Adds a finished game to the counters of its engines.
+    void add(const MatchData &data) noexcept;
+
+    // Adds the arbiter latency of a finished game, only the handoff is exported.
+    void add(const Latency &latency) noexcept { handoff_.merge(latency.get(Phase::HANDOFF)); }
+
+    // The metrics in the Prometheus text format, with the number of running engine processes,
+    // which are tracked elsewhere.
+    [[nodiscard]] std::string render(std::size_t processes) const;
+
+   private:
+    struct EngineCounters {
+        std::atomic<std::uint64_t> games         = 0;
+        std::atomic<std::uint64_t> timeouts      = 0;
+        std::atomic<std::uint64_t> crashes       = 0;
+        std::atomic<std::uint64_t> illegal_moves = 0;
+
+        // searched moves, without the book moves
+        std::atomic<std::uint64_t> moves         = 0;
+        std::atomic<std::uint64_t> nodes         = 0;
+        std::atomic<std::uint64_t> search_millis = 0;
+        std::atomic<std::uint64_t> depth         = 0;
+
+        std::atomic<double> llr = 0.0;
+        std::atomic_bool tested = false;
+    };
+
+    // the engines are known when the tournament starts, the map itself never changes later
+    std::map<std::string, EngineCounters> engines_;
+
+    std::chrono::steady_clock::time_point begin_ = std::chrono::steady_clock::now();
+
+    std::atomic<std::uint64_t> finished_ = 0;
+    std::atomic<std::int64_t> active_    = 0;
+    std::atomic<std::uint64_t> queued_   = 0;
+
+    // a scrape must not wait for the lock of the latency board, which the games take
+    util::AtomicHistogram handoff_;
+
+    std::atomic<double> lower_ = 0.0;
+    std::atomic<double> upper_ = 0.0;
+    std::atomic_bool sprt_     = false;
+};
+
+}  // namespace fastchess
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <functional>
 #include <string>
 #include <utility>
 
@@ -49,11 +50,14 @@ class IOutput {
 
     // Print game end.
     virtual void endGame(const GamePair<EngineConfiguration, EngineConfiguration>& configs, const Stats& stats,
-                         const std::string& annotation, std::size_t id) = 0;
+                         const std::string& annotation, MatchTermination termination, std::size_t id) = 0;
 
     // Print tournament end.
     virtual void endTournament() = 0;
 
+    // Processors in use by the running games, for an output which shows them.
+    virtual void setCoreMap(std::function<std::string()>) {}
+
     [[nodiscard]] static std::string formatStats(const Stats& stats) {
         if (stats.wins) {
             return "1-0";
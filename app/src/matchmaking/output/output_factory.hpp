@@ -2,18 +2,25 @@
 
 #include <matchmaking/output/output_cutechess.hpp>
 #include <matchmaking/output/output_fastchess.hpp>
+#include <matchmaking/output/output_json.hpp>
+#include <matchmaking/output/output_status.hpp>
 #include <types/tournament.hpp>
 
 namespace fastchess {
 
 class OutputFactory {
    public:
-    [[nodiscard]] static std::unique_ptr<IOutput> create(OutputType type, bool report_penta) {
+    [[nodiscard]] static std::unique_ptr<IOutput> create(OutputType type, bool report_penta,
+                                                         const std::string& file = "", bool games = false) {
         switch (type) {
             case OutputType::FASTCHESS:
                 return std::make_unique<Fastchess>(report_penta);
             case OutputType::CUTECHESS:
                 return std::make_unique<Cutechess>();
+            case OutputType::JSON:
+                return std::make_unique<JsonLines>(report_penta, file);
+            case OutputType::STATUS:
+                return std::make_unique<Status>(report_penta, games);
             default:
                 return std::make_unique<Fastchess>(report_penta);
         }
@@ -28,6 +35,14 @@ class OutputFactory {
             return OutputType::CUTECHESS;
         }
 
+        if (type == "json") {
+            return OutputType::JSON;
+        }
+
+        if (type == "status") {
+            return OutputType::STATUS;
+        }
+
         return OutputType::FASTCHESS;
     }
 };
@@ -114,7 +114,7 @@ class Fastchess : public IOutput {
     }
 
     void endGame(const GamePair<EngineConfiguration, EngineConfiguration>& configs, const Stats& stats,
-                 const std::string& annotation, std::size_t id) override {
+                 const std::string& annotation, MatchTermination, std::size_t id) override {
         auto fmt = fmt::format("Finished game {} ({} vs {}): {} {{{}}}\n", id, configs.white.name, configs.black.name,
                                formatStats(stats), annotation);
 
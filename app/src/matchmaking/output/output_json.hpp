@@ -0,0 +1,158 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+#include <json.hpp>
+
+#include <elo/elo_pentanomial.hpp>
+#include <elo/elo_wdl.hpp>
+#include <matchmaking/output/output.hpp>
+#include <util/logger/logger.hpp>
+
+namespace fastchess {
+
+// One json object per line and event, for programs which follow a tournament. Every line is
+// formatted before the lock is taken, which is only held to write it.
+class JsonLines : public IOutput {
+   public:
+    JsonLines(bool report_penta = true, const std::string& file = "") : report_penta_(report_penta) {
+        if (file.empty()) {
+            redirectLog();
+            return;
+        }
+
+        file_ = std::fopen(file.c_str(), "a");
+        if (file_ == nullptr) throw std::runtime_error("Error; Could not open json output file: " + file);
+    }
+
+    // a tournament which ends without an SPRT decision or is stopped never calls endTournament,
+    // the stream ends anyway
+    ~JsonLines() override {
+        endTournament();
+        if (file_ != stdout) std::fclose(file_);
+    }
+
+    JsonLines(const JsonLines&)            = delete;
+    JsonLines& operator=(const JsonLines&) = delete;
+
+    void printInterval(const SPRT& sprt, const Stats& stats, const std::string& first, const std::string& second,
+                       const engines& engines, const std::string& book) override {
+        std::string line = event("interval");
+        line += fmt::format(R"(,"first":{},"second":{},"games":{},"wins":{},"losses":{},"draws":{})", quote(first),
+                            quote(second), stats.sum(), stats.wins, stats.losses, stats.draws);
+
+        if (report_penta_) {
+            line += fmt::format(R"(,"penta":[{},{},{},{},{}])", stats.penta_LL, stats.penta_LD,
+                                stats.penta_WL + stats.penta_DD, stats.penta_WD, stats.penta_WW);
+        }
+
+        line += printElo(stats, first, second, engines, book);
+        line += printSprt(sprt, stats);
+        line += "}\n";
+
+        write(line);
+    }
+
+    void printResult(const Stats&, const std::string&, const std::string&) override {
+        // the interval has the score too
+    }
+
+    std::string printElo(const Stats& stats, const std::string&, const std::string&, const engines&,
+                         const std::string&) override {
+        if (stats.sum() == 0) return "";
+
+        std::unique_ptr<elo::EloBase> elo;
+
+        if (report_penta_) {
+            elo = std::make_unique<elo::EloPentanomial>(stats);
+        } else {
+            elo = std::make_unique<elo::EloWDL>(stats);
+        }
+
+        return fmt::format(R"(,"elo":{},"elo_error":{},"nelo":{},"nelo_error":{})", number(elo->diff()),
+                           number(elo->error()), number(elo->nEloDiff()), number(elo->nEloError()));
+    }
+
+    std::string printSprt(const SPRT& sprt, const Stats& stats) override {
+        if (!sprt.isEnabled()) return "";
+
+        return fmt::format(R"(,"llr":{},"lower":{},"upper":{})", number(sprt.getLLR(stats, report_penta_)),
+                           number(sprt.getLowerBound()), number(sprt.getUpperBound()));
+    }
+
+    void startGame(const GamePair<EngineConfiguration, EngineConfiguration>& configs, std::size_t current_game_count,
+                   std::size_t max_game_count) override {
+        std::string line = event("start");
+        line += fmt::format(R"(,"game":{},"games":{},"white":{},"black":{}}})", current_game_count, max_game_count,
+                            quote(configs.white.name), quote(configs.black.name));
+        line += '\n';
+
+        write(line);
+    }
+
+    void endGame(const GamePair<EngineConfiguration, EngineConfiguration>& configs, const Stats& stats,
+                 const std::string& annotation, MatchTermination, std::size_t id) override {
+        std::string line = event("end");
+        line += fmt::format(R"(,"game":{},"white":{},"black":{},"result":"{}","reason":{}}})", id,
+                            quote(configs.white.name), quote(configs.black.name), formatStats(stats),
+                            quote(annotation));
+        line += '\n';
+
+        write(line);
+    }
+
+    void endTournament() override {
+        if (ended_.exchange(true)) return;
+        write(event("tournament_end") + "}\n");
+    }
+
+    // The stream owns stdout, the log messages go to stderr. Also those which follow the
+    // stream, so a reader can take stdout until it ends.
+    static void redirectLog() {
+        Logger::setConsole([](const std::string& message) { std::cerr << message << std::flush; });
+    }
+
+    // A json string with the quotes, invalid UTF-8 is replaced.
+    [[nodiscard]] static std::string quote(std::string_view value) {
+        return nlohmann::json(std::string(value)).dump(-1, ' ', false, nlohmann::json::error_handler_t::replace);
+    }
+
+   private:
+    // json has no infinity or nan, an empty score gives both
+    [[nodiscard]] static std::string number(double value) {
+        return std::isfinite(value) ? fmt::format("{}", value) : "null";
+    }
+
+    // The opening of an object, with the time in milliseconds since the epoch.
+    [[nodiscard]] static std::string event(std::string_view name) {
+        const auto now = std::chrono::duration_cast<std::chrono::milliseconds>(
+                             std::chrono::system_clock::now().time_since_epoch())
+                             .count();
+
+        return fmt::format(R"({{"event":"{}","time":{})", name, now);
+    }
+
+    void write(const std::string& line) {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        std::fputs(line.c_str(), file_);
+        std::fflush(file_);
+    }
+
+    bool report_penta_;
+
+    std::FILE* file_        = stdout;
+    std::atomic_bool ended_ = false;
+    std::mutex mutex_;
+};
+
+}  // namespace fastchess
@@ -0,0 +1,316 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <deque>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#ifndef _WIN32
+#    include <unistd.h>
+#endif
+
+#include <elo/elo_pentanomial.hpp>
+#include <elo/elo_wdl.hpp>
+#include <matchmaking/output/output.hpp>
+#include <util/logger/logger.hpp>
+
+namespace fastchess {
+
+// A summary of the tournament which is redrawn in place a few times per second, instead of
+// lines for every game which the terminal can't keep up with at a high concurrency. The events
+// of the games only update counters, the summary is drawn by the thread which finds it due,
+// others don't wait for it. A timer keeps the summary going while no game ends.
+class Status : public IOutput {
+    using clock = std::chrono::steady_clock;
+
+   public:
+    static constexpr std::chrono::milliseconds REFRESH = std::chrono::milliseconds(250);
+    // without a terminal the summary can't be redrawn, it is printed again
+    static constexpr std::chrono::seconds PLAIN_REFRESH = std::chrono::seconds(10);
+    // the games per second are taken over this window
+    static constexpr std::chrono::seconds RATE_WINDOW = std::chrono::seconds(10);
+
+    Status(bool report_penta = true, bool games = false, std::ostream& out = std::cout)
+        : report_penta_(report_penta), games_(games), out_(out), terminal_(&out == &std::cout && isTerminal()) {
+        timer_ = std::thread([this]() {
+            std::unique_lock<std::mutex> lock(timer_mutex_);
+
+            while (!timer_cv_.wait_for(lock, terminal_ ? REFRESH : PLAIN_REFRESH, [this]() { return stop_; })) {
+                lock.unlock();
+                refresh();
+                lock.lock();
+            }
+        });
+
+        // the warnings of the games would be erased by the next redraw, they go above the summary
+        if (!terminal_) return;
+
+        Logger::setConsole([this](const std::string& message) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            pending_.push_back(message.substr(0, message.find_last_not_of('\n') + 1));
+        });
+    }
+
+    // the core map belongs to the tournament and may be gone already, the tables at the end of
+    // the tournament are below the summary which is printed again under them
+    ~Status() override {
+        {
+            std::lock_guard<std::mutex> lock(timer_mutex_);
+            stop_ = true;
+        }
+
+        timer_cv_.notify_all();
+        timer_.join();
+
+        if (terminal_) Logger::setConsole(nullptr);
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            core_map_ = nullptr;
+        }
+
+        draw(true);
+    }
+
+    void printInterval(const SPRT& sprt, const Stats& stats, const std::string& first, const std::string& second,
+                       const engines&, const std::string&) override {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            sprt_                   = sprt;
+            pairs_[{first, second}] = stats;
+        }
+
+        refresh();
+    }
+
+    void printResult(const Stats& stats, const std::string& first, const std::string& second) override {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            pairs_[{first, second}] = stats;
+        }
+
+        refresh();
+    }
+
+    std::string printElo(const Stats& stats, const std::string&, const std::string&, const engines&,
+                         const std::string&) override {
+        return formatElo(stats);
+    }
+
+    std::string printSprt(const SPRT& sprt, const Stats& stats) override {
+        if (!sprt.isEnabled()) return "";
+
+        const auto llr   = sprt.getLLR(stats, report_penta_);
+        const auto lower = sprt.getLowerBound();
+        const auto upper = sprt.getUpperBound();
+
+        std::string result;
+        if (llr >= upper) {
+            result = ", H1 accepted";
+        } else if (llr <= lower) {
+            result = ", H0 accepted";
+        }
+
+        const auto progress = llr < 0 ? llr / lower * 100 : llr / upper * 100;
+
+        return fmt::format("LLR: {:.2f} ({:.1f}%) [{:.2f}, {:.2f}]{}", llr, progress, lower, upper, result);
+    }
+
+    void startGame(const GamePair<EngineConfiguration, EngineConfiguration>&, std::size_t,
+                   std::size_t max_game_count) override {
+        started_.fetch_add(1, std::memory_order_relaxed);
+        total_.store(max_game_count, std::memory_order_relaxed);
+
+        refresh();
+    }
+
+    void endGame(const GamePair<EngineConfiguration, EngineConfiguration>& configs, const Stats& stats,
+                 const std::string& annotation, MatchTermination termination, std::size_t id) override {
+        finished_.fetch_add(1, std::memory_order_relaxed);
+
+        const auto timeout = termination == MatchTermination::TIMEOUT;
+        const auto crash   = termination == MatchTermination::DISCONNECT ||
+                           termination == MatchTermination::RESOURCE_LIMIT;
+
+        // the stats are the ones of white, a fault which ends in a draw isn't counted
+        const auto loser = stats.losses > 0 ? &configs.white.name : stats.wins > 0 ? &configs.black.name : nullptr;
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+
+            // every engine gets a line, also without a fault
+            faults_.try_emplace(configs.white.name);
+            faults_.try_emplace(configs.black.name);
+
+            if (loser && timeout) faults_[*loser].timeouts++;
+            if (loser && crash) faults_[*loser].crashes++;
+
+            if (games_) {
+                pending_.push_back(fmt::format("Finished game {} ({} vs {}): {} {{{}}}", id, configs.white.name,
+                                               configs.black.name, formatStats(stats), annotation));
+            }
+        }
+
+        refresh();
+    }
+
+    // the summary is drawn a last time when the output is destroyed
+    void endTournament() override {}
+
+    void setCoreMap(std::function<std::string()> core_map) override {
+        std::lock_guard<std::mutex> lock(mutex_);
+        core_map_ = std::move(core_map);
+    }
+
+    // The lines of the summary.
+    [[nodiscard]] std::vector<std::string> summary() {
+        const auto now      = clock::now();
+        const auto started  = started_.load(std::memory_order_relaxed);
+        const auto finished = finished_.load(std::memory_order_relaxed);
+        const auto total    = total_.load(std::memory_order_relaxed);
+
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        samples_.emplace_back(now, finished);
+        while (samples_.size() > 2 && now - samples_[1].first >= RATE_WINDOW) samples_.pop_front();
+
+        const auto window = std::chrono::duration<double>(now - samples_.front().first).count();
+        const auto rate   = window > 0 ? (finished - samples_.front().second) / window : 0.0;
+        const auto secs   = std::chrono::duration_cast<std::chrono::seconds>(now - begin_).count();
+
+        std::vector<std::string> lines;
+        lines.push_back(fmt::format("Games: {}{}, {:.1f}/s, {} running, {}:{:02}:{:02}", finished,
+                                    total > 0 ? fmt::format(" of {}", total) : "", rate, started - finished,
+                                    secs / 3600, secs / 60 % 60, secs % 60));
+
+        for (const auto& [pair, stats] : pairs_) {
+            if (stats.sum() == 0) continue;
+
+            const auto sprt = sprt_ ? printSprt(*sprt_, stats) : "";
+            lines.push_back(fmt::format("{} vs {}: {} - {} - {}, {}{}{}", pair.first, pair.second, stats.wins,
+                                        stats.losses, stats.draws, formatElo(stats), sprt.empty() ? "" : ", ", sprt));
+        }
+
+        for (const auto& [name, faults] : faults_) {
+            lines.push_back(fmt::format("{}: {} crashes, {} timeouts", name, faults.crashes, faults.timeouts));
+        }
+
+        const auto cores = core_map_ ? core_map_() : "";
+        if (!cores.empty()) lines.push_back("Cores: " + cores);
+
+        return lines;
+    }
+
+   private:
+    struct Faults {
+        int crashes  = 0;
+        int timeouts = 0;
+    };
+
+    [[nodiscard]] std::string formatElo(const Stats& stats) const {
+        std::unique_ptr<elo::EloBase> elo;
+
+        if (report_penta_) {
+            elo = std::make_unique<elo::EloPentanomial>(stats);
+        } else {
+            elo = std::make_unique<elo::EloWDL>(stats);
+        }
+
+        return fmt::format("Elo: {}, nElo: {}", elo->getElo(), elo->nElo());
+    }
+
+    static bool isTerminal() {
+#ifdef _WIN32
+        // the console may not understand the escape sequences
+        return false;
+#else
+        return isatty(fileno(stdout));
+#endif
+    }
+
+    void refresh() {
+        const auto now = clock::now().time_since_epoch().count();
+        const auto due = std::chrono::duration_cast<clock::duration>(terminal_ ? REFRESH : PLAIN_REFRESH).count();
+        auto last      = last_draw_.load(std::memory_order_relaxed);
+
+        if (now - last < due) return;
+        if (!last_draw_.compare_exchange_strong(last, now, std::memory_order_relaxed)) return;
+
+        draw(false);
+    }
+
+    // Draws over the previous summary, the games which finished and the warnings since then are
+    // printed above it.
+    // The last one waits for a running draw and keeps the text above.
+    void draw(bool last) {
+        std::unique_lock<std::mutex> lock(draw_mutex_, std::defer_lock);
+
+        if (last) {
+            lock.lock();
+        } else if (!lock.try_lock()) {
+            return;
+        }
+
+        const auto lines = summary();
+
+        std::vector<std::string> games;
+        {
+            std::lock_guard<std::mutex> state(mutex_);
+            games.swap(pending_);
+        }
+
+        std::string text;
+        if (terminal_ && drawn_ > 0 && !last) text += fmt::format("\x1b[{}F\x1b[J", drawn_);
+
+        for (const auto& line : games) text += line + '\n';
+        for (const auto& line : lines) text += line + '\n';
+
+        drawn_ = lines.size();
+
+        out_ << text << std::flush;
+    }
+
+    bool report_penta_;
+    bool games_;
+    std::ostream& out_;
+    bool terminal_;
+
+    std::atomic<std::size_t> started_  = 0;
+    std::atomic<std::size_t> finished_ = 0;
+    std::atomic<std::size_t> total_    = 0;
+    std::atomic<clock::rep> last_draw_ = 0;
+
+    const clock::time_point begin_ = clock::now();
+
+    // guards everything below
+    std::mutex mutex_;
+    std::optional<SPRT> sprt_;
+    std::map<std::pair<std::string, std::string>, Stats> pairs_;
+    std::map<std::string, Faults> faults_;
+    std::vector<std::string> pending_;
+    std::deque<std::pair<clock::time_point, std::size_t>> samples_;
+    std::function<std::string()> core_map_;
+
+    // held while the summary is drawn
+    std::mutex draw_mutex_;
+    std::size_t drawn_ = 0;
+
+    // redraws the summary between the events of the games, stopped by the destructor
+    std::thread timer_;
+    std::mutex timer_mutex_;
+    std::condition_variable timer_cv_;
+    bool stop_ = false;
+};
+
+}  // namespace fastchess
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <chrono>
+#include <optional>
 
 #include <engine/uci_engine.hpp>
 
@@ -40,6 +41,12 @@ class Player {
 
     chess::Color color = chess::Color::NONE;
 
+    // accounting of the engine's sandbox when the game started
+    std::optional<engine::process::CgroupUsage> usage_start;
+
+    // accounting of the engine process when the game started
+    std::optional<engine::process::Rusage> rusage_start;
+
    private:
     chess::GameResult result = chess::GameResult::NONE;
     TimeControl time_control_;
@@ -1,7 +1,10 @@
 #pragma once
 
+#include <algorithm>
+#include <map>
 #include <mutex>
 #include <string>
+#include <tuple>
 #include <unordered_map>
 #include <utility>
 
@@ -102,8 +105,12 @@ class ScoreBoard {
                     uint64_t round_id) {
         std::lock_guard<std::mutex> lock(game_pair_cache_mutex_);
 
-        const auto is_first_game = game_pair_cache_.find(round_id) == game_pair_cache_.end();
-        auto& lookup             = game_pair_cache_[round_id];
+        // several pairs play the same round when there are more than two engines
+        const auto key = std::make_tuple(std::min(configs.white.name, configs.black.name),
+                                         std::max(configs.white.name, configs.black.name), round_id);
+
+        const auto is_first_game = game_pair_cache_.find(key) == game_pair_cache_.end();
+        auto& lookup             = game_pair_cache_[key];
 
         if (is_first_game) {
             // invert because other player
@@ -122,7 +129,7 @@ class ScoreBoard {
 
         updateNonPair(configs, lookup);
 
-        game_pair_cache_.erase(round_id);
+        game_pair_cache_.erase(key);
 
         return true;
     }
@@ -152,7 +159,7 @@ class ScoreBoard {
     StatsMap results_;
     std::mutex results_mutex_;
 
-    std::unordered_map<uint64_t, Stats> game_pair_cache_;
+    std::map<std::tuple<std::string, std::string, uint64_t>, Stats> game_pair_cache_;
     std::mutex game_pair_cache_mutex_;
 };
 
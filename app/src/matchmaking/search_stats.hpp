@@ -0,0 +1,312 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <map>
+#include <mutex>
+#include <string>
+#include <string_view>
+
+#include <chess.hpp>
+#include <types/match_data.hpp>
+#include <util/logger/logger.hpp>
+
+namespace fastchess {
+
+enum class GamePhase { OPENING, MIDDLEGAME, ENDGAME };
+
+inline constexpr std::size_t GAME_PHASES = 3;
+
+[[nodiscard]] inline std::string_view gamePhaseName(GamePhase phase) noexcept {
+    switch (phase) {
+        case GamePhase::OPENING:
+            return "opening";
+        case GamePhase::MIDDLEGAME:
+            return "middlegame";
+        case GamePhase::ENDGAME:
+            return "endgame";
+    }
+
+    return "";
+}
+
+// Mean and standard deviation of a series, updated one value at a time.
+class RunningStats {
+   public:
+    void add(double value) noexcept {
+        count_++;
+
+        const auto delta = value - mean_;
+        mean_ += delta / count_;
+        m2_ += delta * (value - mean_);
+    }
+
+    void merge(const RunningStats &other) noexcept {
+        if (other.count_ == 0) return;
+
+        const auto count = count_ + other.count_;
+        const auto delta = other.mean_ - mean_;
+
+        m2_ += other.m2_ + delta * delta * count_ * other.count_ / count;
+        mean_ += delta * other.count_ / count;
+        count_ = count;
+    }
+
+    [[nodiscard]] std::uint64_t count() const noexcept { return count_; }
+    [[nodiscard]] double mean() const noexcept { return mean_; }
+    [[nodiscard]] double stddev() const noexcept { return count_ > 1 ? std::sqrt(m2_ / (count_ - 1)) : 0.0; }
+
+   private:
+    std::uint64_t count_ = 0;
+    double mean_         = 0.0;
+    double m2_           = 0.0;
+};
+
+// The searches of an engine over its games. Moves from the book are left out, the share of
+// the clock only counts moves which were played with one.
+struct SearchStats {
+    // upper bounds of the move numbers the time usage curve is grouped by
+    static constexpr std::array<int, 6> MOVE_BUCKETS = {10, 20, 30, 40, 60, std::numeric_limits<int>::max()};
+
+    // upper bounds of the share of the clock a search used, the depth is grouped by
+    static constexpr std::array<double, 5> USAGE_BUCKETS = {0.01, 0.02, 0.04, 0.08,
+                                                            std::numeric_limits<double>::infinity()};
+
+    struct Phase {
+        RunningStats millis;
+        RunningStats depth;
+        // share of the clock the search used
+        RunningStats usage;
+    };
+
+    std::uint64_t games = 0;
+
+    RunningStats nps;
+    std::array<Phase, GAME_PHASES> phases                         = {};
+    std::array<RunningStats, MOVE_BUCKETS.size()> usage_by_move   = {};
+    std::array<RunningStats, USAGE_BUCKETS.size()> depth_by_usage = {};
+
+    // clock after the last search of a game, in milliseconds and as a share of the clock of
+    // the first one
+    RunningStats clock_left;
+    RunningStats clock_left_share;
+
+    void merge(const SearchStats &other) noexcept {
+        games += other.games;
+        nps.merge(other.nps);
+
+        for (std::size_t i = 0; i < GAME_PHASES; i++) {
+            phases[i].millis.merge(other.phases[i].millis);
+            phases[i].depth.merge(other.phases[i].depth);
+            phases[i].usage.merge(other.phases[i].usage);
+        }
+
+        for (std::size_t i = 0; i < usage_by_move.size(); i++) usage_by_move[i].merge(other.usage_by_move[i]);
+        for (std::size_t i = 0; i < depth_by_usage.size(); i++) depth_by_usage[i].merge(other.depth_by_usage[i]);
+
+        clock_left.merge(other.clock_left);
+        clock_left_share.merge(other.clock_left_share);
+    }
+
+    [[nodiscard]] std::uint64_t moves() const noexcept {
+        std::uint64_t moves = 0;
+        for (const auto &phase : phases) moves += phase.millis.count();
+        return moves;
+    }
+};
+
+// Collects the search statistics of the engines from the moves of the finished games.
+class SearchBoard {
+   public:
+    // plies from the start position after which the opening is over
+    static constexpr int OPENING_PLIES = 20;
+
+    // non pawn material of both sides at which the endgame begins, a minor piece counts 3,
+    // a rook 5 and a queen 9, which is 62 in the start position
+    static constexpr int ENDGAME_MATERIAL = 26;
+
+    [[nodiscard]] static GamePhase phaseOf(const chess::Board &board, int ply) {
+        using chess::PieceType;
+
+        const auto material = 3 * (board.pieces(PieceType::KNIGHT).count() + board.pieces(PieceType::BISHOP).count()) +
+                              5 * board.pieces(PieceType::ROOK).count() + 9 * board.pieces(PieceType::QUEEN).count();
+
+        if (material <= ENDGAME_MATERIAL) return GamePhase::ENDGAME;
+        return ply < OPENING_PLIES ? GamePhase::OPENING : GamePhase::MIDDLEGAME;
+    }
+
+    // Adds the searches of both engines, the moves are replayed to find the phase of the game.
+    void add(const MatchData &data) {
+        GamePair<SearchStats, SearchStats> game;
+        GamePair<int64_t, int64_t> first_clock = {0, 0};
+        GamePair<int64_t, int64_t> last_clock  = {-1, -1};
+
+        chess::Board board;
+        board.set960(data.variant == VariantType::FRC);
+        board.setFen(data.fen);
+
+        const auto tc_of = [&data](chess::Color color) -> const auto & {
+            return color == chess::Color::WHITE ? data.players.white.config.limit.tc
+                                                : data.players.black.config.limit.tc;
+        };
+
+        for (std::size_t i = 0; i < data.moves.size(); i++) {
+            const auto &move = data.moves[i];
+            const auto color = board.sideToMove();
+            auto &stats      = color == chess::Color::WHITE ? game.white : game.black;
+
+            if (!move.book) {
+                auto &phase = stats.phases[static_cast<std::size_t>(phaseOf(board, static_cast<int>(i)))];
+
+                phase.millis.add(static_cast<double>(move.elapsed_millis));
+                if (move.depth > 0) phase.depth.add(move.depth);
+
+                // engines which don't send nps get it from their nodes
+                if (move.nps > 0) {
+                    stats.nps.add(move.nps);
+                } else if (move.nodes > 0 && move.elapsed_millis > 0) {
+                    stats.nps.add(move.nodes * 1000.0 / move.elapsed_millis);
+                }
+
+                // a fixed time per move uses no clock
+                if (move.clock_millis > 0 && tc_of(color).fixed_time == 0) {
+                    const auto usage = double(move.elapsed_millis) / move.clock_millis;
+
+                    phase.usage.add(usage);
+                    const auto number = static_cast<int>(board.fullMoveNumber());
+
+                    stats.usage_by_move[bucket(SearchStats::MOVE_BUCKETS, number)].add(usage);
+                    if (move.depth > 0) stats.depth_by_usage[bucket(SearchStats::USAGE_BUCKETS, usage)].add(move.depth);
+
+                    auto &first = color == chess::Color::WHITE ? first_clock.white : first_clock.black;
+                    auto &last  = color == chess::Color::WHITE ? last_clock.white : last_clock.black;
+
+                    if (first == 0) first = move.clock_millis;
+                    last = std::max<int64_t>(0, move.clock_millis - move.elapsed_millis);
+                }
+            }
+
+            // the game ended with this move if it was illegal
+            const auto parsed = chess::uci::uciToMove(board, move.move);
+            if (!move.legal || parsed == chess::Move::NO_MOVE) break;
+
+            board.makeMove(parsed);
+        }
+
+        game.white.games = game.black.games = 1;
+
+        for (const auto color : {chess::Color::WHITE, chess::Color::BLACK}) {
+            auto &stats      = color == chess::Color::WHITE ? game.white : game.black;
+            const auto first = color == chess::Color::WHITE ? first_clock.white : first_clock.black;
+            const auto last  = color == chess::Color::WHITE ? last_clock.white : last_clock.black;
+
+            if (last < 0) continue;
+
+            stats.clock_left.add(static_cast<double>(last));
+            stats.clock_left_share.add(double(last) / first);
+        }
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        engines_[data.players.white.config.name].merge(game.white);
+        engines_[data.players.black.config.name].merge(game.black);
+    }
+
+    [[nodiscard]] std::map<std::string, SearchStats> get() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return engines_;
+    }
+
+    // A line per engine, for the rating interval.
+    void printSummary() const {
+        for (const auto &[name, stats] : get()) {
+            if (stats.nps.count() == 0) continue;
+
+            Logger::info("Search of {}: {:.2f} Mnps +/- {:.1f}%, depth {:.1f}, {:.1f}% of the clock per move, {:.2f}s "
+                         "left at the end",
+                         name, stats.nps.mean() / 1e6, relative(stats.nps), depth(stats), usage(stats) * 100,
+                         stats.clock_left.mean() / 1000);
+        }
+    }
+
+    // Tables of the searches per engine, by game phase, by move number and by share of the clock.
+    void print() const {
+        const auto engines = get();
+
+        if (std::none_of(engines.begin(), engines.end(), [](const auto &e) { return e.second.moves() > 0; })) return;
+
+        Logger::info("{:<30} {:>7} {:>9} {:>7} {:>7} {:>11} {:>7}", "Search statistics", "Moves", "Mnps", "+/-",
+                     "Depth", "Clock left", "Share");
+
+        for (const auto &[name, stats] : engines) {
+            Logger::info("{:<30} {:>7} {:>9.3f} {:>6.1f}% {:>7.1f} {:>10.2f}s {:>6.1f}%", name, stats.moves(),
+                         stats.nps.mean() / 1e6, relative(stats.nps), depth(stats), stats.clock_left.mean() / 1000,
+                         stats.clock_left_share.mean() * 100);
+        }
+
+        Logger::info("{:<30} {:>23} {:>23} {:>23}", "Per phase (ms/depth/% clock)", "opening", "middlegame", "endgame");
+
+        for (const auto &[name, stats] : engines) {
+            std::array<std::string, GAME_PHASES> cells;
+
+            for (std::size_t i = 0; i < GAME_PHASES; i++) {
+                const auto &phase = stats.phases[i];
+                cells[i] = fmt::format("{:.0f} / {:.1f} / {:.1f}%", phase.millis.mean(), phase.depth.mean(),
+                                       phase.usage.mean() * 100);
+            }
+
+            Logger::info("{:<30} {:>23} {:>23} {:>23}", name, cells[0], cells[1], cells[2]);
+        }
+
+        Logger::info("{:<30} {:>7} {:>7} {:>7} {:>7} {:>7} {:>7}", "% of clock by move number", "1-10", "11-20",
+                     "21-30", "31-40", "41-60", "61+");
+
+        for (const auto &[name, stats] : engines) {
+            const auto &u = stats.usage_by_move;
+            Logger::info("{:<30} {:>7.2f} {:>7.2f} {:>7.2f} {:>7.2f} {:>7.2f} {:>7.2f}", name, u[0].mean() * 100,
+                         u[1].mean() * 100, u[2].mean() * 100, u[3].mean() * 100, u[4].mean() * 100,
+                         u[5].mean() * 100);
+        }
+
+        Logger::info("{:<30} {:>7} {:>7} {:>7} {:>7} {:>7}", "Depth by % of clock used", "<1", "1-2", "2-4", "4-8",
+                     "8+");
+
+        for (const auto &[name, stats] : engines) {
+            const auto &d = stats.depth_by_usage;
+            Logger::info("{:<30} {:>7.1f} {:>7.1f} {:>7.1f} {:>7.1f} {:>7.1f}", name, d[0].mean(), d[1].mean(),
+                         d[2].mean(), d[3].mean(), d[4].mean());
+        }
+    }
+
+   private:
+    // index of the first upper bound which holds the value
+    template <typename T, std::size_t N, typename U>
+    static std::size_t bucket(const std::array<T, N> &bounds, U value) noexcept {
+        const auto it = std::find_if(bounds.begin(), bounds.end(), [value](T bound) { return value <= bound; });
+        return std::min<std::size_t>(it - bounds.begin(), N - 1);
+    }
+
+    // standard deviation in percent of the mean
+    static double relative(const RunningStats &stats) noexcept {
+        return stats.mean() > 0 ? stats.stddev() / stats.mean() * 100 : 0.0;
+    }
+
+    static double depth(const SearchStats &stats) noexcept {
+        RunningStats depth;
+        for (const auto &phase : stats.phases) depth.merge(phase.depth);
+        return depth.mean();
+    }
+
+    static double usage(const SearchStats &stats) noexcept {
+        RunningStats usage;
+        for (const auto &phase : stats.phases) usage.merge(phase.usage);
+        return usage.mean();
+    }
+
+    std::map<std::string, SearchStats> engines_;
+    mutable std::mutex mutex_;
+};
+
+}  // namespace fastchess
@@ -145,6 +145,11 @@ SPRTResult SPRT::getResult(double llr) const noexcept {
         return SPRT_CONTINUE;
 }
 
+const char* SPRT::describe(SPRTResult result) noexcept {
+    // SPRT_H0 is returned when the upper bound was reached
+    return result == SPRT_H0 ? "H1 was accepted" : result == SPRT_H1 ? "H0 was accepted" : "no decision yet";
+}
+
 std::string SPRT::getBounds() const noexcept {
     std::stringstream ss;
     ss << "(" << std::fixed << std::setprecision(2) << lower_ << ", " << std::fixed << std::setprecision(2) << upper_
@@ -26,6 +26,8 @@ class SPRT {
                                 int penta_LL) const noexcept;
 
     [[nodiscard]] SPRTResult getResult(double llr) const noexcept;
+    // The decision of the result as text, for the summary at the end of a test.
+    [[nodiscard]] static const char* describe(SPRTResult result) noexcept;
     [[nodiscard]] std::string getBounds() const noexcept;
     [[nodiscard]] std::string getElo() const noexcept;
     [[nodiscard]] double getLowerBound() const noexcept;
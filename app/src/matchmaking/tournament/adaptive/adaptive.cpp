@@ -0,0 +1,179 @@
+#include <matchmaking/tournament/adaptive/adaptive.hpp>
+
+#include <map>
+#include <optional>
+#include <string>
+#include <utility>
+
+#include <util/logger/logger.hpp>
+
+namespace fastchess {
+
+AdaptiveRoundRobin::AdaptiveRoundRobin(const config::Tournament& config,
+                                       const std::vector<EngineConfiguration>& engine_configs,
+                                       const stats_map& results, daemon::Resources* resources)
+    : RoundRobin(config, engine_configs, results, resources), ratings_(engine_configs.size()) {}
+
+void AdaptiveRoundRobin::start() {
+    Logger::trace("Starting adaptive round robin...");
+
+    RoundRobin::start();
+
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    // the round robin prints the ranking after the last game
+    if (match_count_ < total_) {
+        update();
+        printRatings(ratings_);
+    }
+}
+
+void AdaptiveRoundRobin::create() {
+    Logger::trace("Creating matches...");
+
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    pairs_ = pairs();
+
+    // at most as many games as the full round robin
+    total_ = pairs_.size() * config_.rounds * config_.games;
+
+    replayJournal();
+
+    next_round_.assign(pairs_.size(), 0);
+    queued_.assign(pairs_.size(), 0);
+
+    // rounds of a previous run keep their ids
+    std::map<std::pair<std::string, std::string>, std::size_t> index;
+    for (std::size_t p = 0; p < pairs_.size(); p++) {
+        const auto& first  = engine_configs_[pairs_[p].first].name;
+        const auto& second = engine_configs_[pairs_[p].second].name;
+
+        index[{first, second}] = p;
+        index[{second, first}] = p;
+    }
+
+    // games and opening of the rounds of a previous run, for each pair and round id
+    std::map<std::pair<std::size_t, std::size_t>, std::pair<int, std::optional<std::size_t>>> rounds;
+
+    if (journal_) {
+        for (const auto& entry : journal_->entries()) {
+            const auto it = index.find({entry.white, entry.black});
+            if (it == index.end()) continue;
+
+            next_round_[it->second] = std::max(next_round_[it->second], entry.round_id + 1);
+
+            auto& [games, opening] = rounds[{it->second, entry.round_id}];
+            games++;
+            if (entry.opening >= 0) opening = static_cast<std::size_t>(entry.opening);
+        }
+    }
+
+    scheduled_ = match_count_;
+
+    // the missing games of half finished rounds are played first, otherwise the games
+    // left over wouldn't make up a round and the tournament could never reach its total
+    for (const auto& [key, round] : rounds) {
+        const auto& [p, round_id]    = key;
+        const auto& [games, opening] = round;
+
+        if (games >= config_.games) continue;
+
+        queued_[p] += config_.games - games;
+        scheduled_ += config_.games - games;
+
+        // the games which were played are skipped
+        for (int g = 0; g < config_.games; g++) {
+            queueGame({pairs_[p].first, pairs_[p].second, p, round_id, g, opening});
+        }
+    }
+
+    // every pair plays once before the games go to the largest error bars
+    for (std::size_t p = 0; p < pairs_.size(); p++) {
+        const auto& first  = engine_configs_[pairs_[p].first].name;
+        const auto& second = engine_configs_[pairs_[p].second].name;
+
+        if (scoreboard_.getStats(first, second).sum() == 0 && scheduled_ + config_.games <= total_) schedule(p);
+    }
+
+    update();
+    fill();
+}
+
+void AdaptiveRoundRobin::gameFinished(std::size_t pair, bool round_complete) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    queued_[pair]--;
+
+    // the pentanomial stats only change once both games of a round finished
+    if (!round_complete || stopped()) return;
+
+    update();
+
+    if (std::get<2>(widestGap()) <= config_.errorbar) {
+        Logger::info("All adjacent engines are separated by less than +/- {:.2f} Elo.", config_.errorbar);
+        stop();
+        return;
+    }
+
+    fill();
+}
+
+void AdaptiveRoundRobin::schedule(std::size_t pair) {
+    const auto round_id = next_round_[pair]++;
+
+    // both players get the same opening
+    const auto opening = book_->fetchId();
+
+    queued_[pair] += config_.games;
+    scheduled_ += config_.games;
+
+    for (int g = 0; g < config_.games; g++) {
+        queueGame({pairs_[pair].first, pairs_[pair].second, pair, round_id, g, opening});
+    }
+}
+
+void AdaptiveRoundRobin::fill() {
+    // the queued games will shrink the error bars too
+    for (std::size_t p = 0; p < pairs_.size(); p++) {
+        if (queued_[p] > 0) ratings_.addGames(pairs_[p].first, pairs_[p].second, queued_[p]);
+    }
+
+    while (pool_.queueSize() < static_cast<std::size_t>(config_.concurrency) &&
+           scheduled_ + config_.games <= total_) {
+        const auto [first, second, error] = widestGap();
+
+        std::size_t best = 0;
+        double most      = -1.0;
+
+        for (std::size_t p = 0; p < pairs_.size(); p++) {
+            const auto reduction =
+                ratings_.reduction(first, second, pairs_[p].first, pairs_[p].second, config_.games);
+
+            if (reduction > most) {
+                best = p;
+                most = reduction;
+            }
+        }
+
+        schedule(best);
+        ratings_.addGames(pairs_[best].first, pairs_[best].second, config_.games);
+    }
+}
+
+void AdaptiveRoundRobin::update() { loadRatings(ratings_); }
+
+std::tuple<std::size_t, std::size_t, double> AdaptiveRoundRobin::widestGap() const {
+    const auto ranking = ratings_.ranking();
+
+    std::tuple<std::size_t, std::size_t, double> widest = {0, 0, 0.0};
+
+    for (std::size_t k = 0; k + 1 < ranking.size(); k++) {
+        const auto error = ratings_.error(ranking[k], ranking[k + 1]);
+        if (error > std::get<2>(widest)) widest = {ranking[k], ranking[k + 1], error};
+    }
+
+    return widest;
+}
+
+}  // namespace fastchess
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstdint>
+#include <mutex>
+#include <tuple>
+#include <vector>
+
+#include <elo/ratings.hpp>
+#include <matchmaking/tournament/roundrobin/roundrobin.hpp>
+
+namespace fastchess {
+
+// Round robin which doesn't give every pair the same number of games. After every pair
+// played one round, the next rounds go to the pairs which shrink the largest error bar
+// between two engines adjacent in the ranking the most. The tournament ends once all of
+// these error bars are below the target or the games of the full round robin are played.
+class AdaptiveRoundRobin : public RoundRobin {
+   public:
+    AdaptiveRoundRobin(const config::Tournament& config, const std::vector<EngineConfiguration>& engine_configs,
+                       const stats_map& results, daemon::Resources* resources = nullptr);
+
+    ~AdaptiveRoundRobin() { Logger::trace("~AdaptiveRoundRobin()"); }
+
+    void start() override;
+
+   protected:
+    void create() override;
+
+    void gameFinished(std::size_t pair, bool round_complete) override;
+
+   private:
+    // Queues the next round of the pair.
+    void schedule(std::size_t pair);
+
+    // Queues rounds until every slot has a game waiting.
+    void fill();
+
+    // Solves the ratings from the scoreboard, the queued games are not included.
+    void update();
+
+    // Engines adjacent in the ranking with the largest error bar between them.
+    [[nodiscard]] std::tuple<std::size_t, std::size_t, double> widestGap() const;
+
+    std::mutex mutex_;
+
+    elo::Ratings ratings_;
+
+    // round id of the next round and games which are queued or running, for each pair
+    std::vector<std::size_t> next_round_;
+    std::vector<int> queued_;
+
+    // games queued so far, including the ones of a previous run
+    std::uint64_t scheduled_ = 0;
+};
+
+}  // namespace fastchess
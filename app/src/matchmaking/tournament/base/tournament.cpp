@@ -1,7 +1,11 @@
 #include <matchmaking/tournament/base/tournament.hpp>
 
+#include <chrono>
+
+#include <affinity/affinity.hpp>
 #include <affinity/affinity_manager.hpp>
 #include <book/opening_book.hpp>
+#include <data/data_builder.hpp>
 #include <engine/uci_engine.hpp>
 #include <epd/epd_builder.hpp>
 #include <matchmaking/match/match.hpp>
@@ -13,24 +17,66 @@
 #include <util/cache.hpp>
 #include <util/file_writer.hpp>
 #include <util/logger/logger.hpp>
+#include <util/scheduling.hpp>
 #include <util/threadpool.hpp>
+#include <util/tracer/tracer.hpp>
 
 namespace fastchess {
 
-BaseTournament::BaseTournament(const stats_map &results) {
-    const auto &config = config::TournamentConfig.get();
+BaseTournament::BaseTournament(const config::Tournament &config,
+                               const std::vector<EngineConfiguration> &engine_configs, const stats_map &results,
+                               daemon::Resources *resources)
+    : config_(config), engine_configs_(engine_configs), resources_(resources), metrics_(engine_configs) {
+    output_ = OutputFactory::create(config.output, config.report_penta, config.output_file, config.output_games);
+
+    // with dedicated cores each engine of a game gets its own set
+    const auto dedicated = config.affinity_policy == AffinityPolicy::DEDICATED;
+    const auto threads   = getMaxAffinity(engine_configs) * (dedicated ? 2 : 1);
+
+    cores_ = std::make_unique<affinity::AffinityManager>(config.affinity && !resources_, threads, config.concurrency);
 
-    output_ = OutputFactory::create(config.output, config.report_penta);
-    cores_  = std::make_unique<affinity::AffinityManager>(config.affinity, getMaxAffinity(config::EngineConfigs.get()));
+    // shared cores are only used by single threaded engines, like a tournament's own ones
+    affinity_ = resources_ && threads == 1 ? resources_->cores.get() : cores_.get();
+
+    output_->setCoreMap([this]() { return affinity_->map(); });
 
     if (!config.pgn.file.empty()) file_writer_pgn = std::make_unique<util::FileWriter>(config.pgn.file);
     if (!config.epd.file.empty()) file_writer_epd = std::make_unique<util::FileWriter>(config.epd.file);
+    if (!config.dataout.file.empty()) file_writer_data = std::make_unique<util::FileWriter>(config.dataout.file);
+
+    if (resources_) {
+        resources_->scheduler.add(this, config.weight);
+
+        // more threads than slots would only wait for the scheduler
+        pool_.resize(std::min(config.concurrency, resources_->scheduler.slots()));
+    } else {
+        pool_.resize(config.concurrency);
+        engine_cache_.setCapacity(std::max(config.maxengines, 2 * config.concurrency));
+
+        if (config.autoconcurrency) concurrency_ = std::make_unique<ConcurrencyController>(config.concurrency);
+    }
+
+    if (!config.journal.file.empty()) {
+        journal_ = std::make_unique<Journal>(config.journal.file, config.journal.sync_interval, config.seed);
+
+        // the journal is the only source of the results, games are replayed from it
+        if (!results.empty()) Logger::info("Ignoring the stats of the config file, using the journal instead.");
+        setResults({});
+    } else {
+        // the rounds of a shard are not contiguous, so they can't be skipped based on the game count
+        if (config.shard.total > 1 && !results.empty()) {
+            throw std::runtime_error("Error; A sharded tournament can only be resumed with -journal.");
+        }
 
-    pool_.resize(config.concurrency);
+        setResults(results);
+    }
 
-    setResults(results);
+    book_ = std::make_unique<book::OpeningBook>(config, initial_matchcount_, resources_ ? &resources_->books : nullptr);
 
-    book_ = std::make_unique<book::OpeningBook>(config, initial_matchcount_);
+    if (config.metrics.port > 0 || !config.metrics.file.empty()) {
+        exporter_ = std::make_unique<MetricsExporter>(
+            config.metrics, [this]() { return metrics_.render(process_list.size()); });
+    }
 }
 
 void BaseTournament::start() {
@@ -42,13 +88,11 @@ void BaseTournament::start() {
 void BaseTournament::saveJson() {
     Logger::trace("Saving results...");
 
-    const auto &config = config::TournamentConfig.get();
-
-    nlohmann::ordered_json jsonfile = config;
-    jsonfile["engines"]             = config::EngineConfigs.get();
+    nlohmann::ordered_json jsonfile = config_;
+    jsonfile["engines"]             = engine_configs_;
     jsonfile["stats"]               = getResults();
 
-    auto filename = config.config_name.empty() ? "config.json" : config.config_name;
+    auto filename = config_.config_name.empty() ? "config.json" : config_.config_name;
 
     std::ofstream file(filename);
     file << std::setw(4) << jsonfile << std::endl;
@@ -59,16 +103,37 @@ void BaseTournament::saveJson() {
 void BaseTournament::playGame(const GamePair<EngineConfiguration, EngineConfiguration> &engine_configs,
                               start_callback start, finished_callback finish, const pgn::Opening &opening,
                               std::size_t round_id, std::size_t game_id) {
-    if (atomic::stop) return;
+    if (stopped()) return;
+
+    const auto waiting = Tracer::clock::now();
+
+    // the slots of a daemon are shared fairly between its tournaments
+    std::optional<daemon::SlotScheduler::Slot> slot;
+    if (resources_) {
+        slot = resources_->scheduler.acquire(this, [this]() { return stopped(); });
+        if (!slot) return;
+    }
+
+    std::optional<ConcurrencyController::Slot> active;
+    if (concurrency_) {
+        active = concurrency_->acquire([this]() { return stopped(); });
+        if (!active) return;
+    }
+
+    if (resources_ || concurrency_) Tracer::complete("wait for slot", "tournament", waiting, Tracer::clock::now());
+
+    const auto core = util::ScopeGuard(affinity_->consume());
+
+    // the thread running the game shares the L3 cache of its engines
+    affinity::setThreadAffinity(core.get().domain);
 
-    const auto &config = config::TournamentConfig.get();
-    const auto core    = util::ScopeGuard(cores_->consume());
+    const scheduling::ArbiterPriority arbiter(engine_configs.white.scheduling, engine_configs.black.scheduling);
 
     const auto white_name = engine_configs.white.name;
     const auto black_name = engine_configs.black.name;
 
-    auto &white_engine = engine_cache_.getEntry(white_name, engine_configs.white, config.log.realtime);
-    auto &black_engine = engine_cache_.getEntry(black_name, engine_configs.black, config.log.realtime);
+    auto &white_engine = getEngine(engine_configs.white);
+    auto &black_engine = getEngine(engine_configs.black);
 
     util::ScopeGuard lock1(white_engine);
     util::ScopeGuard lock2(black_engine);
@@ -77,15 +142,57 @@ void BaseTournament::playGame(const GamePair<EngineConfiguration, EngineConfigur
 
     start();
 
-    auto match = Match(opening);
-    match.start(white_engine.get(), black_engine.get(), core.get().cpus);
+    const auto cpu_time = [&]() -> std::optional<std::chrono::milliseconds> {
+        const auto white = white_engine.get().cpuTime();
+        const auto black = black_engine.get().cpuTime();
+        if (!white || !black) return std::nullopt;
+        return *white + *black;
+    };
+
+    const auto cpu_before = concurrency_ ? cpu_time() : std::nullopt;
+    const auto begin      = std::chrono::steady_clock::now();
+
+    auto match = Match(config_, opening, stop_);
+
+    {
+        Tracer::Span span("game", "tournament");
+        span.arg("game", game_id);
+        span.arg("round", round_id + 1);
+        span.arg("white", white_name);
+        span.arg("black", black_name);
+        span.arg("cpus", core.get().cpus);
+
+        metrics_.gameStarted();
+        match.start(white_engine.get(), black_engine.get(), core.get().cpus);
+        metrics_.gameEnded();
+    }
 
     Logger::trace<true>("Game {} between {} and {} finished", game_id, white_name, black_name);
 
+    latency_.add(match.latency());
+    metrics_.add(match.latency());
+
+    if (concurrency_ && !match.isCrashOrDisconnect() && match.get().termination != MatchTermination::INTERRUPT) {
+        const auto &data = match.get();
+
+        GameLoad load;
+        load.timeout = data.termination == MatchTermination::TIMEOUT;
+
+        for (const auto &move : data.moves) load.thinking += std::chrono::milliseconds(move.elapsed_millis);
+
+        const auto cpu_after = cpu_time();
+        if (cpu_before && cpu_after) load.cpu = *cpu_after - *cpu_before;
+
+        const auto wall = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin);
+        load.overhead   = (wall.count() - load.thinking.count()) / std::max<std::size_t>(1, data.moves.size());
+
+        concurrency_->report(load);
+    }
+
     if (match.isCrashOrDisconnect()) {
         Logger::trace<true>("Game {} between {} and {} crashed / disconnected", game_id, white_name, black_name);
-        if (!config.recover) {
-            atomic::stop = true;
+        if (!config_.recover) {
+            stop();
             return;
         }
 
@@ -103,45 +210,67 @@ void BaseTournament::playGame(const GamePair<EngineConfiguration, EngineConfigur
         }
     }
 
-    const auto match_data = match.get();
+    finishGame(match.get(), finish, {white_engine.get(), black_engine.get()}, round_id, game_id);
+}
 
+void BaseTournament::finishGame(const MatchData &match_data, const finished_callback &finish, const engines &engines,
+                                std::size_t round_id, std::size_t game_id) {
     // If the game was interrupted(didn't completely finish)
-    if (match_data.termination != MatchTermination::INTERRUPT && !atomic::stop) {
-        if (!config.pgn.file.empty()) {
-            file_writer_pgn->write(pgn::PgnBuilder(config.pgn, match_data, round_id + 1).get());
+    if (match_data.termination != MatchTermination::INTERRUPT && !stopped()) {
+        if (!config_.pgn.file.empty()) {
+            Tracer::Span span("write pgn", "tournament");
+            span.arg("game", game_id);
+
+            file_writer_pgn->write(pgn::PgnBuilder(config_.pgn, match_data, round_id + 1).get());
         }
 
-        if (!config.epd.file.empty()) {
-            file_writer_epd->write(epd::EpdBuilder(config.variant, match_data).get());
+        if (!config_.epd.file.empty()) {
+            file_writer_epd->write(epd::EpdBuilder(config_.variant, match_data).get());
         }
 
+        // positions of crashed games would be labeled with a meaningless result
+        if (!config_.dataout.file.empty() && match_data.termination != MatchTermination::DISCONNECT &&
+            match_data.termination != MatchTermination::ILLEGAL_MOVE &&
+            match_data.termination != MatchTermination::RESOURCE_LIMIT) {
+            file_writer_data->write(data::DataBuilder(match_data).get());
+        }
+
+        usage_.add(match_data);
+        search_.add(match_data);
+        metrics_.add(match_data);
+
         const auto result = pgn::PgnBuilder::getResultFromMatch(match_data.players.white, match_data.players.black);
         Logger::trace<true>("Game {} finished with result {}", game_id, result);
 
-        finish({match_data}, match_data.reason, {white_engine.get(), black_engine.get()});
+        finish({match_data}, match_data.reason, match_data.termination, engines);
     }
 }
 
+util::CachedEntry<engine::UciEngine, std::string> &BaseTournament::getEngine(const EngineConfiguration &config) {
+    if (!resources_) return engine_cache_.getEntry(config.name, config, config_.log.realtime);
+
+    // only engines with exactly the same settings can be reused by another tournament
+    auto id = nlohmann::ordered_json(config).dump();
+    if (config_.log.realtime) id += " realtime";
+
+    return resources_->engines.getEntry(id, config, config_.log.realtime);
+}
+
 int BaseTournament::getMaxAffinity(const std::vector<EngineConfiguration> &configs) const noexcept {
     constexpr auto transform = [](const auto &val) { return std::stoi(val); };
-    const auto first_threads = configs[0].getOption<int>("Threads", transform).value_or(1);
 
-    for (const auto &config : configs) {
-        const auto threads = config.getOption<int>("Threads", transform).value_or(1);
+    // the engines of a game take turns, the game needs the threads of the larger one
+    int threads = 1;
 
-        // thread count in all configs has to be the same for affinity to work,
-        // otherwise we set it to 0 and affinity is disabled
-        // if (threads != first_threads) {
-        //     return 0;
-        // }
-
-        // only enable for 1 thread currently
-        if (threads != 1) {
+    for (const auto &config : configs) {
+        try {
+            threads = std::max(threads, config.getOption<int>("Threads", transform).value_or(1));
+        } catch (const std::exception &) {
             return 0;
         }
     }
 
-    return first_threads;
+    return threads;
 }
 
 }  // namespace fastchess
@@ -1,13 +1,25 @@
 #pragma once
 
+#include <condition_variable>
+#include <exception>
+#include <memory>
+#include <mutex>
 #include <vector>
 
 #include <affinity/affinity_manager.hpp>
 #include <book/opening_book.hpp>
 #include <engine/uci_engine.hpp>
 #include <globals/globals.hpp>
+#include <matchmaking/concurrency/controller.hpp>
+#include <matchmaking/daemon/resources.hpp>
+#include <matchmaking/journal/journal.hpp>
+#include <matchmaking/latency.hpp>
+#include <matchmaking/metrics/exporter.hpp>
+#include <matchmaking/metrics/metrics.hpp>
 #include <matchmaking/output/output.hpp>
 #include <matchmaking/scoreboard.hpp>
+#include <matchmaking/search_stats.hpp>
+#include <matchmaking/usage.hpp>
 #include <types/tournament.hpp>
 #include <util/cache.hpp>
 #include <util/file_writer.hpp>
@@ -23,19 +35,39 @@ extern std::atomic_bool stop;
 
 class BaseTournament {
    public:
-    BaseTournament(const stats_map &results);
+    // The resources are shared with the other tournaments of a daemon, nullptr otherwise.
+    BaseTournament(const config::Tournament &config, const std::vector<EngineConfiguration> &engine_configs,
+                   const stats_map &results, daemon::Resources *resources = nullptr);
 
     virtual ~BaseTournament() {
         Logger::trace("~BaseTournament()");
         saveJson();
+
+        if (resources_) {
+            // the games give back their slots before the tournament leaves the scheduler,
+            // the engines are kept running for the next tournament
+            stop_ = true;
+            pool_.kill();
+            resources_->scheduler.remove(this);
+            return;
+        }
+
         Logger::trace("Instructing engines to stop...");
         writeToOpenPipes();
     }
 
     virtual void start();
 
+    // Stops only this tournament, atomic::stop stops all of them.
+    void stop() noexcept {
+        stop_ = true;
+        notifyProgress();
+    }
+
     [[nodiscard]] stats_map getResults() noexcept { return scoreboard_.getResults(); }
 
+    [[nodiscard]] std::uint64_t played() const noexcept { return match_count_; }
+
     void setResults(const stats_map &results) noexcept {
         Logger::trace("Setting results...");
 
@@ -53,34 +85,96 @@ class BaseTournament {
     }
 
    protected:
+    [[nodiscard]] bool stopped() const noexcept { return stop_ || atomic::stop; }
+
+    const config::Tournament config_;
+    const std::vector<EngineConfiguration> engine_configs_;
+    daemon::Resources *resources_;
+
+    std::atomic_bool stop_ = false;
+
     // number of games played
     std::atomic<std::uint64_t> match_count_;
     std::uint64_t initial_matchcount_;
 
+    // wakes up the thread waiting for the tournament after a game finished or it was stopped
+    void notifyProgress() {
+        // the waiting thread either checks the games after the change or is already waiting
+        {
+            std::lock_guard<std::mutex> lock(progress_mutex_);
+        }
+
+        progress_.notify_all();
+    }
+
+    std::mutex progress_mutex_;
+    std::condition_variable progress_;
+
+    // Stops the tournament because a game couldn't be played, it would never be counted.
+    void fail(std::exception_ptr error) noexcept {
+        {
+            std::lock_guard<std::mutex> lock(progress_mutex_);
+            if (!error_) error_ = error;
+        }
+
+        stop();
+    }
+
+    // Throws the error of the first game which failed.
+    void throwIfFailed() {
+        std::lock_guard<std::mutex> lock(progress_mutex_);
+        if (error_) std::rethrow_exception(error_);
+    }
+
+    std::exception_ptr error_;
+
     // creates the matches
     virtual void create() = 0;
 
     using start_callback    = std::function<void()>;
-    using finished_callback = std::function<void(const Stats &stats, const std::string &reason, const engines &)>;
+    using finished_callback = std::function<void(const Stats &stats, const std::string &reason,
+                                                 MatchTermination termination, const engines &)>;
 
     // Function to save the config file
     void saveJson();
 
     // play one game and write it to the pgn file
-    void playGame(const GamePair<EngineConfiguration, EngineConfiguration> &configs, start_callback start,
-                  finished_callback finish, const pgn::Opening &opening, std::size_t round_id, std::size_t game_id);
+    virtual void playGame(const GamePair<EngineConfiguration, EngineConfiguration> &configs, start_callback start,
+                          finished_callback finish, const pgn::Opening &opening, std::size_t round_id,
+                          std::size_t game_id);
+
+    // write a finished game to the output files and report it to the tournament
+    void finishGame(const MatchData &match_data, const finished_callback &finish, const engines &engines,
+                    std::size_t round_id, std::size_t game_id);
 
     std::unique_ptr<IOutput> output_;
     std::unique_ptr<affinity::AffinityManager> cores_;
+    // cores_ or the map shared with the other tournaments of the process
+    affinity::AffinityManager *affinity_ = nullptr;
     std::unique_ptr<util::FileWriter> file_writer_pgn;
     std::unique_ptr<util::FileWriter> file_writer_epd;
+    std::unique_ptr<util::FileWriter> file_writer_data;
     std::unique_ptr<book::OpeningBook> book_;
+    std::unique_ptr<Journal> journal_;
+    // set with -autoconcurrency, limits the games which are played at once
+    std::unique_ptr<ConcurrencyController> concurrency_;
 
     util::CachePool<engine::UciEngine, std::string> engine_cache_ = util::CachePool<engine::UciEngine, std::string>();
     ScoreBoard scoreboard_                                        = ScoreBoard();
+    UsageBoard usage_                                             = UsageBoard();
+    LatencyBoard latency_                                         = LatencyBoard();
+    SearchBoard search_                                           = SearchBoard();
     util::ThreadPool pool_                                        = util::ThreadPool(1);
 
+    TournamentMetrics metrics_;
+    // set with -metrics, declared last so it stops reading the metrics first
+    std::unique_ptr<MetricsExporter> exporter_;
+
    private:
+    // Engine process for the config, shared with other tournaments if run by the daemon.
+    util::CachedEntry<engine::UciEngine, std::string> &getEngine(const EngineConfiguration &config);
+
+    // Processors a game is pinned to, 0 if the threads of an engine are unknown.
     int getMaxAffinity(const std::vector<EngineConfiguration> &configs) const noexcept;
 };
 
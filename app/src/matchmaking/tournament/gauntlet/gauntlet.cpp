@@ -0,0 +1,77 @@
+#include <matchmaking/tournament/gauntlet/gauntlet.hpp>
+
+#include <util/logger/logger.hpp>
+
+namespace fastchess {
+
+Gauntlet::Gauntlet(const config::Tournament& config, const std::vector<EngineConfiguration>& engine_configs,
+                   const stats_map& results, daemon::Resources* resources)
+    : RoundRobin(config, engine_configs, results, resources) {}
+
+void Gauntlet::start() {
+    Logger::trace("Starting gauntlet...");
+
+    RoundRobin::start();
+
+    if (!sprt_.isEnabled()) return;
+
+    std::lock_guard<std::mutex> lock(decided_mutex_);
+
+    for (std::size_t i = 1; i < engine_configs_.size(); i++) {
+        const auto it     = decided_.find(engine_configs_[i].name);
+        const auto result = it == decided_.end() ? SPRT_CONTINUE : it->second;
+
+        Logger::info("SPRT {} vs {}: {}", engine_configs_[i].name, engine_configs_[0].name, SPRT::describe(result));
+    }
+}
+
+std::vector<std::pair<std::size_t, std::size_t>> Gauntlet::pairs() const {
+    std::vector<std::pair<std::size_t, std::size_t>> pairs;
+
+    for (std::size_t i = 1; i < engine_configs_.size(); i++) pairs.emplace_back(i, 0);
+
+    return pairs;
+}
+
+bool Gauntlet::skip(const EngineConfiguration& candidate, const EngineConfiguration&) {
+    std::lock_guard<std::mutex> lock(decided_mutex_);
+    return decided_.count(candidate.name) > 0;
+}
+
+void Gauntlet::updateSprtStatus(const std::vector<EngineConfiguration>& engine_configs, const engines& engines) {
+    if (!sprt_.isEnabled()) return;
+
+    const auto& candidate = engine_configs[0].name;
+    const auto& base      = engine_configs[1].name;
+
+    const auto stats  = scoreboard_.getStats(candidate, base);
+    const auto llr    = sprt_.getLLR(stats, config_.report_penta);
+    const auto result = sprt_.getResult(llr);
+
+    metrics_.setLlr(candidate, llr);
+
+    if (result == SPRT_CONTINUE) return;
+
+    std::size_t decided = 0;
+
+    {
+        std::lock_guard<std::mutex> lock(decided_mutex_);
+
+        // games which were already running when the candidate was decided
+        if (!decided_.emplace(candidate, result).second) return;
+
+        decided = decided_.size();
+    }
+
+    Logger::info("SPRT of {} finished, {}: {} {}", candidate, SPRT::describe(result), sprt_.getBounds(),
+                 sprt_.getElo());
+    output_->printResult(stats, candidate, base);
+    output_->printInterval(sprt_, stats, candidate, base, engines, config_.opening.file);
+
+    if (decided + 1 == engine_configs_.size()) {
+        stop();
+        output_->endTournament();
+    }
+}
+
+}  // namespace fastchess
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <map>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <matchmaking/tournament/roundrobin/roundrobin.hpp>
+
+namespace fastchess {
+
+// The first engine is the base which plays each of the other engines, the candidates. Every
+// candidate runs its own SPRT against the base. A candidate is dropped once its SPRT is
+// decided, its remaining games go to the undecided candidates and the gauntlet ends when
+// all of them are decided.
+class Gauntlet : public RoundRobin {
+   public:
+    Gauntlet(const config::Tournament& config, const std::vector<EngineConfiguration>& engine_configs,
+             const stats_map& results, daemon::Resources* resources = nullptr);
+
+    ~Gauntlet() { Logger::trace("~Gauntlet()"); }
+
+    void start() override;
+
+   protected:
+    // (candidate, base) for each candidate
+    [[nodiscard]] std::vector<std::pair<std::size_t, std::size_t>> pairs() const override;
+
+    [[nodiscard]] bool skip(const EngineConfiguration& candidate, const EngineConfiguration& base) override;
+
+    void updateSprtStatus(const std::vector<EngineConfiguration>& engine_configs, const engines& engines) override;
+
+   private:
+    std::mutex decided_mutex_;
+
+    // result of each candidate whose SPRT is decided
+    std::map<std::string, SPRTResult> decided_;
+};
+
+}  // namespace fastchess
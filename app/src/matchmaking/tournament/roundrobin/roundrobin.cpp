@@ -1,5 +1,8 @@
 #include <matchmaking/tournament/roundrobin/roundrobin.hpp>
 
+#include <algorithm>
+#include <chrono>
+
 #include <chess.hpp>
 
 #include <matchmaking/output/output_factory.hpp>
@@ -10,11 +13,14 @@
 
 namespace fastchess {
 
-RoundRobin::RoundRobin(const stats_map& results) : BaseTournament(results) {
+RoundRobin::RoundRobin(const config::Tournament& config, const std::vector<EngineConfiguration>& engine_configs,
+                       const stats_map& results, daemon::Resources* resources)
+    : BaseTournament(config, engine_configs, results, resources), standings_(engine_configs.size()) {
     // Initialize the SPRT test
-    sprt_ = SPRT(config::TournamentConfig.get().sprt.alpha, config::TournamentConfig.get().sprt.beta,
-                 config::TournamentConfig.get().sprt.elo0, config::TournamentConfig.get().sprt.elo1,
-                 config::TournamentConfig.get().sprt.model, config::TournamentConfig.get().sprt.enabled);
+    sprt_ = SPRT(config.sprt.alpha, config.sprt.beta, config.sprt.elo0, config.sprt.elo1, config.sprt.model,
+                 config.sprt.enabled);
+
+    if (sprt_.isEnabled()) metrics_.setSprtBounds(sprt_.getLowerBound(), sprt_.getUpperBound());
 }
 
 void RoundRobin::start() {
@@ -22,99 +28,345 @@ void RoundRobin::start() {
 
     BaseTournament::start();
 
-    // If autosave is enabled, save the results every save_interval games
-    const auto save_interval = config::TournamentConfig.get().autosaveinterval;
+    // If autosave is enabled, save the results every save_interval games.
+    // The journal already records every game, so rewriting the config is not needed.
+    const auto save_interval = journal_ ? 0 : config_.autosaveinterval;
     // Account for the initial matchcount
     auto save_iter = initial_matchcount_ + save_interval;
 
+    std::unique_lock<std::mutex> lock(progress_mutex_);
+
     // Wait for games to finish
-    while (match_count_ < total_ && !atomic::stop) {
+    while (match_count_ < total_ && !stopped()) {
         if (save_interval > 0 && match_count_ >= save_iter) {
+            lock.unlock();
             saveJson();
+            lock.lock();
+
             save_iter += save_interval;
         }
 
-        std::this_thread::sleep_for(std::chrono::seconds(1));
+        // atomic::stop is set by the signal handler, which can't notify
+        progress_.wait_for(lock, std::chrono::seconds(1));
     }
+
+    lock.unlock();
+
+    // the threads of the last games are still in their finish callback, they must be done
+    // before the tournament is destroyed
+    if (!stopped()) pool_.kill();
+
+    throwIfFailed();
+
+    usage_.print();
+    latency_.print();
+    search_.print();
 }
 
 void RoundRobin::create() {
     Logger::trace("Creating matches...");
 
-    total_ = (config::EngineConfigs.get().size() * (config::EngineConfigs.get().size() - 1) / 2) *
-             config::TournamentConfig.get().rounds * config::TournamentConfig.get().games;
+    const auto& shard = config_.shard;
+
+    pairs_ = pairs();
+
+    total_ = pairs_.size() * shard.rounds(config_.rounds) * config_.games;
 
-    const auto create_match = [this](std::size_t i, std::size_t j, std::size_t round_id, int g,
-                                     std::optional<std::size_t> opening_id) {
-        assert(g < 2);
+    replayJournal();
 
-        const auto opening        = (*book_)[opening_id];
-        const auto first          = config::EngineConfigs.get()[i];
-        const auto second         = config::EngineConfigs.get()[j];
-        const std::size_t game_id = round_id * config::TournamentConfig.get().games + (g + 1);
+    // openings are taken round by round, so they don't depend on the order the games are queued in
+    const int offset = initial_matchcount_ / (config_.games * pairs_.size());
 
-        GamePair<EngineConfiguration, EngineConfiguration> configs = {first, second};
+    std::vector<std::vector<std::optional<std::size_t>>> openings;
+    for (int k = offset; k < config_.rounds; k++) {
+        // both players of a pair get the same opening
+        auto& round = openings.emplace_back();
+        for (std::size_t p = 0; p < pairs_.size(); p++) round.push_back(book_->fetchId());
+    }
 
-        if (game_id % 2 == 0 && !config::TournamentConfig.get().noswap) {
-            std::swap(configs.white, configs.black);
+    // Pairs take turns in blocks of rounds, a block keeps every slot busy for about two games.
+    // Most games find both engines already running and consecutive pairs share an engine, so
+    // the engine cache replaces few processes. Dropped games of a skipped pair are taken over
+    // by the next block.
+    const int block = std::max(1, config_.concurrency);
+
+    for (int begin = offset; begin < config_.rounds; begin += block) {
+        for (std::size_t p = 0; p < pairs_.size(); p++) {
+            for (int k = begin; k < std::min(begin + block, config_.rounds); k++) {
+                // every shard fetches all openings, so round k gets the same opening in all shards
+                if (!shard.owns(k)) continue;
+
+                for (int g = 0; g < config_.games; g++) {
+                    queueGame({pairs_[p].first, pairs_[p].second, p, static_cast<std::size_t>(k), g,
+                               openings[k - offset][p]});
+                }
+            }
         }
+    }
+}
 
-        // callback functions, do not capture by reference
-        const auto start = [this, configs, game_id]() { output_->startGame(configs, game_id, total_); };
+void RoundRobin::createMatch(std::size_t i, std::size_t j, std::size_t pair, std::size_t round_id, int g,
+                             std::optional<std::size_t> opening_id) {
+    assert(g < 2);
 
-        // callback functions, do not capture by reference
-        const auto finish = [this, configs, first, second, game_id, round_id](
-                                const Stats& stats, const std::string& reason, const engines& engines) {
-            const auto& cfg = config::TournamentConfig.get();
+    const auto opening        = (*book_)[opening_id];
+    const auto first          = engine_configs_[i];
+    const auto second         = engine_configs_[j];
+    const std::size_t game_id = (round_id * pairs_.size() + pair) * config_.games + (g + 1);
 
-            // lock to avoid chaotic output, i.e.
-            // Finished game 187 (Engine1 vs Engine2): 0-1 {White loses on time}
-            // Finished game 186 (Engine2 vs Engine1): 0-1 {White loses on time}
-            // Score of Engine1 vs Engine2: 95 - 92 - 0  [0.508] 187
-            // Score of Engine1 vs Engine2: 94 - 92 - 0  [0.505] 186
-            std::lock_guard<std::mutex> lock(output_mutex_);
+    GamePair<EngineConfiguration, EngineConfiguration> configs = {first, second};
 
-            output_->endGame(configs, stats, reason, game_id);
+    // colors alternate within the games of a pair
+    if ((round_id * config_.games + g) % 2 == 1 && !config_.noswap) {
+        std::swap(configs.white, configs.black);
+    }
 
-            bool report = cfg.report_penta ? scoreboard_.updatePair(configs, stats, round_id)
-                                           : scoreboard_.updateNonPair(configs, stats);
+    // already finished in a previous run
+    if (played_games_.count({configs.white.name, configs.black.name, round_id, g})) {
+        return;
+    }
 
-            // round_id and match_count_ starts 0 so we add 1
-            const auto ratinginterval_index = cfg.report_penta ? round_id + 1 : match_count_ + 1;
-            const auto scoreinterval_index  = match_count_ + 1;
-            const auto updated_stats        = scoreboard_.getStats(first.name, second.name);
+    if (skip(first, second)) {
+        total_--;
+        return;
+    }
 
-            // print score result based on scoreinterval if output format is cutechess
-            if ((scoreinterval_index % cfg.scoreinterval == 0) || match_count_ + 1 == total_) {
-                output_->printResult(updated_stats, first.name, second.name);
-            }
+    // callback functions, do not capture by reference
+    const auto start = [this, configs, game_id]() { output_->startGame(configs, game_id, total_); };
+
+    const auto begin = std::chrono::steady_clock::now();
 
-            // Only print the interval if the pair is complete or we are not tracking
-            // penta stats.
-            if ((report && ratinginterval_index % cfg.ratinginterval == 0) || match_count_ + 1 == total_) {
-                output_->printInterval(sprt_, updated_stats, first.name, second.name, engines, cfg.opening.file);
+    // callback functions, do not capture by reference
+    const auto finish = [this, configs, first, second, pair, game_id, round_id, g, opening_id, begin](
+                            const Stats& stats, const std::string& reason, MatchTermination termination,
+                            const engines& engines) {
+        const auto& cfg = config_;
+
+        addDuration(pair, std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count());
+
+        // lock to avoid chaotic output, i.e.
+        // Finished game 187 (Engine1 vs Engine2): 0-1 {White loses on time}
+        // Finished game 186 (Engine2 vs Engine1): 0-1 {White loses on time}
+        // Score of Engine1 vs Engine2: 95 - 92 - 0  [0.508] 187
+        // Score of Engine1 vs Engine2: 94 - 92 - 0  [0.505] 186
+        std::lock_guard<std::mutex> lock(output_mutex_);
+
+        output_->endGame(configs, stats, reason, termination, game_id);
+
+        bool report = cfg.report_penta ? scoreboard_.updatePair(configs, stats, round_id)
+                                       : scoreboard_.updateNonPair(configs, stats);
+
+        if (journal_) {
+            const auto opening = opening_id ? static_cast<int64_t>(*opening_id) : -1;
+            journal_->append({configs.white.name, configs.black.name, round_id, g, opening, stats});
+        }
+
+        // round_id and match_count_ starts 0 so we add 1
+        const auto ratinginterval_index = cfg.report_penta ? round_id + 1 : match_count_ + 1;
+        const auto scoreinterval_index  = match_count_ + 1;
+        const auto updated_stats        = scoreboard_.getStats(first.name, second.name);
+
+        // print score result based on scoreinterval if output format is cutechess
+        if ((scoreinterval_index % cfg.scoreinterval == 0) || match_count_ + 1 == total_) {
+            output_->printResult(updated_stats, first.name, second.name);
+        }
+
+        // Only print the interval if the pair is complete or we are not tracking
+        // penta stats.
+        if ((report && ratinginterval_index % cfg.ratinginterval == 0) || match_count_ + 1 == total_) {
+            output_->printInterval(sprt_, updated_stats, first.name, second.name, engines, cfg.opening.file);
+
+            // the lines would scroll the status summary away, which is redrawn in place
+            if (cfg.output != OutputType::STATUS) {
+                latency_.printSummary();
+                search_.printSummary();
             }
+        }
 
-            updateSprtStatus({first, second}, engines);
+        if (report) completed_++;
 
-            match_count_++;
-        };
+        // joint ranking once every pair played ratinginterval more rounds, two engines have
+        // the head to head result above
+        if (engine_configs_.size() > 2 && cfg.output != OutputType::STATUS &&
+            ((report && completed_ % (cfg.ratinginterval * pairs_.size()) == 0) || match_count_ + 1 == total_)) {
+            loadRatings(standings_);
+            printRatings(standings_);
+        }
+
+        updateSprtStatus({first, second}, engines);
+
+        match_count_++;
+        notifyProgress();
 
-        playGame(configs, start, finish, opening, round_id, game_id);
+        gameFinished(pair, report);
     };
 
-    for (std::size_t i = 0; i < config::EngineConfigs.get().size(); i++) {
-        for (std::size_t j = i + 1; j < config::EngineConfigs.get().size(); j++) {
-            int offset = initial_matchcount_ / config::TournamentConfig.get().games;
-            for (int k = offset; k < config::TournamentConfig.get().rounds; k++) {
-                // both players get the same opening
-                const auto opening = book_->fetchId();
+    playGame(configs, start, finish, opening, round_id, game_id);
+}
 
-                for (int g = 0; g < config::TournamentConfig.get().games; g++) {
-                    pool_.enqueue(create_match, i, j, k, g, opening);
-                }
-            }
+void RoundRobin::queueGame(const PendingGame& game) {
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex_);
+        pending_.push_back(game);
+        metrics_.setQueued(pending_.size());
+    }
+
+    pool_.enqueue(&RoundRobin::playNext, this);
+}
+
+void RoundRobin::playNext() {
+    const auto game = popGame();
+
+    if (game && Tracer::enabled()) {
+        Tracer::async("queued", "tournament", game->queued, Tracer::clock::now(),
+                      {{"pair", game->pair}, {"round", game->round_id + 1}});
+    }
+
+    if (!game) return;
+
+    // the thread pool drops the exception, the tournament would wait for the game forever
+    try {
+        createMatch(game->i, game->j, game->pair, game->round_id, game->g, game->opening_id);
+    } catch (const std::exception& e) {
+        Logger::trace<true>("Game {} of round {} failed: {}", game->g + 1, game->round_id + 1, e.what());
+        fail(std::current_exception());
+    }
+}
+
+std::optional<RoundRobin::PendingGame> RoundRobin::popGame() {
+    std::lock_guard<std::mutex> lock(queue_mutex_);
+
+    if (pending_.empty()) return std::nullopt;
+
+    durations_.resize(pairs_.size());
+
+    auto next = pending_.begin();
+
+    const auto open = [this](const PendingGame& game) { return started_.count({game.pair, game.round_id}) > 0; };
+
+    if (!started_.empty()) {
+        // the other games of a round are usually right behind it
+        next = std::find_if(pending_.begin(), pending_.end(), open);
+        if (next == pending_.end()) next = pending_.begin();
+    }
+
+    // the last games, one slow round could keep the tournament running long after the others
+    // are done. Pairs without a finished game are expected to take the average time.
+    if (!open(*next) && pending_.size() <= 2 * static_cast<std::size_t>(std::max(1, config_.concurrency))) {
+        double sum   = 0.0;
+        int measured = 0;
+
+        for (const auto& [average, count] : durations_) {
+            if (count == 0) continue;
+            sum += average;
+            measured++;
+        }
+
+        const auto fallback = measured > 0 ? sum / measured : 0.0;
+        const auto expected = [&](const PendingGame& game) {
+            const auto& [average, count] = durations_[game.pair];
+            return count > 0 ? average : fallback;
+        };
+
+        for (auto it = pending_.begin(); it != pending_.end(); ++it) {
+            if (expected(*it) > expected(*next)) next = it;
+        }
+    }
+
+    const auto game = *next;
+    pending_.erase(next);
+    metrics_.setQueued(pending_.size());
+
+    const auto key = std::make_pair(game.pair, game.round_id);
+    if (++started_[key] >= config_.games) started_.erase(key);
+
+    return game;
+}
+
+void RoundRobin::addDuration(std::size_t pair, double seconds) {
+    std::lock_guard<std::mutex> lock(queue_mutex_);
+
+    durations_.resize(pairs_.size());
+
+    auto& [average, count] = durations_[pair];
+    count++;
+    average += (seconds - average) / count;
+}
+
+std::vector<std::pair<std::size_t, std::size_t>> RoundRobin::pairs() const {
+    std::vector<std::pair<std::size_t, std::size_t>> pairs;
+
+    for (std::size_t i = 0; i < engine_configs_.size(); i++) {
+        for (std::size_t j = i + 1; j < engine_configs_.size(); j++) {
+            pairs.emplace_back(i, j);
+        }
+    }
+
+    return pairs;
+}
+
+void RoundRobin::replayJournal() {
+    if (!journal_) return;
+
+    const auto& cfg = config_;
+
+    for (const auto& entry : journal_->entries()) {
+        EngineConfiguration white, black;
+        white.name = entry.white;
+        black.name = entry.black;
+
+        const GamePair<EngineConfiguration, EngineConfiguration> configs = {white, black};
+
+        // same order as the games originally finished, so half finished pairs end up in the pair cache again
+        if (cfg.report_penta) {
+            scoreboard_.updatePair(configs, entry.stats, entry.round_id);
+        } else {
+            scoreboard_.updateNonPair(configs, entry.stats);
         }
+
+        played_games_.insert({entry.white, entry.black, entry.round_id, entry.game});
+        match_count_++;
+    }
+
+    if (!played_games_.empty()) Logger::info("Resuming tournament, {} games loaded from the journal.", match_count_);
+}
+
+void RoundRobin::loadRatings(elo::Ratings& ratings) {
+    for (const auto& [i, j] : pairs_) {
+        ratings.setResult(i, j, scoreboard_.getStats(engine_configs_[i].name, engine_configs_[j].name),
+                          config_.report_penta);
+    }
+
+    const auto begin = std::chrono::steady_clock::now();
+
+    ratings.solve();
+
+    const auto elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin);
+    Logger::trace("Solved the ratings of {} engines in {:.3f} ms", ratings.size(), elapsed.count());
+}
+
+void RoundRobin::printRatings(const elo::Ratings& ratings) {
+    std::vector<double> points(engine_configs_.size(), 0.0);
+    std::vector<int> games(engine_configs_.size(), 0);
+
+    for (const auto& [i, j] : pairs_) {
+        const auto stats = scoreboard_.getStats(engine_configs_[i].name, engine_configs_[j].name);
+        points[i] += stats.wins + stats.draws / 2.0;
+        points[j] += stats.losses + stats.draws / 2.0;
+        games[i] += stats.sum();
+        games[j] += stats.sum();
+    }
+
+    Logger::info("{:>4} {:<30} {:>8} {:>8} {:>7} {:>7}", "Rank", "Name", "Elo", "+/-", "Games", "Score");
+
+    const auto ranking = ratings.ranking();
+
+    for (std::size_t k = 0; k < ranking.size(); k++) {
+        const auto player = ranking[k];
+        const auto score  = games[player] > 0 ? 100.0 * points[player] / games[player] : 0.0;
+
+        Logger::info("{:>4} {:<30} {:>8.2f} {:>8.2f} {:>7} {:>6.1f}%", k + 1, engine_configs_[player].name,
+                     ratings.elo(player), ratings.error(player), games[player], score);
     }
 }
 
@@ -122,15 +374,17 @@ void RoundRobin::updateSprtStatus(const std::vector<EngineConfiguration>& engine
     if (!sprt_.isEnabled()) return;
 
     const auto stats = scoreboard_.getStats(engine_configs[0].name, engine_configs[1].name);
-    const auto llr   = sprt_.getLLR(stats, config::TournamentConfig.get().report_penta);
+    const auto llr   = sprt_.getLLR(stats, config_.report_penta);
+
+    metrics_.setLlr(engine_configs[0].name, llr);
 
     if (sprt_.getResult(llr) != SPRT_CONTINUE || match_count_ == total_) {
-        atomic::stop = true;
+        stop();
 
         Logger::info("SPRT test finished: {} {}", sprt_.getBounds(), sprt_.getElo());
         output_->printResult(stats, engine_configs[0].name, engine_configs[1].name);
         output_->printInterval(sprt_, stats, engine_configs[0].name, engine_configs[1].name, engines,
-                               config::TournamentConfig.get().opening.file);
+                               config_.opening.file);
         output_->endTournament();
     }
 }
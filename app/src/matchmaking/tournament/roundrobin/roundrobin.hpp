@@ -1,6 +1,17 @@
 #pragma once
 
+#include <deque>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <set>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
 #include <affinity/affinity_manager.hpp>
+#include <elo/ratings.hpp>
 #include <matchmaking/match/match.hpp>
 #include <matchmaking/scoreboard.hpp>
 #include <matchmaking/sprt/sprt.hpp>
@@ -11,6 +22,7 @@
 #include <util/file_writer.hpp>
 #include <util/rand.hpp>
 #include <util/threadpool.hpp>
+#include <util/tracer/tracer.hpp>
 
 #include <matchmaking/tournament/base/tournament.hpp>
 
@@ -22,26 +34,100 @@ extern std::atomic_bool stop;
 
 class RoundRobin : public BaseTournament {
    public:
-    explicit RoundRobin(const stats_map& results);
+    RoundRobin(const config::Tournament& config, const std::vector<EngineConfiguration>& engine_configs,
+               const stats_map& results, daemon::Resources* resources = nullptr);
 
     ~RoundRobin() { Logger::trace("~RoundRobin()"); }
 
     // starts the round robin
     void start() override;
 
+    // number of games of the tournament, known once it was started
+    [[nodiscard]] std::uint64_t total() const noexcept { return total_; }
+
    protected:
     // creates the matches
     void create() override;
 
-   private:
+    // Indices of the engines which play each other, the first engine of a pair has white in
+    // the first game of a round. Every engine plays every other one.
+    [[nodiscard]] virtual std::vector<std::pair<std::size_t, std::size_t>> pairs() const;
+
+    // Queued games of the pair are dropped if this returns true.
+    [[nodiscard]] virtual bool skip(const EngineConfiguration&, const EngineConfiguration&) { return false; }
+
     // update the current running sprt. SPRT Config has to be valid.
-    void updateSprtStatus(const std::vector<EngineConfiguration>& engine_configs, const engines& engines);
+    virtual void updateSprtStatus(const std::vector<EngineConfiguration>& engine_configs, const engines& engines);
 
-    SPRT sprt_ = SPRT();
+    // Called after each finished game of pairs_[pair] with the output lock held, round_complete
+    // is set once the result was added to the scoreboard.
+    virtual void gameFinished(std::size_t, bool) {}
 
-    std::mutex output_mutex_;
+    // Plays game g of the round of pairs_[pair], the engines are given by their index.
+    void createMatch(std::size_t i, std::size_t j, std::size_t pair, std::size_t round_id, int g,
+                     std::optional<std::size_t> opening_id);
+
+    // Game waiting for a free thread, the engines are given by their index.
+    struct PendingGame {
+        std::size_t i;
+        std::size_t j;
+        std::size_t pair;
+        std::size_t round_id;
+        int g;
+        std::optional<std::size_t> opening_id;
+        // when the game was queued, for the trace
+        Tracer::clock::time_point queued = Tracer::clock::now();
+    };
+
+    // Adds the game to the queue, a free thread plays whichever game popGame() picks.
+    void queueGame(const PendingGame& game);
+
+    // Replays the finished games of the journal into the scoreboard
+    void replayJournal();
+
+    // Loads the results of all pairs from the scoreboard and solves the ratings.
+    void loadRatings(elo::Ratings& ratings);
+
+    // Prints the joint ranking of all engines.
+    void printRatings(const elo::Ratings& ratings);
+
+    SPRT sprt_ = SPRT();
 
     // number of games to be played
     std::atomic<uint64_t> total_ = 0;
+
+    // pairs() of the tournament, set when the matches are created
+    std::vector<std::pair<std::size_t, std::size_t>> pairs_;
+
+    // games which were already played according to the journal, (white, black, round_id, game)
+    std::set<std::tuple<std::string, std::string, std::size_t, int>> played_games_;
+
+   private:
+    void playNext();
+
+    // The remaining games of rounds which were already started come first, so the pentanomial
+    // results don't wait for the end of the queue. Near the end of the tournament, the rounds
+    // of the pairs with the longest games start first so the last games finish together.
+    [[nodiscard]] std::optional<PendingGame> popGame();
+
+    // Adds the duration of a finished game of pairs_[pair] to its average.
+    void addDuration(std::size_t pair, double seconds);
+
+    std::mutex output_mutex_;
+
+    std::mutex queue_mutex_;
+    std::deque<PendingGame> pending_;
+
+    // started games of the rounds which still have games in the queue, by (pair, round_id)
+    std::map<std::pair<std::size_t, std::size_t>, int> started_;
+
+    // average game duration of each pair in seconds and the number of games it is based on
+    std::vector<std::pair<double, int>> durations_;
+
+    // joint ratings of all engines, each report starts from the previous solution
+    elo::Ratings standings_;
+
+    // rounds completed by any pair, a round is a single game without pentanomial stats
+    std::uint64_t completed_ = 0;
 };
 }  // namespace fastchess
@@ -1,19 +1,101 @@
 #include <matchmaking/tournament/tournament_manager.hpp>
 
+#include <exception>
+#include <fstream>
+#include <mutex>
+#include <thread>
+
+#include <matchmaking/daemon/daemon.hpp>
+#include <matchmaking/distributed/coordinator.hpp>
+#include <matchmaking/tournament/adaptive/adaptive.hpp>
+#include <matchmaking/tournament/gauntlet/gauntlet.hpp>
 #include <util/logger/logger.hpp>
+#include <util/rand.hpp>
 
 namespace fastchess {
 
 TournamentManager::TournamentManager(const stats_map& results) {
     Logger::trace("Creating tournament...");
 
-    round_robin_ = std::make_unique<RoundRobin>(results);
+    const auto &config         = config::TournamentConfig.get();
+    const auto &engine_configs = config::EngineConfigs.get();
+
+    if (config.coordinator.port > 0) {
+        round_robin_ = std::make_unique<distributed::Coordinator>(config, engine_configs, results);
+    } else {
+        round_robin_ = create(config, engine_configs, results);
+    }
+}
+
+std::unique_ptr<RoundRobin> TournamentManager::create(const config::Tournament& config,
+                                                      const std::vector<EngineConfiguration>& engine_configs,
+                                                      const stats_map& results, daemon::Resources* resources) {
+    if (config.type == TournamentType::GAUNTLET) {
+        return std::make_unique<Gauntlet>(config, engine_configs, results, resources);
+    }
+
+    if (config.type == TournamentType::ADAPTIVE) {
+        return std::make_unique<AdaptiveRoundRobin>(config, engine_configs, results, resources);
+    }
+
+    return std::make_unique<RoundRobin>(config, engine_configs, results, resources);
+}
+
+TournamentManager::TournamentManager(const config::Tournament& local, const std::vector<config::Test>& tests) {
+    Logger::trace("Creating tournaments...");
+
+    resources_ = std::make_unique<daemon::Resources>(local.concurrency, local.affinity);
+
+    for (const auto& test : tests) {
+        std::ifstream file(test.file);
+        if (!file.is_open()) throw std::runtime_error("Error; Could not open " + test.file + ".");
+
+        auto [config, engines, stats] = daemon::parseTest(nlohmann::ordered_json::parse(file));
+
+        if (test.weight > 0) config.weight = test.weight;
+
+        // the results are written back, so the test can be resumed from the same file
+        if (config.config_name.empty()) config.config_name = test.file;
+
+        // the opening book is shuffled with the seed of the test
+        util::random::seed(config.seed);
+
+        tests_.push_back(create(config, engines, stats, resources_.get()));
+    }
 }
 
 void TournamentManager::start() {
     Logger::trace("Starting tournament...");
 
-    round_robin_->start();
+    if (round_robin_) {
+        round_robin_->start();
+        return;
+    }
+
+    std::vector<std::thread> threads;
+    std::mutex error_mutex;
+    std::exception_ptr error;
+
+    for (auto& test : tests_) {
+        threads.emplace_back([&test, &error_mutex, &error]() {
+            try {
+                test->start();
+
+                // a finished test gives its slots to the remaining ones
+                test.reset();
+            } catch (...) {
+                // the other tests end too, the error is reported once all of them stopped
+                atomic::stop = true;
+
+                std::lock_guard<std::mutex> lock(error_mutex);
+                if (!error) error = std::current_exception();
+            }
+        });
+    }
+
+    for (auto& thread : threads) thread.join();
+
+    if (error) std::rethrow_exception(error);
 }
 
 }  // namespace fastchess
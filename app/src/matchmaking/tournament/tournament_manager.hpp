@@ -1,16 +1,24 @@
 #pragma once
 
+#include <memory>
+#include <vector>
+
+#include <matchmaking/daemon/resources.hpp>
 #include <matchmaking/tournament/roundrobin/roundrobin.hpp>
+#include <types/daemon.hpp>
 #include <types/tournament.hpp>
 
 namespace fastchess {
 
-// Manages the tournament, currently wraps round robin but can be extended to support
-// different tournament types
+// Manages the tournament, a round robin, a gauntlet or an adaptive round robin
 class TournamentManager {
    public:
     TournamentManager(const stats_map &results);
 
+    // Plays the tests in parallel, they share the slots of local.concurrency and the cores
+    // if local.affinity is set.
+    TournamentManager(const config::Tournament &local, const std::vector<config::Test> &tests);
+
     ~TournamentManager() {
         atomic::stop = true;
         Logger::trace("~TournamentManager()");
@@ -18,10 +26,19 @@ class TournamentManager {
 
     void start();
 
+    // Tournament of the type of the config.
+    [[nodiscard]] static std::unique_ptr<RoundRobin> create(const config::Tournament &config,
+                                                            const std::vector<EngineConfiguration> &engine_configs,
+                                                            const stats_map &results,
+                                                            daemon::Resources *resources = nullptr);
+
     [[nodiscard]] RoundRobin *roundRobin() { return round_robin_.get(); }
 
    private:
     std::unique_ptr<RoundRobin> round_robin_;
+
+    std::unique_ptr<daemon::Resources> resources_;
+    std::vector<std::unique_ptr<RoundRobin>> tests_;
 };
 
 }  // namespace fastchess
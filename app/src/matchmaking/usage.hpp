@@ -0,0 +1,98 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+
+#include <types/match_data.hpp>
+#include <util/logger/logger.hpp>
+
+namespace fastchess {
+
+// Sums of the process accounting of an engine over its games.
+struct EngineUsage {
+    std::uint64_t games = 0;
+
+    int64_t user_millis   = 0;
+    int64_t system_millis = 0;
+
+    std::uint64_t voluntary_switches   = 0;
+    std::uint64_t involuntary_switches = 0;
+
+    // largest resident set of all games, in MiB
+    std::uint64_t max_rss = 0;
+
+    // Preemptions per second of cpu time, threads which get a core of their own are hardly
+    // ever preempted.
+    [[nodiscard]] double preemptionRate() const noexcept {
+        const auto cpu = user_millis + system_millis;
+        return cpu > 0 ? involuntary_switches * 1000.0 / cpu : 0.0;
+    }
+};
+
+// Collects the accounting of the engine processes of the finished games.
+class UsageBoard {
+   public:
+    // engines which are preempted more often than this per second of cpu time fight for the processors
+    static constexpr double OVERSUBSCRIBED_RATE = 100.0;
+
+    // engines which hardly search are woken up so rarely that the rate means nothing
+    static constexpr int64_t MIN_CPU_MILLIS = 10000;
+
+    void add(const MatchData &data) {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        for (const auto *player : {&data.players.white, &data.players.black}) {
+            if (!player->process) continue;
+
+            const auto &process = *player->process;
+            auto &usage         = engines_[player->config.name];
+
+            usage.games++;
+            usage.user_millis += process.user_millis;
+            usage.system_millis += process.system_millis;
+            usage.voluntary_switches += process.voluntary_switches;
+            usage.involuntary_switches += process.involuntary_switches;
+            usage.max_rss = std::max(usage.max_rss, process.max_rss);
+        }
+    }
+
+    [[nodiscard]] std::map<std::string, EngineUsage> get() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return engines_;
+    }
+
+    // Prints a line per engine, nothing if no engine process was accounted for.
+    void print() const {
+        const auto engines = get();
+        if (engines.empty()) return;
+
+        Logger::info("{:<30} {:>7} {:>10} {:>10} {:>12} {:>12} {:>9}", "Resource usage", "Games", "User", "System",
+                     "Vol. sw/g", "Invol. sw/g", "Peak RSS");
+
+        for (const auto &[name, usage] : engines) {
+            const auto games = std::max<std::uint64_t>(1, usage.games);
+
+            Logger::info("{:<30} {:>7} {:>9.1f}s {:>9.1f}s {:>12} {:>12} {:>6} MB", name, usage.games,
+                         usage.user_millis / 1000.0, usage.system_millis / 1000.0, usage.voluntary_switches / games,
+                         usage.involuntary_switches / games, usage.max_rss);
+        }
+
+        for (const auto &[name, usage] : engines) {
+            if (usage.user_millis + usage.system_millis < MIN_CPU_MILLIS) continue;
+            if (usage.preemptionRate() <= OVERSUBSCRIBED_RATE) continue;
+
+            Logger::warn("Warning; {} was preempted {:.0f} times per second of cpu time, the machine is likely "
+                         "oversubscribed.",
+                         name, usage.preemptionRate());
+        }
+    }
+
+   private:
+    std::map<std::string, EngineUsage> engines_;
+    mutable std::mutex mutex_;
+};
+
+}  // namespace fastchess
@@ -136,14 +136,16 @@ std::string PgnBuilder::addMove(chess::Board &board, const MoveData &move, std::
         if (move.book) {
             ss << addComment("book");
         } else {
-            ss << addComment((move.score_string + "/" + std::to_string(move.depth)),                         //
-                             formatTime(move.elapsed_millis),                                                //
-                             pgn_config_.track_nodes ? "n=" + std::to_string(move.nodes) : "",               //
-                             pgn_config_.track_seldepth ? "sd=" + std::to_string(move.seldepth) : "",        //
-                             pgn_config_.track_nps ? "nps=" + std::to_string(move.nps) : "",                 //
-                             pgn_config_.track_hashfull ? "hashfull=" + std::to_string(move.hashfull) : "",  //
-                             pgn_config_.track_tbhits ? "tbhits=" + std::to_string(move.tbhits) : "",        //
-                             last ? match_.reason : ""                                                       //
+            ss << addComment((move.score_string + "/" + std::to_string(move.depth)),                               //
+                             formatTime(move.elapsed_millis),                                                      //
+                             pgn_config_.track_nodes ? "n=" + std::to_string(move.nodes) : "",                     //
+                             pgn_config_.track_seldepth ? "sd=" + std::to_string(move.seldepth) : "",              //
+                             pgn_config_.track_nps ? "nps=" + std::to_string(move.nps) : "",                       //
+                             pgn_config_.track_hashfull ? "hashfull=" + std::to_string(move.hashfull) : "",        //
+                             pgn_config_.track_tbhits ? "tbhits=" + std::to_string(move.tbhits) : "",              //
+                             pgn_config_.track_usage ? "cpu=" + formatTime(move.cpu_millis) : "",                  //
+                             pgn_config_.track_usage ? "ivcsw=" + std::to_string(move.involuntary_switches) : "",  //
+                             last ? match_.reason : ""                                                             //
             );
         }
     }
@@ -178,6 +180,8 @@ std::string PgnBuilder::convertMatchTermination(const MatchTermination &res) noe
             return "illegal move";
         case MatchTermination::INTERRUPT:
             return "unterminated";
+        case MatchTermination::RESOURCE_LIMIT:
+            return "rules infraction";
         default:
             return "";
     }
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+namespace fastchess::config {
+
+// The daemon keeps running and plays the tournaments submitted over a Unix domain socket,
+// the other commands talk to a running daemon.
+struct Daemon {
+    enum class Command { NONE, SERVE, SUBMIT, STATUS, CANCEL };
+
+    Command command = Command::NONE;
+    std::string socket;
+
+    // test which is cancelled
+    std::uint64_t id = 0;
+};
+
+// Tournament of a saved config file which is played alongside other ones in the same process.
+struct Test {
+    std::string file;
+
+    // 0 keeps the weight of the config file
+    int weight = 0;
+};
+
+}  // namespace fastchess::config
@@ -0,0 +1,21 @@
+#pragma once
+
+#include <string>
+
+#include <types/enums.hpp>
+#include <util/helper.hpp>
+
+namespace fastchess::config {
+
+struct DataOut {
+    std::string file;
+
+    // positions matching these filters are not exported
+    bool skip_checks   = true;
+    bool skip_captures = true;
+    // absolute score limit in centipawns, 0 means no limit
+    int max_score = 0;
+};
+NLOHMANN_DEFINE_TYPE_NON_INTRUSIVE_ORDERED_JSON(DataOut, file, skip_checks, skip_captures, max_score)
+
+}  // namespace fastchess::config
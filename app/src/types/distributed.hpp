@@ -0,0 +1,24 @@
+#pragma once
+
+#include <string>
+
+#include <types/enums.hpp>
+#include <util/helper.hpp>
+
+namespace fastchess::config {
+
+// The coordinator plays no games itself, it hands them out to worker processes which
+// connect over TCP. A port of 0 disables it.
+struct Coordinator {
+    std::string host = "0.0.0.0";
+    int port         = 0;
+};
+NLOHMANN_DEFINE_TYPE_NON_INTRUSIVE_ORDERED_JSON(Coordinator, host, port)
+
+// Address of the coordinator a worker connects to.
+struct Worker {
+    std::string host = "127.0.0.1";
+    int port         = 0;
+};
+
+}  // namespace fastchess::config
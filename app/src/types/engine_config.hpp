@@ -23,6 +23,34 @@ struct Limit {
 };
 NLOHMANN_DEFINE_TYPE_NON_INTRUSIVE_ORDERED_JSON(Limit, tc, nodes, plies)
 
+// cgroup v2 limits of the engine process, only on Linux
+struct Sandbox {
+    bool enabled = false;
+
+    // processors of cpu.max, 0 for the Threads option
+    double cpus = 0.0;
+
+    // MiB of memory.max, 0 for the Hash option and some headroom
+    uint64_t memory = 0;
+
+    // tasks of pids.max, 0 for no limit
+    int pids = 0;
+};
+NLOHMANN_DEFINE_TYPE_NON_INTRUSIVE_ORDERED_JSON(Sandbox, enabled, cpus, memory, pids)
+
+// Scheduling of the engine process, only on POSIX systems
+struct Scheduling {
+    // from -20 to 19, values below 0 need CAP_SYS_NICE or RLIMIT_NICE
+    int nice = 0;
+
+    // SCHED_FIFO and SCHED_RR need CAP_SYS_NICE or RLIMIT_RTPRIO, only on Linux
+    SchedulingPolicy policy = SchedulingPolicy::OTHER;
+
+    // real time priority from 1 to 99
+    int priority = 1;
+};
+NLOHMANN_DEFINE_TYPE_NON_INTRUSIVE_ORDERED_JSON(Scheduling, nice, policy, priority)
+
 struct EngineConfiguration {
     // the limit for the engines "go" command
     Limit limit;
@@ -47,6 +75,10 @@ struct EngineConfiguration {
 
     bool recover = false;
 
+    Sandbox sandbox;
+
+    Scheduling scheduling;
+
     template <typename T, typename Predicate>
     std::optional<T> getOption(std::string_view option_name, Predicate transform) const {
         const auto it = std::find_if(options.begin(), options.end(),
@@ -60,6 +92,6 @@ struct EngineConfiguration {
     }
 };
 NLOHMANN_DEFINE_TYPE_NON_INTRUSIVE_ORDERED_JSON(EngineConfiguration, name, dir, cmd, args, options, limit, variant,
-                                                recover)
+                                                recover, sandbox, scheduling)
 
 }  // namespace fastchess
@@ -6,9 +6,16 @@ enum class NotationType { SAN, LAN, UCI };
 enum class OrderType { RANDOM, SEQUENTIAL };
 enum class FormatType { EPD, PGN, NONE };
 enum class VariantType { STANDARD, FRC };
+enum class TournamentType { ROUNDROBIN, GAUNTLET, ADAPTIVE };
+enum class AffinityPolicy { SHARED, DEDICATED };
+enum class SchedulingPolicy { OTHER, FIFO, RR };
 enum class OutputType {
     FASTCHESS,
     CUTECHESS,
+    // json lines for programs
+    JSON,
+    // a summary redrawn in place
+    STATUS,
 };
 
 }  // namespace fastchess
\ No newline at end of file
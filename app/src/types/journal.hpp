@@ -0,0 +1,17 @@
+#pragma once
+
+#include <string>
+
+#include <types/enums.hpp>
+#include <util/helper.hpp>
+
+namespace fastchess::config {
+
+struct Journal {
+    std::string file;
+    // number of games after which the journal is synced to disk
+    int sync_interval = 10;
+};
+NLOHMANN_DEFINE_TYPE_NON_INTRUSIVE_ORDERED_JSON(Journal, file, sync_interval)
+
+}  // namespace fastchess::config
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <cstdint>
+#include <optional>
 #include <string>
 #include <utility>
 #include <vector>
@@ -38,6 +39,20 @@ struct MoveData {
     uint64_t tbhits        = 0;
     bool legal             = true;
     bool book              = false;
+
+    // cpu time and preemptions of the engine during the search, only with -pgnout usage=true
+    int64_t cpu_millis            = 0;
+    uint64_t involuntary_switches = 0;
+
+    // time on the clock of the engine when it started the search, 0 without a clock
+    int64_t clock_millis = 0;
+};
+
+// A position which was searched by an engine during the game, used for the data output.
+struct PositionData {
+    std::string fen;
+    // score in centipawns from white's point of view
+    int score = 0;
 };
 
 enum class MatchTermination {
@@ -47,14 +62,43 @@ enum class MatchTermination {
     DISCONNECT,
     ILLEGAL_MOVE,
     INTERRUPT,
+    // the engine broke a limit of its sandbox
+    RESOURCE_LIMIT,
     None,
 };
 
+// Accounting of an engine's sandbox during one game.
+struct ResourceUsage {
+    int64_t cpu_millis       = 0;
+    int64_t throttled_millis = 0;
+
+    // largest memory use since the engine was started, in MiB
+    uint64_t memory_peak = 0;
+};
+
+// Accounting of an engine process by the kernel during one game.
+struct ProcessUsage {
+    int64_t user_millis   = 0;
+    int64_t system_millis = 0;
+
+    uint64_t voluntary_switches   = 0;
+    uint64_t involuntary_switches = 0;
+
+    // largest resident set since the engine was started, in MiB
+    uint64_t max_rss = 0;
+};
+
 struct MatchData {
     struct PlayerInfo {
         EngineConfiguration config;
         chess::GameResult result = chess::GameResult::NONE;
         chess::Color color       = chess::Color::NONE;
+
+        // only with a sandbox
+        std::optional<ResourceUsage> usage;
+
+        // only where the kernel accounts for it
+        std::optional<ProcessUsage> process;
     };
 
     MatchData() {}
@@ -78,6 +122,9 @@ struct MatchData {
 
     std::vector<MoveData> moves;
 
+    // Positions which passed the data output filters, only filled when -dataout is used.
+    std::vector<PositionData> positions;
+
     // This is the reason why the game ended.
     // It will be used for the PGN Header.
     MatchTermination termination = MatchTermination::None;
@@ -0,0 +1,21 @@
+#pragma once
+
+#include <string>
+
+#include <util/helper.hpp>
+
+namespace fastchess::config {
+
+// Prometheus metrics of the tournament, served over HTTP on host:port and/or written to file.
+// A port of 0 and an empty file disable them.
+struct Metrics {
+    std::string host = "127.0.0.1";
+    int port         = 0;
+
+    std::string file;
+    // seconds between two rewrites of the file
+    int interval = 5;
+};
+NLOHMANN_DEFINE_TYPE_NON_INTRUSIVE_ORDERED_JSON(Metrics, host, port, file, interval)
+
+}  // namespace fastchess::config
@@ -18,9 +18,10 @@ struct Pgn {
     bool track_nps        = false;
     bool track_hashfull   = false;
     bool track_tbhits     = false;
+    bool track_usage      = false;
     bool min              = false;
 };
 NLOHMANN_DEFINE_TYPE_NON_INTRUSIVE_ORDERED_JSON(Pgn, event_name, site, file, notation, track_nodes, track_seldepth,
-                                                track_nps, track_hashfull, track_tbhits, min)
+                                                track_nps, track_hashfull, track_tbhits, track_usage, min)
 
 }  // namespace fastchess::config
\ No newline at end of file
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <cstddef>
+
+#include <types/enums.hpp>
+#include <util/helper.hpp>
+
+namespace fastchess::config {
+
+// Splits one tournament into independent slices. The rounds are distributed round robin
+// over the shards, both games of a round and its opening stay in the same shard.
+struct Shard {
+    // 1 based index of this shard
+    int index = 1;
+    int total = 1;
+
+    [[nodiscard]] bool owns(std::size_t round_id) const noexcept {
+        return round_id % static_cast<std::size_t>(total) == static_cast<std::size_t>(index - 1);
+    }
+
+    // number of rounds this shard plays out of all rounds of the tournament
+    [[nodiscard]] int rounds(int all_rounds) const noexcept { return (all_rounds - index + total) / total; }
+};
+NLOHMANN_DEFINE_TYPE_NON_INTRUSIVE_ORDERED_JSON(Shard, index, total)
+
+}  // namespace fastchess::config
@@ -5,16 +5,22 @@
 #include <util/helper.hpp>
 #include <util/rand.hpp>
 
+#include <types/data_out.hpp>
+#include <types/distributed.hpp>
 #include <types/draw_adjudication.hpp>
 #include <types/engine_config.hpp>
 #include <types/enums.hpp>
 #include <types/epd.hpp>
+#include <types/journal.hpp>
 #include <types/log.hpp>
 #include <types/max_moves_adjudication.hpp>
+#include <types/metrics.hpp>
 #include <types/opening.hpp>
 #include <types/pgn.hpp>
 #include <types/resign_adjudication.hpp>
+#include <types/shard.hpp>
 #include <types/sprt.hpp>
+#include <types/trace.hpp>
 
 namespace fastchess::config {
 
@@ -23,16 +29,36 @@ struct Tournament {
     Pgn pgn         = {};
     Epd epd         = {};
 
+    DataOut dataout = {};
+
+    Journal journal = {};
+
     Sprt sprt = {};
 
+    Shard shard = {};
+
+    Coordinator coordinator = {};
+
     std::string config_name;
 
+    // file of the json output, empty for stdout
+    std::string output_file;
+    // a line per game with the status output
+    bool output_games = false;
+
     DrawAdjudication draw         = {};
     ResignAdjudication resign     = {};
     MaxMovesAdjudication maxmoves = {};
 
     VariantType variant = VariantType::STANDARD;
 
+    // a gauntlet plays the first engine against each of the others
+    TournamentType type = TournamentType::ROUNDROBIN;
+
+    // an adaptive round robin stops once the engines adjacent in the ranking are separated
+    // by this 95% error bar in Elo
+    double errorbar = 10.0;
+
 #ifdef USE_CUTE
     // output format, fastchess or cutechess
     OutputType output    = OutputType::CUTECHESS;
@@ -58,15 +84,31 @@ struct Tournament {
     int concurrency = 1;
     int overhead    = 0;
 
+    // concurrency is only the upper bound, the games played at once follow the load
+    bool autoconcurrency = false;
+
+    // share of the game slots when several tournaments run in one process
+    int weight = 1;
+
+    // engine processes kept running, at least two per game slot, 0 for exactly that many
+    int maxengines = 0;
+
     bool noswap   = false;
     bool recover  = false;
     bool affinity = false;
 
-    Log log = {};
+    // the engines of a game share one set of processors or each get their own
+    AffinityPolicy affinity_policy = AffinityPolicy::SHARED;
+
+    Log log         = {};
+    Trace trace     = {};
+    Metrics metrics = {};
 };
-NLOHMANN_DEFINE_TYPE_NON_INTRUSIVE_ORDERED_JSON(Tournament, resign, draw, maxmoves, opening, pgn, epd, sprt,
-                                                config_name, output, seed, variant, ratinginterval, scoreinterval,
-                                                autosaveinterval, games, rounds, concurrency, overhead, recover, noswap,
-                                                report_penta, affinity, log)
+NLOHMANN_DEFINE_TYPE_NON_INTRUSIVE_ORDERED_JSON(Tournament, resign, draw, maxmoves, opening, pgn, epd, dataout, journal,
+                                                sprt, shard, coordinator, config_name, output, output_file,
+                                                output_games, seed, variant, type, errorbar, ratinginterval,
+                                                scoreinterval, autosaveinterval, games, rounds, concurrency,
+                                                autoconcurrency, overhead, weight, maxengines, recover, noswap,
+                                                report_penta, affinity, affinity_policy, log, trace, metrics)
 
 }  // namespace fastchess::config
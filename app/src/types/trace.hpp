@@ -0,0 +1,15 @@
+#pragma once
+
+#include <string>
+
+#include <util/helper.hpp>
+
+namespace fastchess::config {
+
+struct Trace {
+    // trace event json of the spans of every thread, nothing is traced without it
+    std::string file;
+};
+NLOHMANN_DEFINE_TYPE_NON_INTRUSIVE_ORDERED_JSON(Trace, file)
+
+}  // namespace fastchess::config
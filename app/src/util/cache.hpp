@@ -1,9 +1,10 @@
 #pragma once
 
 #include <atomic>
-#include <deque>
+#include <cstdint>
 #include <functional>
 #include <iostream>
+#include <list>
 #include <mutex>
 
 #include <util/scope_guard.hpp>
@@ -24,6 +25,7 @@ class CachedEntry : public ScopeEntry {
    private:
     T entry_;
     ID id;
+    std::uint64_t last_used_ = 0;
 
     template <typename TT, typename II>
     friend class CachePool;
@@ -31,28 +33,67 @@ class CachedEntry : public ScopeEntry {
 
 // CachePool is a pool of objects which can be reused. An object is indentified by an ID
 // type and value. The pool is thread safe.
+// With a capacity the pool keeps at most that many objects, a new one replaces the least
+// recently used object which isn't in use. Objects in use are never destroyed, so the pool
+// grows beyond its capacity if all of them are taken, and shrinks again once they are
+// released.
 template <typename T, typename ID>
 class CachePool {
    public:
+    // 0 for no limit
+    explicit CachePool(std::size_t capacity = 0) : capacity_(capacity) {}
+
     template <typename... ARGS>
     [[nodiscard]] CachedEntry<T, ID> &getEntry(const ID &identifier, ARGS &&...arg) {
+        // destroyed after the lock is released, stopping an engine takes a while
+        std::list<CachedEntry<T, ID>> evicted;
+
         std::lock_guard<std::mutex> lock(access_mutex_);
 
         for (auto &entry : cache_) {
             if (entry.available_ && entry.id == identifier) {
                 // block the entry from being used by other threads
                 entry.available_ = false;
+                entry.last_used_ = ++clock_;
                 return entry;
             }
         }
 
+        // after a burst of entries in use, the pool shrinks back to its capacity
+        while (capacity_ > 0 && cache_.size() >= capacity_) {
+            auto lru = cache_.end();
+
+            for (auto it = cache_.begin(); it != cache_.end(); ++it) {
+                if (it->available_ && (lru == cache_.end() || it->last_used_ < lru->last_used_)) lru = it;
+            }
+
+            if (lru == cache_.end()) break;
+
+            evicted.splice(evicted.end(), cache_, lru);
+        }
+
+        // a list, references to the other entries must stay valid when one is evicted
         cache_.emplace_back(identifier, std::forward<ARGS>(arg)...);
+        cache_.back().last_used_ = ++clock_;
         return cache_.back();
     }
 
+    void setCapacity(std::size_t capacity) {
+        std::lock_guard<std::mutex> lock(access_mutex_);
+        capacity_ = capacity;
+    }
+
+    // Number of objects in the pool, in use or not.
+    [[nodiscard]] std::size_t size() {
+        std::lock_guard<std::mutex> lock(access_mutex_);
+        return cache_.size();
+    }
+
    private:
-    std::deque<CachedEntry<T, ID>> cache_;
+    std::list<CachedEntry<T, ID>> cache_;
     std::mutex access_mutex_;
+    std::size_t capacity_;
+    std::uint64_t clock_ = 0;
 };
 
 }  // namespace fastchess::util
\ No newline at end of file
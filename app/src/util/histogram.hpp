@@ -0,0 +1,133 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+namespace fastchess::util {
+
+// Histogram of non negative values with a bounded relative error, like an HDR histogram.
+// Values below 16 are counted exactly, every larger power of two is split into 16 buckets,
+// which keeps the error below 1/16. Recording a value doesn't allocate.
+class Histogram {
+   public:
+    static constexpr int SUB_BITS = 4;
+    static constexpr int MAX_BITS = 40;
+
+    void record(std::uint64_t value) noexcept {
+        value = std::min(value, MAX_VALUE);
+
+        counts_[index(value)]++;
+        count_++;
+        sum_ += value;
+        max_ = std::max(max_, value);
+    }
+
+    void merge(const Histogram &other) noexcept {
+        for (std::size_t i = 0; i < counts_.size(); i++) counts_[i] += other.counts_[i];
+
+        count_ += other.count_;
+        sum_ += other.sum_;
+        max_ = std::max(max_, other.max_);
+    }
+
+    [[nodiscard]] std::uint64_t count() const noexcept { return count_; }
+    [[nodiscard]] std::uint64_t max() const noexcept { return max_; }
+
+    [[nodiscard]] double mean() const noexcept { return count_ > 0 ? double(sum_) / count_ : 0.0; }
+
+    // Largest value of the bucket which holds the percentile, at most the largest recorded value.
+    [[nodiscard]] std::uint64_t percentile(double percent) const noexcept {
+        if (count_ == 0) return 0;
+
+        const auto rank = std::max<std::uint64_t>(1, std::ceil(percent / 100.0 * count_));
+
+        std::uint64_t seen = 0;
+        for (std::size_t i = 0; i < counts_.size(); i++) {
+            seen += counts_[i];
+            if (seen >= rank) return std::min(highest(i), max_);
+        }
+
+        return max_;
+    }
+
+   private:
+    static constexpr std::size_t SUB_BUCKETS = std::size_t(1) << SUB_BITS;
+    static constexpr std::uint64_t MAX_VALUE = (std::uint64_t(1) << MAX_BITS) - 1;
+
+    static std::size_t index(std::uint64_t value) noexcept {
+        if (value < SUB_BUCKETS) return value;
+
+        int msb = SUB_BITS;
+        while (value >> (msb + 1)) msb++;
+
+        // bucket 1 holds 16 to 31 exactly, every further bucket twice the range of the previous one
+        const int shift = msb - SUB_BITS;
+        return (shift + 1) * SUB_BUCKETS + ((value >> shift) & (SUB_BUCKETS - 1));
+    }
+
+    static std::uint64_t highest(std::size_t index) noexcept {
+        const auto bucket = index / SUB_BUCKETS;
+        const auto sub    = index % SUB_BUCKETS;
+
+        if (bucket == 0) return sub;
+
+        const auto shift = bucket - 1;
+        return ((SUB_BUCKETS + sub) << shift) + ((std::uint64_t(1) << shift) - 1);
+    }
+
+    static constexpr std::size_t BUCKETS = (MAX_BITS - SUB_BITS + 1) * SUB_BUCKETS;
+
+    std::array<std::uint64_t, BUCKETS> counts_ = {};
+
+    std::uint64_t count_ = 0;
+    std::uint64_t sum_   = 0;
+    std::uint64_t max_   = 0;
+
+    friend class AtomicHistogram;
+};
+
+// Histogram which is filled and read by different threads without a lock. The buckets are
+// relaxed atomics, so a snapshot taken while a histogram is merged may only hold a part
+// of it.
+class AtomicHistogram {
+   public:
+    void merge(const Histogram &other) noexcept {
+        for (std::size_t i = 0; i < Histogram::BUCKETS; i++) {
+            if (other.counts_[i] > 0) counts_[i].fetch_add(other.counts_[i], std::memory_order_relaxed);
+        }
+
+        count_.fetch_add(other.count_, std::memory_order_relaxed);
+        sum_.fetch_add(other.sum_, std::memory_order_relaxed);
+
+        auto max = max_.load(std::memory_order_relaxed);
+        while (max < other.max_ && !max_.compare_exchange_weak(max, other.max_, std::memory_order_relaxed)) {
+        }
+    }
+
+    [[nodiscard]] Histogram snapshot() const noexcept {
+        Histogram histogram;
+
+        for (std::size_t i = 0; i < Histogram::BUCKETS; i++) {
+            histogram.counts_[i] = counts_[i].load(std::memory_order_relaxed);
+        }
+
+        histogram.count_ = count_.load(std::memory_order_relaxed);
+        histogram.sum_   = sum_.load(std::memory_order_relaxed);
+        histogram.max_   = max_.load(std::memory_order_relaxed);
+
+        return histogram;
+    }
+
+   private:
+    std::array<std::atomic<std::uint64_t>, Histogram::BUCKETS> counts_ = {};
+
+    std::atomic<std::uint64_t> count_ = 0;
+    std::atomic<std::uint64_t> sum_   = 0;
+    std::atomic<std::uint64_t> max_   = 0;
+};
+
+}  // namespace fastchess::util
@@ -20,6 +20,9 @@ std::atomic_bool Logger::should_log_ = false;
 std::mutex Logger::log_mutex_;
 Logger::log_file_type Logger::log_;
 
+std::function<void(const std::string &)> Logger::console_;
+std::mutex Logger::console_mutex_;
+
 void Logger::openFile(const std::string &file) {
 #ifdef USE_ZLIB
     if (compress_) {
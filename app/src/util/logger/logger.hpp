@@ -2,6 +2,7 @@
 
 #include <atomic>
 #include <fstream>
+#include <functional>
 #include <iostream>
 #include <mutex>
 #include <sstream>
@@ -42,6 +43,13 @@ class Logger {
 
     static void openFile(const std::string &file);
 
+    // Receives the messages which would go to stdout, for outputs which need stdout for
+    // themselves. nullptr restores stdout.
+    static void setConsole(std::function<void(const std::string &)> console) {
+        const std::lock_guard<std::mutex> lock(console_mutex_);
+        console_ = std::move(console);
+    }
+
     template <bool thread = false, typename... T>
     static void trace(fmt::format_string<T...> format, T &&...args) {
         log<Level::TRACE, thread>(format, std::forward<T>(args)...);
@@ -84,7 +92,13 @@ class Logger {
         const auto message = fmt::format(format, std::forward<T>(args)...) + "\n";
 
         if (level >= Level::WARN) {
-            std::cout << message << std::flush;
+            const std::lock_guard<std::mutex> lock(console_mutex_);
+
+            if (console_) {
+                console_(message);
+            } else {
+                std::cout << message << std::flush;
+            }
         }
 
         if (!should_log_) {
@@ -134,6 +148,9 @@ class Logger {
 
     static log_file_type log_;
     static std::mutex log_mutex_;
+
+    static std::function<void(const std::string &)> console_;
+    static std::mutex console_mutex_;
 };
 
 }  // namespace fastchess
@@ -0,0 +1,115 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+
+#include <types/engine_config.hpp>
+#include <util/logger/logger.hpp>
+
+#ifndef _WIN32
+#    include <pthread.h>
+#    include <sched.h>
+#    include <sys/resource.h>
+#    include <sys/types.h>
+#    include <unistd.h>
+#endif
+
+#ifdef __linux__
+#    include <sys/syscall.h>
+#endif
+
+namespace fastchess::scheduling {
+
+#ifndef _WIN32
+
+// Applies the niceness and the policy to a process. On Linux both only change its main thread,
+// the threads it starts later inherit them.
+[[nodiscard]] inline bool setProcess(pid_t pid, const Scheduling &scheduling) {
+    bool ok = true;
+
+    if (scheduling.nice != 0) ok &= setpriority(PRIO_PROCESS, pid, scheduling.nice) == 0;
+
+#    ifdef __linux__
+    if (scheduling.policy != SchedulingPolicy::OTHER) {
+        sched_param param{};
+        param.sched_priority = scheduling.priority;
+
+        const auto policy = scheduling.policy == SchedulingPolicy::FIFO ? SCHED_FIFO : SCHED_RR;
+        ok &= sched_setscheduler(pid, policy, &param) == 0;
+    }
+#    endif
+
+    return ok;
+}
+
+#endif
+
+// Keeps the thread which plays a game ahead of its engines while it lives, an arbiter which
+// waits for a real time engine to yield would flag it on time. Engines with a raised niceness
+// are already behind it.
+class ArbiterPriority {
+   public:
+    ArbiterPriority(const Scheduling &white, const Scheduling &black) {
+#ifdef __linux__
+        const auto realtime = std::max(realtimePriority(white), realtimePriority(black));
+
+        if (realtime > 0 && pthread_getschedparam(pthread_self(), &policy_, &param_) == 0) {
+            sched_param param{};
+            param.sched_priority = std::min(realtime + 1, sched_get_priority_max(SCHED_FIFO));
+
+            raised_policy_ = pthread_setschedparam(pthread_self(), SCHED_FIFO, &param) == 0;
+            if (!raised_policy_) warn();
+        }
+
+        const auto nice = std::min(white.nice, black.nice);
+
+        if (nice < 0) {
+            // the niceness of a thread is set through its thread id
+            tid_  = static_cast<pid_t>(syscall(SYS_gettid));
+            nice_ = getpriority(PRIO_PROCESS, tid_);
+
+            raised_nice_ = setpriority(PRIO_PROCESS, tid_, std::max(-20, nice - 1)) == 0;
+            if (!raised_nice_) warn();
+        }
+#else
+        (void)white;
+        (void)black;
+#endif
+    }
+
+    ~ArbiterPriority() {
+#ifdef __linux__
+        if (raised_policy_) pthread_setschedparam(pthread_self(), policy_, &param_);
+        if (raised_nice_) setpriority(PRIO_PROCESS, tid_, nice_);
+#endif
+    }
+
+    ArbiterPriority(const ArbiterPriority &)            = delete;
+    ArbiterPriority &operator=(const ArbiterPriority &) = delete;
+
+   private:
+#ifdef __linux__
+    static int realtimePriority(const Scheduling &scheduling) {
+        return scheduling.policy == SchedulingPolicy::OTHER ? 0 : scheduling.priority;
+    }
+
+    static void warn() {
+        static std::atomic_bool warned = false;
+        if (warned.exchange(true)) return;
+
+        Logger::warn(
+            "Warning; Cannot raise the priority of the game threads above the engines, they may be flagged on "
+            "time when they don't yield.");
+    }
+
+    int policy_ = SCHED_OTHER;
+    sched_param param_{};
+    bool raised_policy_ = false;
+
+    pid_t tid_        = 0;
+    int nice_         = 0;
+    bool raised_nice_ = false;
+#endif
+};
+
+}  // namespace fastchess::scheduling
@@ -0,0 +1,329 @@
+#pragma once
+
+#include <chrono>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+#ifdef _WIN64
+#    include <winsock2.h>
+#    include <ws2tcpip.h>
+#else
+#    include <arpa/inet.h>
+#    include <fcntl.h>
+#    include <netdb.h>
+#    include <netinet/in.h>
+#    include <netinet/tcp.h>
+#    include <poll.h>
+#    include <sys/socket.h>
+#    include <sys/un.h>
+#    include <unistd.h>
+#endif
+
+namespace fastchess::util::net {
+
+#ifdef _WIN64
+using socket_t                    = SOCKET;
+constexpr socket_t INVALID_HANDLE = INVALID_SOCKET;
+#else
+using socket_t                    = int;
+constexpr socket_t INVALID_HANDLE = -1;
+#endif
+
+// Blocking TCP or Unix domain socket which exchanges newline terminated messages.
+class Socket {
+   public:
+    Socket() = default;
+    explicit Socket(socket_t handle) : handle_(handle) {
+#ifndef _WIN64
+        // engines are spawned by the same process, they must not keep the connection alive
+        if (valid()) fcntl(handle_, F_SETFD, FD_CLOEXEC);
+#endif
+    }
+
+    ~Socket() { close(); }
+
+    Socket(const Socket &)            = delete;
+    Socket &operator=(const Socket &) = delete;
+
+    Socket(Socket &&other) noexcept { *this = std::move(other); }
+
+    Socket &operator=(Socket &&other) noexcept {
+        if (this == &other) return *this;
+
+        close();
+        handle_ = std::exchange(other.handle_, INVALID_HANDLE);
+        buffer_ = std::move(other.buffer_);
+        return *this;
+    }
+
+    // Creates a listening socket, port 0 picks a free port.
+    [[nodiscard]] static Socket listen(const std::string &host, int port) {
+        startup();
+
+        auto address = resolve(host, port, true);
+        Socket socket(::socket(address->ai_family, SOCK_STREAM, IPPROTO_TCP));
+
+        if (!socket.valid()) {
+            freeaddrinfo(address);
+            throw std::runtime_error("Error; Could not create socket.");
+        }
+
+        int reuse = 1;
+        setsockopt(socket.handle_, SOL_SOCKET, SO_REUSEADDR, reinterpret_cast<const char *>(&reuse), sizeof(reuse));
+
+        const auto bound = ::bind(socket.handle_, address->ai_addr, static_cast<int>(address->ai_addrlen)) == 0;
+        freeaddrinfo(address);
+
+        if (!bound || ::listen(socket.handle_, SOMAXCONN) != 0) {
+            throw std::runtime_error("Error; Could not listen on " + host + ":" + std::to_string(port) + ".");
+        }
+
+        return socket;
+    }
+
+    [[nodiscard]] static Socket connect(const std::string &host, int port) {
+        startup();
+
+        auto address = resolve(host, port, false);
+        Socket socket;
+
+        for (auto *info = address; info != nullptr; info = info->ai_next) {
+            socket = Socket(::socket(info->ai_family, SOCK_STREAM, IPPROTO_TCP));
+            if (!socket.valid()) continue;
+
+            if (::connect(socket.handle_, info->ai_addr, static_cast<int>(info->ai_addrlen)) == 0) break;
+
+            socket.close();
+        }
+
+        freeaddrinfo(address);
+
+        if (!socket.valid()) {
+            throw std::runtime_error("Error; Could not connect to " + host + ":" + std::to_string(port) + ".");
+        }
+
+        socket.configure();
+
+        return socket;
+    }
+
+    // Creates a listening Unix domain socket, a stale socket file of a previous run is replaced.
+    [[nodiscard]] static Socket listenUnix(const std::string &path) {
+#ifdef _WIN64
+        (void)path;
+        throw std::runtime_error("Error; Unix domain sockets are not supported on Windows.");
+#else
+        const auto address = unixAddress(path);
+        Socket socket(::socket(AF_UNIX, SOCK_STREAM, 0));
+
+        if (!socket.valid()) throw std::runtime_error("Error; Could not create socket.");
+
+        ::unlink(path.c_str());
+
+        if (::bind(socket.handle_, reinterpret_cast<const sockaddr *>(&address), sizeof(address)) != 0 ||
+            ::listen(socket.handle_, SOMAXCONN) != 0) {
+            throw std::runtime_error("Error; Could not listen on " + path + ".");
+        }
+
+        return socket;
+#endif
+    }
+
+    [[nodiscard]] static Socket connectUnix(const std::string &path) {
+#ifdef _WIN64
+        (void)path;
+        throw std::runtime_error("Error; Unix domain sockets are not supported on Windows.");
+#else
+        const auto address = unixAddress(path);
+        Socket socket(::socket(AF_UNIX, SOCK_STREAM, 0));
+
+        if (!socket.valid() ||
+            ::connect(socket.handle_, reinterpret_cast<const sockaddr *>(&address), sizeof(address)) != 0) {
+            throw std::runtime_error("Error; Could not connect to " + path + ".");
+        }
+
+        return socket;
+#endif
+    }
+
+    // Waits up to timeout for a new connection, returns an invalid socket if there was none.
+    [[nodiscard]] Socket accept(std::chrono::milliseconds timeout) {
+        if (!readable(timeout)) return Socket();
+
+        Socket client(::accept(handle_, nullptr, nullptr));
+        if (client.valid()) client.configure();
+
+        return client;
+    }
+
+    // Sends the message followed by a newline, returns false if the connection is broken.
+    bool send(const std::string &message) {
+        const auto line = message + "\n";
+
+        std::size_t sent = 0;
+        while (sent < line.size()) {
+            const auto n = ::send(handle_, line.data() + sent, static_cast<int>(line.size() - sent), SEND_FLAGS);
+            if (n <= 0) return false;
+            sent += static_cast<std::size_t>(n);
+        }
+
+        return true;
+    }
+
+    // Blocks until a complete line was received, returns false if the connection was closed.
+    bool receive(std::string &line) {
+        while (true) {
+            const auto pos = buffer_.find('\n');
+
+            if (pos != std::string::npos) {
+                line = buffer_.substr(0, pos);
+                buffer_.erase(0, pos + 1);
+                return true;
+            }
+
+            char chunk[4096];
+            const auto n = ::recv(handle_, chunk, sizeof(chunk), 0);
+            if (n <= 0) return false;
+
+            buffer_.append(chunk, static_cast<std::size_t>(n));
+        }
+    }
+
+    // Port the socket is bound to.
+    [[nodiscard]] int port() const {
+        sockaddr_storage address = {};
+        socklen_t length         = sizeof(address);
+
+        if (getsockname(handle_, reinterpret_cast<sockaddr *>(&address), &length) != 0) return 0;
+
+        if (address.ss_family == AF_INET6) return ntohs(reinterpret_cast<sockaddr_in6 *>(&address)->sin6_port);
+        return ntohs(reinterpret_cast<sockaddr_in *>(&address)->sin_port);
+    }
+
+    // Address of the connected peer.
+    [[nodiscard]] std::string peer() const {
+        sockaddr_storage address = {};
+        socklen_t length         = sizeof(address);
+
+        if (getpeername(handle_, reinterpret_cast<sockaddr *>(&address), &length) != 0) return "unknown";
+
+        char host[NI_MAXHOST], service[NI_MAXSERV];
+        if (getnameinfo(reinterpret_cast<sockaddr *>(&address), length, host, sizeof(host), service, sizeof(service),
+                        NI_NUMERICHOST | NI_NUMERICSERV) != 0) {
+            return "unknown";
+        }
+
+        return std::string(host) + ":" + service;
+    }
+
+    // Lets receive fail once no data arrived for the timeout, a client which never sends
+    // would block it forever otherwise.
+    void setReceiveTimeout(std::chrono::milliseconds timeout) noexcept {
+#ifdef _WIN64
+        const DWORD value = static_cast<DWORD>(timeout.count());
+#else
+        timeval value = {};
+        value.tv_sec  = static_cast<time_t>(timeout.count() / 1000);
+        value.tv_usec = static_cast<suseconds_t>(timeout.count() % 1000 * 1000);
+#endif
+        setsockopt(handle_, SOL_SOCKET, SO_RCVTIMEO, reinterpret_cast<const char *>(&value), sizeof(value));
+    }
+
+    // Wakes up a thread which is blocked in receive.
+    void shutdown() noexcept {
+        if (!valid()) return;
+#ifdef _WIN64
+        ::shutdown(handle_, SD_BOTH);
+#else
+        ::shutdown(handle_, SHUT_RDWR);
+#endif
+    }
+
+    void close() noexcept {
+        if (!valid()) return;
+#ifdef _WIN64
+        closesocket(handle_);
+#else
+        ::close(handle_);
+#endif
+        handle_ = INVALID_HANDLE;
+    }
+
+    [[nodiscard]] bool valid() const noexcept { return handle_ != INVALID_HANDLE; }
+
+   private:
+#ifdef _WIN64
+    static constexpr int SEND_FLAGS = 0;
+#else
+    // a closed peer should fail the send instead of killing the process
+    static constexpr int SEND_FLAGS = MSG_NOSIGNAL;
+#endif
+
+    void configure() noexcept {
+        // the messages are small and latency matters more than throughput
+        int nodelay = 1;
+        setsockopt(handle_, IPPROTO_TCP, TCP_NODELAY, reinterpret_cast<const char *>(&nodelay), sizeof(nodelay));
+
+        // notice peers which vanished without closing the connection
+        int keepalive = 1;
+        setsockopt(handle_, SOL_SOCKET, SO_KEEPALIVE, reinterpret_cast<const char *>(&keepalive), sizeof(keepalive));
+    }
+
+    static void startup() {
+#ifdef _WIN64
+        static const bool initialized = []() {
+            WSADATA data;
+            return WSAStartup(MAKEWORD(2, 2), &data) == 0;
+        }();
+
+        if (!initialized) throw std::runtime_error("Error; Could not initialize Winsock.");
+#endif
+    }
+
+    [[nodiscard]] static addrinfo *resolve(const std::string &host, int port, bool passive) {
+        addrinfo hints    = {};
+        hints.ai_family   = AF_UNSPEC;
+        hints.ai_socktype = SOCK_STREAM;
+        hints.ai_flags    = passive ? AI_PASSIVE : 0;
+
+        addrinfo *result = nullptr;
+        if (getaddrinfo(host.empty() ? nullptr : host.c_str(), std::to_string(port).c_str(), &hints, &result) != 0) {
+            throw std::runtime_error("Error; Could not resolve address " + host + ".");
+        }
+
+        return result;
+    }
+
+#ifndef _WIN64
+    [[nodiscard]] static sockaddr_un unixAddress(const std::string &path) {
+        sockaddr_un address = {};
+        address.sun_family  = AF_UNIX;
+
+        if (path.empty() || path.size() >= sizeof(address.sun_path)) {
+            throw std::runtime_error("Error; Invalid socket path " + path + ".");
+        }
+
+        path.copy(address.sun_path, path.size());
+
+        return address;
+    }
+#endif
+
+    [[nodiscard]] bool readable(std::chrono::milliseconds timeout) const {
+#ifdef _WIN64
+        WSAPOLLFD fd = {handle_, POLLRDNORM, 0};
+        return WSAPoll(&fd, 1, static_cast<int>(timeout.count())) > 0;
+#else
+        pollfd fd = {handle_, POLLIN, 0};
+        return poll(&fd, 1, static_cast<int>(timeout.count())) > 0;
+#endif
+    }
+
+    socket_t handle_ = INVALID_HANDLE;
+
+    // received data which doesn't form a complete line yet
+    std::string buffer_;
+};
+
+}  // namespace fastchess::util::net
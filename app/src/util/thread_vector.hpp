@@ -49,6 +49,11 @@ class ThreadVector {
         return vec_.erase(std::remove_if(vec_.begin(), vec_.end(), PREDICATE), vec_.end());
     }
 
+    [[nodiscard]] std::size_t size() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return vec_.size();
+    }
+
     // Not thread safe!
     auto begin() noexcept { return vec_.begin(); }
 
@@ -0,0 +1,137 @@
+#include <util/tracer/tracer.hpp>
+
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+
+#ifdef __linux__
+#    include <sched.h>
+#endif
+
+namespace fastchess {
+
+std::atomic_bool Tracer::enabled_ = false;
+
+std::mutex Tracer::mutex_;
+std::ofstream Tracer::file_;
+Tracer::clock::time_point Tracer::epoch_;
+bool Tracer::empty_  = true;
+int Tracer::threads_ = 0;
+
+std::uint64_t Tracer::async_ids_ = 0;
+
+namespace {
+// the trace a thread got its id in, ids start over with every file
+thread_local int trace_session = 0;
+thread_local int trace_tid     = 0;
+
+int session = 0;
+
+std::int64_t micros(Tracer::clock::duration duration) {
+    return std::chrono::duration_cast<std::chrono::microseconds>(duration).count();
+}
+}  // namespace
+
+void Tracer::openFile(const std::string &file) {
+    if (file.empty()) return;
+
+    const std::lock_guard<std::mutex> lock(mutex_);
+
+    if (file_.is_open()) file_.close();
+
+    file_.open(file, std::ios::out | std::ios::trunc);
+    if (!file_.is_open()) throw std::runtime_error("Error; Cannot open the trace file " + file);
+
+    file_ << "[";
+
+    epoch_     = clock::now();
+    empty_     = true;
+    threads_   = 0;
+    async_ids_ = 0;
+    session++;
+
+    enabled_ = true;
+}
+
+void Tracer::closeFile() {
+    const std::lock_guard<std::mutex> lock(mutex_);
+
+    if (!enabled_) return;
+    enabled_ = false;
+
+    file_ << "\n]\n";
+    file_.close();
+}
+
+void Tracer::complete(std::string_view name, std::string_view category, clock::time_point begin,
+                      clock::time_point end, nlohmann::ordered_json args) {
+    if (!enabled()) return;
+
+#ifdef __linux__
+    args["cpu"] = sched_getcpu();
+#endif
+
+    const std::lock_guard<std::mutex> lock(mutex_);
+
+    if (!enabled_) return;
+
+    write({{"name", name},
+           {"cat", category},
+           {"ph", "X"},
+           {"ts", micros(begin - epoch_)},
+           {"dur", micros(end - begin)},
+           {"pid", 1},
+           {"tid", threadId()},
+           {"args", std::move(args)}});
+}
+
+void Tracer::async(std::string_view name, std::string_view category, clock::time_point begin, clock::time_point end,
+                   nlohmann::ordered_json args) {
+    if (!enabled()) return;
+
+    const std::lock_guard<std::mutex> lock(mutex_);
+
+    if (!enabled_) return;
+
+    const auto id  = ++async_ids_;
+    const auto tid = threadId();
+
+    write({{"name", name},
+           {"cat", category},
+           {"ph", "b"},
+           {"ts", micros(begin - epoch_)},
+           {"pid", 1},
+           {"tid", tid},
+           {"id", id},
+           {"args", std::move(args)}});
+
+    write({{"name", name},
+           {"cat", category},
+           {"ph", "e"},
+           {"ts", micros(end - epoch_)},
+           {"pid", 1},
+           {"tid", tid},
+           {"id", id}});
+}
+
+int Tracer::threadId() {
+    if (trace_session == session) return trace_tid;
+
+    trace_session = session;
+    trace_tid     = ++threads_;
+
+    // the thread id of the log file, to find the lines of a span
+    std::ostringstream id;
+    id << "thread " << std::this_thread::get_id();
+
+    write({{"name", "thread_name"}, {"ph", "M"}, {"pid", 1}, {"tid", trace_tid}, {"args", {{"name", id.str()}}}});
+
+    return trace_tid;
+}
+
+void Tracer::write(const nlohmann::ordered_json &event) {
+    file_ << (empty_ ? "\n" : ",\n") << event.dump();
+    empty_ = false;
+}
+
+}  // namespace fastchess
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <string_view>
+
+#include <json.hpp>
+
+namespace fastchess {
+
+// Singleton class which records what the threads are doing as spans in the trace event format,
+// chrome://tracing and ui.perfetto.dev show them on a timeline per thread. Nothing is recorded
+// before a file is opened.
+class Tracer {
+   public:
+    using clock = std::chrono::steady_clock;
+
+    // A span of the calling thread from the construction to the destruction.
+    class Span {
+       public:
+        Span(std::string_view name, std::string_view category) {
+            if (!Tracer::enabled()) return;
+
+            name_     = name;
+            category_ = category;
+            begin_    = clock::now();
+            active_   = true;
+        }
+
+        ~Span() {
+            if (active_) Tracer::complete(name_, category_, begin_, clock::now(), std::move(args_));
+        }
+
+        Span(const Span &)            = delete;
+        Span &operator=(const Span &) = delete;
+
+        template <typename T>
+        void arg(const std::string &key, T &&value) {
+            if (active_) args_[key] = std::forward<T>(value);
+        }
+
+       private:
+        std::string name_;
+        std::string category_;
+        clock::time_point begin_;
+        nlohmann::ordered_json args_ = nlohmann::ordered_json::object();
+        bool active_                 = false;
+    };
+
+    Tracer(Tracer const &) = delete;
+
+    void operator=(Tracer const &) = delete;
+
+    static void openFile(const std::string &file);
+
+    // Ends the json array, viewers also open a trace which was cut off.
+    static void closeFile();
+
+    [[nodiscard]] static bool enabled() noexcept { return enabled_.load(std::memory_order_relaxed); }
+
+    // Records a span of the calling thread, the processor it ended on is added to the arguments.
+    static void complete(std::string_view name, std::string_view category, clock::time_point begin,
+                         clock::time_point end, nlohmann::ordered_json args = nlohmann::ordered_json::object());
+
+    // Records a span which doesn't belong to the calling thread, like the wait of a queued game.
+    // Viewers show it on a track of its own.
+    static void async(std::string_view name, std::string_view category, clock::time_point begin,
+                      clock::time_point end, nlohmann::ordered_json args = nlohmann::ordered_json::object());
+
+   private:
+    Tracer() = default;
+
+    static void write(const nlohmann::ordered_json &event);
+
+    // names the calling thread in the trace the first time it records a span
+    static int threadId();
+
+    static std::atomic_bool enabled_;
+
+    static std::mutex mutex_;
+    static std::ofstream file_;
+    static clock::time_point epoch_;
+    static bool empty_;
+    static int threads_;
+    static std::uint64_t async_ids_;
+};
+
+}  // namespace fastchess
@@ -0,0 +1,109 @@
+#include <affinity/affinity_manager.hpp>
+
+#include <cstdio>
+#include <fstream>
+#include <vector>
+
+#include "doctest/doctest.hpp"
+
+using namespace fastchess;
+
+namespace {
+
+// one socket with two L3 caches of four cores, the second hyperthread of core i is i + 8
+affinity::cpu_info::CpuInfo machine() {
+    affinity::cpu_info::CpuInfo cpu_info;
+
+    for (int i = 0; i < 8; i++) {
+        affinity::cpu_info::CpuInfo::PhysicalCpu::Core core = {i, {i, i + 8}};
+
+        core.cache_id = i < 4 ? 0 : 4;
+        core.node_id  = 0;
+
+        cpu_info.physical_cpus[0].cores[i] = core;
+    }
+
+    return cpu_info;
+}
+
+}  // namespace
+
+TEST_SUITE("Affinity Manager") {
+    TEST_CASE("Games get whole cores of one L3 cache") {
+        affinity::AffinityManager manager(machine(), 4, 2);
+
+        auto &first = manager.consume();
+        CHECK(first.cpus == std::vector<int>{0, 1, 2, 3});
+        CHECK(first.domain == std::vector<int>{0, 8, 1, 9, 2, 10, 3, 11});
+
+        CHECK(manager.consume().cpus == std::vector<int>{4, 5, 6, 7});
+
+        // the idle hyperthreads are not given to other games
+        CHECK_THROWS(static_cast<void>(manager.consume()));
+    }
+
+    TEST_CASE("Hyperthreads of a core go to the same game") {
+        affinity::AffinityManager manager(machine(), 4, 4);
+
+        CHECK(manager.consume().cpus == std::vector<int>{0, 8, 1, 9});
+        CHECK(manager.consume().cpus == std::vector<int>{2, 10, 3, 11});
+        CHECK(manager.consume().cpus == std::vector<int>{4, 12, 5, 13});
+
+        auto &last = manager.consume();
+        CHECK(last.cpus == std::vector<int>{6, 14, 7, 15});
+        CHECK_THROWS(static_cast<void>(manager.consume()));
+
+        last.release();
+        CHECK(manager.consume().cpus == std::vector<int>{6, 14, 7, 15});
+    }
+
+    TEST_CASE("Single threaded games use every hyperthread") {
+        affinity::AffinityManager manager(machine(), 1, 16);
+
+        // the first hyperthreads come first
+        for (int i = 0; i < 8; i++) CHECK(manager.consume().cpus == std::vector<int>{i});
+        for (int i = 8; i < 16; i++) CHECK(manager.consume().cpus == std::vector<int>{i});
+
+        CHECK_THROWS(static_cast<void>(manager.consume()));
+    }
+
+    TEST_CASE("Sets larger than a cache span the socket") {
+        affinity::AffinityManager manager(machine(), 6, 1);
+
+        CHECK(manager.consume().cpus == std::vector<int>{0, 1, 2, 3, 4, 5});
+        CHECK_THROWS(static_cast<void>(manager.consume()));
+    }
+
+    TEST_CASE("Affinity is disabled if a set doesn't fit") {
+        affinity::AffinityManager manager(machine(), 32, 1);
+
+        CHECK(manager.consume().cpus.empty());
+    }
+
+#if !defined(_WIN32) && !defined(__APPLE__)
+    TEST_CASE("Only allowed processors are used") {
+        auto cpu_info = machine();
+        affinity::cpu_info::restrictTo(cpu_info, {0, 1, 8, 9, 10});
+
+        const auto &cores = cpu_info.physical_cpus.at(0).cores;
+        REQUIRE(cores.size() == 3);
+        CHECK(cores.at(0).processors.size() == 2);
+        CHECK(cores.at(2).processors.size() == 1);
+
+        affinity::AffinityManager manager(cpu_info, 1, 3);
+        CHECK(manager.consume().cpus == std::vector<int>{0});
+        CHECK(manager.consume().cpus == std::vector<int>{1});
+        CHECK(manager.consume().cpus == std::vector<int>{10});
+    }
+
+    TEST_CASE("Kernel cpu lists are read") {
+        const auto path = "affinity_test_list.txt";
+        std::ofstream(path) << "0-2,5,7-8\n";
+
+        CHECK(affinity::cpu_info::sysfs::readList(path) == std::vector<int>{0, 1, 2, 5, 7, 8});
+        CHECK(affinity::cpu_info::sysfs::readList("missing_affinity_test_list.txt").empty());
+
+        std::remove(path);
+    }
+#endif
+}
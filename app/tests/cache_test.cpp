@@ -0,0 +1,62 @@
+#include <util/cache.hpp>
+
+#include <string>
+
+#include "doctest/doctest.hpp"
+
+using namespace fastchess;
+
+TEST_SUITE("Cache Pool") {
+    TEST_CASE("Released entries are reused") {
+        util::CachePool<int, std::string> pool;
+
+        auto &first = pool.getEntry("engine", 1);
+        first.release();
+
+        auto &second = pool.getEntry("engine", 2);
+        CHECK(&first == &second);
+        CHECK(second.get() == 1);
+
+        // the entry is in use, another one is created
+        CHECK(pool.getEntry("engine", 3).get() == 3);
+        CHECK(pool.size() == 2);
+    }
+
+    TEST_CASE("The least recently used entry is replaced") {
+        util::CachePool<int, std::string> pool(2);
+
+        auto &a = pool.getEntry("a", 1);
+        auto &b = pool.getEntry("b", 2);
+        a.release();
+        b.release();
+
+        // b is now the least recently used entry
+        pool.getEntry("a", 0).release();
+
+        auto &c = pool.getEntry("c", 3);
+        CHECK(c.get() == 3);
+        CHECK(pool.size() == 2);
+        CHECK(&pool.getEntry("a", 0) == &a);
+
+        // a and c are in use, the pool grows instead of replacing them
+        CHECK(pool.getEntry("b", 4).get() == 4);
+        CHECK(pool.size() == 3);
+    }
+
+    TEST_CASE("The pool shrinks back to its capacity") {
+        util::CachePool<int, std::string> pool(2);
+
+        auto &a = pool.getEntry("a", 1);
+        auto &b = pool.getEntry("b", 2);
+        auto &c = pool.getEntry("c", 3);
+        CHECK(pool.size() == 3);
+
+        a.release();
+        b.release();
+        c.release();
+
+        // a and b, the least recently used ones, make room for the new entry
+        CHECK(pool.getEntry("d", 4).get() == 4);
+        CHECK(pool.size() == 2);
+    }
+}
@@ -0,0 +1,90 @@
+#include <matchmaking/concurrency/controller.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <optional>
+#include <thread>
+#include <vector>
+
+#include "doctest/doctest.hpp"
+
+using namespace fastchess;
+
+namespace {
+
+GameLoad game(bool timeout = false, double overhead = 1.0, int cpu = 1000) {
+    GameLoad load;
+    load.timeout  = timeout;
+    load.thinking = std::chrono::milliseconds(1000);
+    load.cpu      = std::chrono::milliseconds(cpu);
+    load.overhead = overhead;
+    return load;
+}
+
+}  // namespace
+
+TEST_SUITE("Concurrency Controller") {
+    TEST_CASE("The limit rises while the machine is idle") {
+        ConcurrencyController controller(8, []() { return 0.1; });
+        CHECK(controller.limit() == 4);
+
+        // a window is at least 8 games
+        for (int i = 0; i < 8; i++) controller.report(game());
+        CHECK(controller.limit() == 5);
+
+        for (int i = 0; i < 100; i++) controller.report(game());
+        CHECK(controller.limit() == 8);
+    }
+
+    TEST_CASE("Time losses and overload lower the limit") {
+        std::optional<double> load = 0.1;
+        ConcurrencyController controller(8, [&load]() { return load; });
+
+        for (int i = 0; i < 8; i++) controller.report(game(i == 0));
+        CHECK(controller.limit() == 3);
+
+        // the engines get 1 s of cpu time per second of thinking first, then less
+        for (int i = 0; i < 8; i++) controller.report(game());
+        CHECK(controller.limit() == 4);
+
+        for (int i = 0; i < 8; i++) controller.report(game(false, 1.0, 500));
+        CHECK(controller.limit() == 3);
+
+        // a busy machine keeps the limit
+        load = 0.95;
+        for (int i = 0; i < 8; i++) controller.report(game());
+        CHECK(controller.limit() == 3);
+
+        load = 1.5;
+        for (int i = 0; i < 8; i++) controller.report(game());
+        CHECK(controller.limit() == 2);
+
+        // moves take much longer to reach the engines
+        load = std::nullopt;
+        for (int i = 0; i < 8; i++) controller.report(game(false, 50.0));
+        CHECK(controller.limit() == 1);
+    }
+
+    TEST_CASE("Games wait for a free slot") {
+        ConcurrencyController controller(2, []() { return 0.1; });
+        REQUIRE(controller.limit() == 1);
+
+        auto slot = controller.acquire([]() { return false; });
+        REQUIRE(slot.has_value());
+
+        CHECK_FALSE(controller.acquire([]() { return true; }).has_value());
+
+        std::atomic_bool started = false;
+        std::thread waiter([&]() {
+            auto second = controller.acquire([]() { return false; });
+            started     = true;
+        });
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        CHECK_FALSE(started);
+
+        slot.reset();
+        waiter.join();
+        CHECK(started);
+    }
+}
@@ -0,0 +1,144 @@
+#include <matchmaking/daemon/daemon.hpp>
+#include <matchmaking/daemon/scheduler.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include <book/opening_book.hpp>
+
+#include "doctest/doctest.hpp"
+
+using namespace fastchess;
+
+TEST_SUITE("Daemon") {
+    TEST_CASE("Free slots go to the test with the fewest games") {
+        daemon::SlotScheduler scheduler(2);
+
+        int busy = 0, idle = 0;
+        scheduler.add(&busy);
+        scheduler.add(&idle);
+
+        const auto never = []() { return false; };
+
+        // the first test takes both slots while the second has nothing to play
+        auto first  = scheduler.acquire(&busy, never);
+        auto second = scheduler.acquire(&busy, never);
+        REQUIRE(first.has_value());
+        REQUIRE(second.has_value());
+
+        std::atomic_bool busy_got_slot = false, idle_got_slot = false;
+
+        std::thread busy_waiter([&]() {
+            auto slot     = scheduler.acquire(&busy, never);
+            busy_got_slot = true;
+        });
+
+        // the busy test asked first, the idle test still gets the next slot
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+        std::thread idle_waiter([&]() {
+            auto slot     = scheduler.acquire(&idle, never);
+            idle_got_slot = true;
+            std::this_thread::sleep_for(std::chrono::milliseconds(200));
+        });
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        first.reset();
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        CHECK(idle_got_slot);
+        CHECK_FALSE(busy_got_slot);
+
+        idle_waiter.join();
+        busy_waiter.join();
+        CHECK(busy_got_slot);
+    }
+
+    TEST_CASE("Slots are shared by weight") {
+        daemon::SlotScheduler scheduler(3);
+
+        int blocker = 0, heavy = 0, light = 0;
+        scheduler.add(&blocker);
+        scheduler.add(&heavy, 2);
+        scheduler.add(&light, 1);
+
+        std::vector<std::optional<daemon::SlotScheduler::Slot>> blocked;
+        for (int i = 0; i < 3; i++) blocked.push_back(scheduler.acquire(&blocker, []() { return false; }));
+
+        // both tests want every slot, they queue up while the blocker holds all of them
+        std::atomic_bool done = false;
+        std::vector<std::thread> waiters;
+
+        for (auto *owner : {&heavy, &light}) {
+            for (int i = 0; i < 3; i++) {
+                waiters.emplace_back([&scheduler, &done, owner]() {
+                    auto slot = scheduler.acquire(owner, [&done]() { return done.load(); });
+                    while (slot && !done) std::this_thread::sleep_for(std::chrono::milliseconds(10));
+                });
+            }
+        }
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        blocked.clear();
+        std::this_thread::sleep_for(std::chrono::milliseconds(300));
+
+        CHECK(scheduler.running(&heavy) == 2);
+        CHECK(scheduler.running(&light) == 1);
+
+        done = true;
+        for (auto &waiter : waiters) waiter.join();
+    }
+
+    TEST_CASE("Waiting for a slot stops with the test") {
+        daemon::SlotScheduler scheduler(1);
+
+        int owner = 0;
+        scheduler.add(&owner);
+
+        auto slot = scheduler.acquire(&owner, []() { return false; });
+        REQUIRE(slot.has_value());
+
+        CHECK_FALSE(scheduler.acquire(&owner, []() { return true; }).has_value());
+        CHECK(scheduler.running(&owner) == 1);
+
+        slot.reset();
+        CHECK(scheduler.running(&owner) == 0);
+    }
+
+    TEST_CASE("Opening books are parsed once") {
+        book::BookCache cache;
+
+        config::Tournament tournament;
+        tournament.rounds         = 10;
+        tournament.opening.file   = "app/tests/data/test.epd";
+        tournament.opening.format = FormatType::EPD;
+        tournament.opening.order  = OrderType::SEQUENTIAL;
+
+        const auto first = book::OpeningBook(tournament, 0, &cache);
+
+        // the second book is rotated, the cached file must not be
+        tournament.opening.start = 2;
+        const auto second        = book::OpeningBook(tournament, 0, &cache);
+
+        CHECK(cache.size() == 1);
+        CHECK(first[0].fen == "5k2/3r1p2/1p3pp1/p2n3p/P6P/1PPR1PP1/3KN3/6b1 w - - 0 34");
+        CHECK(second[0].fen == "5k2/5p2/4B2p/r5pn/4P3/5PPP/2NR2K1/8 b - - 0 59");
+    }
+
+    TEST_CASE("Invalid requests are answered with an error") {
+        auto server = daemon::Daemon("fastchess-daemon-test.sock", 1, false);
+
+        CHECK(server.handle({{"type", "unknown"}})["type"] == daemon::message::FAILURE);
+        CHECK(server.handle({{"type", daemon::message::CANCEL}, {"id", 1}})["type"] == daemon::message::FAILURE);
+
+        // a tournament needs two engines
+        auto request = daemon::submitRequest(config::Tournament(), {}, {});
+        CHECK(server.handle(request)["type"] == daemon::message::FAILURE);
+
+        const auto status = server.handle({{"type", daemon::message::STATUS}});
+        CHECK(status["type"] == daemon::message::STATUS);
+        CHECK(status["tests"].empty());
+    }
+}
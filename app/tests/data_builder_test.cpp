@@ -0,0 +1,41 @@
+#include <data/data_builder.hpp>
+
+#include "doctest/doctest.hpp"
+
+namespace fastchess {
+TEST_SUITE("Data Builder Tests") {
+    TEST_CASE("Data Creation White Win") {
+        MatchData match_data;
+
+        match_data.players.white.result = chess::GameResult::WIN;
+        match_data.players.black.result = chess::GameResult::LOSE;
+
+        match_data.positions = {{"rnbqkbnr/pppppppp/8/8/4P3/8/PPPP1PPP/RNBQKBNR b KQkq - 0 1", 25},
+                                {"rnbqkbnr/pppp1ppp/8/4p3/4P3/8/PPPP1PPP/RNBQKBNR w KQkq - 0 2", -12}};
+
+        std::string expected =
+            "rnbqkbnr/pppppppp/8/8/4P3/8/PPPP1PPP/RNBQKBNR b KQkq - 0 1 | 25 | 1.0\n"
+            "rnbqkbnr/pppp1ppp/8/4p3/4P3/8/PPPP1PPP/RNBQKBNR w KQkq - 0 2 | -12 | 1.0\n";
+
+        CHECK(data::DataBuilder(match_data).get() == expected);
+    }
+
+    TEST_CASE("Data Creation Draw and Loss") {
+        MatchData match_data;
+
+        match_data.positions = {{"8/8/4k3/8/8/4K3/8/8 w - - 0 60", 0}};
+
+        match_data.players.white.result = chess::GameResult::DRAW;
+        CHECK(data::DataBuilder(match_data).get() == "8/8/4k3/8/8/4K3/8/8 w - - 0 60 | 0 | 0.5\n");
+
+        match_data.players.white.result = chess::GameResult::LOSE;
+        CHECK(data::DataBuilder(match_data).get() == "8/8/4k3/8/8/4K3/8/8 w - - 0 60 | 0 | 0.0\n");
+    }
+
+    TEST_CASE("Data Creation No Positions") {
+        MatchData match_data;
+
+        CHECK(data::DataBuilder(match_data).get().empty());
+    }
+}
+}  // namespace fastchess
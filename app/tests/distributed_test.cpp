@@ -0,0 +1,157 @@
+#include <matchmaking/distributed/protocol.hpp>
+#include <matchmaking/distributed/worker.hpp>
+
+#include <thread>
+
+#include <util/socket.hpp>
+
+#include "doctest/doctest.hpp"
+
+using namespace fastchess;
+
+TEST_SUITE("Distributed") {
+    TEST_CASE("Opening round trip") {
+        const auto fen   = "r3k2r/8/8/8/8/8/8/R3K2R w KQkq - 0 1";
+        const auto board = chess::Board(fen);
+
+        const auto castle = chess::uci::uciToMove(board, "e1g1");
+        const auto rook   = chess::uci::uciToMove(board, "a1a2");
+
+        const pgn::Opening opening(fen, {castle, rook}, chess::Color::BLACK);
+        const auto parsed = distributed::openingFromJson(distributed::toJson(opening));
+
+        CHECK(parsed.fen == opening.fen);
+        CHECK(parsed.stm == chess::Color::BLACK);
+        REQUIRE(parsed.moves.size() == 2);
+        CHECK(parsed.moves[0] == castle);
+        CHECK(parsed.moves[1] == rook);
+    }
+
+    TEST_CASE("MatchData round trip") {
+        MatchData data("startpos");
+
+        data.players.white.config.name = "engine1";
+        data.players.white.result      = chess::GameResult::WIN;
+        data.players.white.color       = chess::Color::WHITE;
+        data.players.black.config.name = "engine2";
+        data.players.black.result      = chess::GameResult::LOSE;
+        data.players.black.color       = chess::Color::BLACK;
+        data.players.black.usage       = ResourceUsage{1500, 20, 96};
+        data.players.white.process     = ProcessUsage{900, 40, 12, 3, 80};
+
+        data.moves.emplace_back("e2e4", "+0.25", 120, 12, 18, 25, 12345);
+        data.moves.back().tbhits               = 7;
+        data.moves.back().involuntary_switches = 2;
+        data.positions.push_back({"8/8/4k3/8/8/4K3/8/8 w - - 0 60", -30});
+
+        data.reason      = "engine2 resigns";
+        data.termination = MatchTermination::ADJUDICATION;
+
+        const auto parsed = distributed::matchFromJson(distributed::toJson(data));
+
+        CHECK(parsed.players.white.config.name == "engine1");
+        CHECK(parsed.players.white.result == chess::GameResult::WIN);
+        CHECK(parsed.players.black.color == chess::Color::BLACK);
+        CHECK_FALSE(parsed.players.white.usage.has_value());
+        REQUIRE(parsed.players.black.usage.has_value());
+        CHECK(parsed.players.black.usage->cpu_millis == 1500);
+        CHECK(parsed.players.black.usage->memory_peak == 96);
+        REQUIRE(parsed.players.white.process.has_value());
+        CHECK(parsed.players.white.process->user_millis == 900);
+        CHECK(parsed.players.white.process->involuntary_switches == 3);
+        CHECK(parsed.players.white.process->max_rss == 80);
+        CHECK_FALSE(parsed.players.black.process.has_value());
+        CHECK(parsed.fen == "startpos");
+        CHECK(parsed.date == data.date);
+        CHECK(parsed.reason == "engine2 resigns");
+        CHECK(parsed.termination == MatchTermination::ADJUDICATION);
+
+        REQUIRE(parsed.moves.size() == 1);
+        CHECK(parsed.moves[0].move == "e2e4");
+        CHECK(parsed.moves[0].score_string == "+0.25");
+        CHECK(parsed.moves[0].elapsed_millis == 120);
+        CHECK(parsed.moves[0].depth == 12);
+        CHECK(parsed.moves[0].seldepth == 18);
+        CHECK(parsed.moves[0].nodes == 12345);
+        CHECK(parsed.moves[0].tbhits == 7);
+        CHECK(parsed.moves[0].involuntary_switches == 2);
+
+        REQUIRE(parsed.positions.size() == 1);
+        CHECK(parsed.positions[0].score == -30);
+    }
+
+    TEST_CASE("Socket exchanges lines") {
+        auto server = util::net::Socket::listen("127.0.0.1", 0);
+        REQUIRE(server.port() > 0);
+
+        std::thread client([port = server.port()]() {
+            auto socket = util::net::Socket::connect("127.0.0.1", port);
+
+            // multiple messages in one send are split again
+            std::string line;
+            if (socket.receive(line)) socket.send(line + "\nsecond");
+        });
+
+        auto connection = server.accept(std::chrono::seconds(5));
+        REQUIRE(connection.valid());
+
+        CHECK(connection.send("first"));
+
+        std::string line;
+        REQUIRE(connection.receive(line));
+        CHECK(line == "first");
+        REQUIRE(connection.receive(line));
+        CHECK(line == "second");
+
+        client.join();
+
+        // the client closed the connection
+        CHECK_FALSE(connection.receive(line));
+    }
+
+    TEST_CASE("Socket receive times out on a silent peer") {
+        auto server = util::net::Socket::listen("127.0.0.1", 0);
+        auto client = util::net::Socket::connect("127.0.0.1", server.port());
+
+        auto connection = server.accept(std::chrono::seconds(5));
+        REQUIRE(connection.valid());
+
+        connection.setReceiveTimeout(std::chrono::milliseconds(50));
+
+        std::string line;
+        CHECK_FALSE(connection.receive(line));
+    }
+
+    TEST_CASE("Worker answers a game it can't play") {
+        auto server = util::net::Socket::listen("127.0.0.1", 0);
+
+        config::Worker address;
+        address.port = server.port();
+
+        std::thread thread([&address]() {
+            distributed::Worker worker(address, config::Tournament{});
+            worker.run();
+        });
+
+        auto connection = server.accept(std::chrono::seconds(5));
+        REQUIRE(connection.valid());
+
+        std::string line;
+        REQUIRE(connection.receive(line));
+        CHECK(nlohmann::ordered_json::parse(line)["type"] == distributed::message::HELLO);
+
+        // a game before the setup
+        CHECK(connection.send(nlohmann::ordered_json{{"type", distributed::message::GAME}, {"id", 3}}.dump()));
+
+        REQUIRE(connection.receive(line));
+        const auto reply = nlohmann::ordered_json::parse(line);
+        CHECK(reply["type"] == distributed::message::FAILED);
+        CHECK(reply["id"] == 3);
+
+        CHECK(connection.send(nlohmann::ordered_json{{"type", distributed::message::STOP}}.dump()));
+        thread.join();
+
+        // the worker stops the whole process once it is disconnected
+        atomic::stop = false;
+    }
+}
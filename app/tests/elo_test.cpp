@@ -1,5 +1,8 @@
 #include <elo/elo_pentanomial.hpp>
 #include <elo/elo_wdl.hpp>
+#include <elo/ratings.hpp>
+
+#include <vector>
 
 #include "doctest/doctest.hpp"
 
@@ -72,3 +75,110 @@ TEST_SUITE("Elo Model") {
         CHECK(elo.error() == doctest::Approx(2.95).epsilon(0.01));
     }
 }
+
+TEST_SUITE("Ratings") {
+    TEST_CASE("Ratings of a chain of engines") {
+        elo::Ratings ratings(3);
+
+        // 0 scores 60% against 1 and 1 scores 60% against 2
+        ratings.setResult(0, 1, 600, 1000);
+        ratings.setResult(1, 2, 600, 1000);
+        ratings.solve();
+
+        CHECK(ratings.elo(0) - ratings.elo(1) == doctest::Approx(70.44).epsilon(0.01));
+        CHECK(ratings.elo(1) - ratings.elo(2) == doctest::Approx(70.44).epsilon(0.01));
+        CHECK(ratings.elo(0) + ratings.elo(1) + ratings.elo(2) == doctest::Approx(0.0));
+
+        CHECK(ratings.ranking() == std::vector<std::size_t>{0, 1, 2});
+
+        // the gap between 0 and 2 is only known through 1
+        CHECK(ratings.error(0, 2) > ratings.error(0, 1));
+        CHECK(ratings.error(0, 1) == doctest::Approx(ratings.error(1, 0)));
+    }
+
+    TEST_CASE("Games of the pair shrink its error bar the most") {
+        elo::Ratings ratings(3);
+
+        ratings.setResult(0, 1, 50, 100);
+        ratings.setResult(1, 2, 50, 100);
+        ratings.setResult(0, 2, 50, 100);
+        ratings.solve();
+
+        CHECK(ratings.reduction(0, 1, 0, 1, 2) > ratings.reduction(0, 1, 1, 2, 2));
+        CHECK(ratings.reduction(0, 1, 0, 2, 2) == doctest::Approx(ratings.reduction(0, 1, 1, 2, 2)));
+
+        const auto before = ratings.error(0, 1);
+        ratings.addGames(0, 1, 100);
+
+        const auto after = ratings.error(0, 1);
+        CHECK(after < before);
+
+        // the expected result of equal engines, the same as solving with the games played
+        ratings.setResult(0, 1, 100, 200);
+        ratings.solve();
+        CHECK(ratings.error(0, 1) == doctest::Approx(after));
+    }
+
+    TEST_CASE("Solving again starts from the previous solution") {
+        constexpr std::size_t players = 12;
+
+        elo::Ratings warm(players), cold(players);
+
+        const auto load = [](elo::Ratings &ratings, int extra) {
+            for (std::size_t i = 0; i < players; i++) {
+                for (std::size_t j = i + 1; j < players; j++) {
+                    // stronger engines have a lower index
+                    ratings.setResult(i, j, 10.0 + (j - i) + extra * (i == 0), 30.0 + extra * (i == 0));
+                }
+            }
+        };
+
+        load(warm, 0);
+        warm.solve();
+
+        load(warm, 10);
+        warm.solve();
+
+        load(cold, 10);
+        cold.solve();
+
+        for (std::size_t i = 0; i < players; i++) {
+            CHECK(warm.elo(i) == doctest::Approx(cold.elo(i)));
+            CHECK(warm.error(i) == doctest::Approx(cold.error(i)));
+        }
+
+        CHECK(warm.ranking().front() == 0);
+        CHECK(warm.ranking().back() == players - 1);
+    }
+
+    TEST_CASE("Pentanomial error bars follow the spread of the game pairs") {
+        // 100 game pairs which all end 1-1
+        Stats balanced(0, 0, 100, 0, 0, 0);
+        balanced.wins   = 100;
+        balanced.losses = 100;
+
+        // the same games, but the pairs are won or lost as a whole
+        Stats streaky(50, 0, 0, 0, 0, 50);
+        streaky.wins   = 100;
+        streaky.losses = 100;
+
+        elo::Ratings games(2), pairs(2), streaks(2);
+
+        games.setResult(0, 1, balanced, false);
+        pairs.setResult(0, 1, balanced, true);
+        streaks.setResult(0, 1, streaky, true);
+
+        games.solve();
+        pairs.solve();
+        streaks.solve();
+
+        CHECK(games.elo(0) == doctest::Approx(0.0));
+        CHECK(pairs.elo(0) == doctest::Approx(0.0));
+
+        CHECK(pairs.error(0, 1) < games.error(0, 1) / 2);
+        CHECK(streaks.error(0, 1) > games.error(0, 1));
+
+        // two players, half of the difference on each side of the average
+        CHECK(games.error(0) == doctest::Approx(games.error(0, 1) / 2));
+    }
+}
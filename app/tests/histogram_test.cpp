@@ -0,0 +1,71 @@
+#include <util/histogram.hpp>
+
+#include <matchmaking/latency.hpp>
+
+#include "doctest/doctest.hpp"
+
+using namespace fastchess;
+
+TEST_SUITE("Histogram") {
+    TEST_CASE("Small values are exact") {
+        util::Histogram histogram;
+        for (int i = 1; i <= 10; i++) histogram.record(i);
+
+        CHECK(histogram.count() == 10);
+        CHECK(histogram.max() == 10);
+        CHECK(histogram.mean() == doctest::Approx(5.5));
+        CHECK(histogram.percentile(50) == 5);
+        CHECK(histogram.percentile(90) == 9);
+        CHECK(histogram.percentile(100) == 10);
+        CHECK(util::Histogram().percentile(99) == 0);
+    }
+
+    TEST_CASE("Large values keep their relative error") {
+        util::Histogram histogram;
+        for (int i = 0; i < 99; i++) histogram.record(100);
+        histogram.record(1000000);
+
+        CHECK(histogram.percentile(50) >= 100);
+        CHECK(histogram.percentile(50) <= 100 + 100 / 16);
+        CHECK(histogram.percentile(99) <= 100 + 100 / 16);
+        CHECK(histogram.percentile(100) == 1000000);
+
+        util::Histogram other;
+        other.record(3000000);
+        histogram.merge(other);
+
+        CHECK(histogram.count() == 101);
+        CHECK(histogram.max() == 3000000);
+    }
+
+    TEST_CASE("Atomic histogram takes snapshots") {
+        util::Histogram histogram;
+        for (int i = 0; i < 99; i++) histogram.record(100);
+        histogram.record(1000000);
+
+        util::AtomicHistogram shared;
+        shared.merge(histogram);
+        shared.merge(histogram);
+
+        const auto snapshot = shared.snapshot();
+        CHECK(snapshot.count() == 200);
+        CHECK(snapshot.max() == 1000000);
+        CHECK(snapshot.percentile(99) == histogram.percentile(99));
+        CHECK(snapshot.mean() == doctest::Approx(histogram.mean()));
+    }
+
+    TEST_CASE("Latency of the phases") {
+        Latency latency;
+        latency.record(Phase::HANDOFF, std::chrono::milliseconds(2));
+        latency.record(Phase::GO, std::chrono::microseconds(-5));
+
+        CHECK(latency.get(Phase::HANDOFF).max() == 2000);
+        CHECK(latency.get(Phase::GO).max() == 0);
+        CHECK(latency.get(Phase::PING).count() == 0);
+
+        LatencyBoard board;
+        board.add(latency);
+        board.add(latency);
+        CHECK(board.get().get(Phase::HANDOFF).count() == 2);
+    }
+}
@@ -0,0 +1,76 @@
+#include <matchmaking/journal/journal.hpp>
+
+#include <cstdio>
+#include <fstream>
+
+#include "doctest/doctest.hpp"
+
+using namespace fastchess;
+
+TEST_SUITE("Journal") {
+    TEST_CASE("Serialize and deserialize") {
+        const JournalEntry entry = {"engine1", "engine2", 12, 1, 37, Stats(0, 1, 0)};
+
+        const auto line = Journal::serialize(entry);
+        CHECK(line == R"({"white":"engine1","black":"engine2","round":12,"game":1,"opening":37,"result":"0-1"})");
+
+        const auto parsed = Journal::deserialize(line);
+
+        REQUIRE(parsed.has_value());
+        CHECK(parsed->white == "engine1");
+        CHECK(parsed->black == "engine2");
+        CHECK(parsed->round_id == 12);
+        CHECK(parsed->game == 1);
+        CHECK(parsed->opening == 37);
+        CHECK(parsed->stats == Stats(0, 1, 0));
+    }
+
+    TEST_CASE("Deserialize invalid lines") {
+        CHECK_FALSE(Journal::deserialize("").has_value());
+        CHECK_FALSE(Journal::deserialize(R"({"white":"engine1","black":"eng)").has_value());
+        CHECK_FALSE(Journal::deserialize(R"({"white":"a","black":"b","round":0,"game":0,"opening":-1,"result":"2-0"})")
+                        .has_value());
+    }
+
+    TEST_CASE("Append and replay") {
+        const std::string file = "journal_test.jsonl";
+        std::remove(file.c_str());
+
+        {
+            Journal journal(file, 2, 1234);
+            CHECK(journal.entries().empty());
+
+            journal.append({"engine1", "engine2", 0, 0, 5, Stats(1, 0, 0)});
+            journal.append({"engine2", "engine1", 0, 1, 5, Stats(0, 0, 1)});
+        }
+
+        // simulate a crash in the middle of writing an entry
+        {
+            std::ofstream out(file, std::ios::app);
+            out << R"({"white":"engine1","bl)";
+        }
+
+        CHECK(Journal::readSeed(file) == 1234);
+
+        {
+            Journal journal(file, 2, 9999);
+
+            REQUIRE(journal.entries().size() == 2);
+            CHECK(journal.entries()[0].stats == Stats(1, 0, 0));
+            CHECK(journal.entries()[1].white == "engine2");
+            CHECK(journal.entries()[1].stats == Stats(0, 0, 1));
+
+            journal.append({"engine1", "engine2", 1, 0, 6, Stats(0, 1, 0)});
+        }
+
+        {
+            Journal journal(file, 2, 9999);
+
+            REQUIRE(journal.entries().size() == 3);
+            CHECK(journal.entries()[2].round_id == 1);
+            CHECK(Journal::readSeed(file) == 1234);
+        }
+
+        std::remove(file.c_str());
+    }
+}
@@ -0,0 +1,95 @@
+#include <matchmaking/metrics/exporter.hpp>
+#include <matchmaking/metrics/metrics.hpp>
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+#include "doctest/doctest.hpp"
+
+namespace fastchess {
+
+namespace {
+std::vector<EngineConfiguration> engines(std::vector<std::string> names) {
+    std::vector<EngineConfiguration> configs;
+
+    for (const auto &name : names) {
+        configs.emplace_back();
+        configs.back().name = name;
+    }
+
+    return configs;
+}
+
+bool contains(const std::string &text, const std::string &line) { return text.find(line + "\n") != std::string::npos; }
+}  // namespace
+
+TEST_SUITE("Metrics") {
+    TEST_CASE("Games are counted per engine") {
+        TournamentMetrics metrics(engines({"engine1", "engi\"ne2"}));
+
+        MatchData game("rnbqkbnr/pppppppp/8/8/4P3/8/PPPP1PPP/RNBQKBNR b KQkq - 0 1");
+        game.players.white.config.name = "engine1";
+        game.players.black.config.name = "engi\"ne2";
+        game.players.white.color       = chess::Color::WHITE;
+        game.players.black.color       = chess::Color::BLACK;
+        game.players.white.result      = chess::GameResult::WIN;
+        game.players.black.result      = chess::GameResult::LOSE;
+        game.termination               = MatchTermination::TIMEOUT;
+
+        // black moves first, with a book move before the searched ones
+        game.moves.emplace_back("e7e5", "", 0, 0, 0, 0, 0, true, true);
+        game.moves.emplace_back("g1f3", "", 100, 10, 12, 0, 100000);
+        game.moves.emplace_back("b8c6", "", 200, 8, 10, 0, 100000);
+        game.moves.emplace_back("f1b5", "", 100, 12, 14, 0, 300010);
+
+        metrics.gameStarted();
+        metrics.add(game);
+        metrics.gameEnded();
+
+        metrics.setSprtBounds(-2.94, 2.94);
+        metrics.setLlr("engine1", 1.5);
+
+        Latency latency;
+        latency.record(Phase::HANDOFF, std::chrono::milliseconds(2));
+        metrics.add(latency);
+
+        const auto text = metrics.render(2);
+
+        CHECK(contains(text, "fastchess_games_finished_total 1"));
+        CHECK(contains(text, "fastchess_games_active 0"));
+        CHECK(contains(text, "fastchess_engine_processes 2"));
+        CHECK(contains(text, "# TYPE fastchess_engine_timeouts_total counter"));
+        CHECK(contains(text, "fastchess_engine_timeouts_total{engine=\"engine1\"} 0"));
+        CHECK(contains(text, "fastchess_engine_timeouts_total{engine=\"engi\\\"ne2\"} 1"));
+        CHECK(contains(text, "fastchess_engine_moves_total{engine=\"engine1\"} 2"));
+        CHECK(contains(text, "fastchess_engine_moves_total{engine=\"engi\\\"ne2\"} 1"));
+        CHECK(contains(text, "fastchess_engine_nps{engine=\"engine1\"} 2000050"));
+        CHECK(contains(text, "fastchess_engine_depth_mean{engine=\"engine1\"} 11"));
+        CHECK(contains(text, "fastchess_engine_move_seconds_mean{engine=\"engi\\\"ne2\"} 0.2"));
+        CHECK(contains(text, "fastchess_move_overhead_seconds_count 1"));
+        CHECK(contains(text, "fastchess_sprt_llr{engine=\"engine1\"} 1.5"));
+        CHECK(text.find("fastchess_sprt_llr{engine=\"engi\\\"ne2") == std::string::npos);
+    }
+
+    TEST_CASE("The file is written when the exporter stops") {
+        const std::string file = "metrics_test.prom";
+        std::remove(file.c_str());
+
+        config::Metrics config;
+        config.file = file;
+
+        { MetricsExporter exporter(config, []() { return std::string("fastchess_games_active 3\n"); }); }
+
+        std::ifstream in(file);
+        std::stringstream text;
+        text << in.rdbuf();
+
+        CHECK(text.str() == "fastchess_games_active 3\n");
+
+        in.close();
+        std::remove(file.c_str());
+    }
+}
+
+}  // namespace fastchess
@@ -25,6 +25,11 @@ TEST_SUITE("Option Parsing Tests") {
                               "plies=7",
                               "option.Threads=1",
                               "option.Hash=32",
+                              "sandbox.memory=256",
+                              "sandbox.pids=64",
+                              "nice=5",
+                              "sched=fifo",
+                              "sched.priority=10",
                               "name=Alexandria-27E42728",
                               "-openings",
                               "file=./app/tests/data/test.epd",
@@ -69,6 +74,15 @@ TEST_SUITE("Option Parsing Tests") {
         CHECK(config1.options.at(0).second == "1");
         CHECK(config1.options.at(1).first == "Hash");
         CHECK(config1.options.at(1).second == "32");
+        CHECK_FALSE(config0.sandbox.enabled);
+        CHECK(config1.sandbox.enabled);
+        CHECK(config1.sandbox.memory == 256);
+        CHECK(config1.sandbox.pids == 64);
+        CHECK(config1.sandbox.cpus == 0.0);
+        CHECK(config0.scheduling.policy == SchedulingPolicy::OTHER);
+        CHECK(config1.scheduling.nice == 5);
+        CHECK(config1.scheduling.policy == SchedulingPolicy::FIFO);
+        CHECK(config1.scheduling.priority == 10);
     }
 
     TEST_CASE("Testing Cli Options Parsing") {
@@ -117,6 +131,7 @@ TEST_SUITE("Option Parsing Tests") {
                                       "-report",
                                       "penta=false",
                                       "-use-affinity",
+                                      "policy=dedicated",
                                       "-srand",
                                       "1234",
                                       "-epdout",
@@ -153,6 +168,7 @@ TEST_SUITE("Option Parsing Tests") {
         CHECK(gameOptions.maxmoves.enabled);
         CHECK(gameOptions.output == OutputType::CUTECHESS);
         CHECK(gameOptions.affinity);
+        CHECK(gameOptions.affinity_policy == AffinityPolicy::DEDICATED);
         CHECK(gameOptions.seed == 1234);
         CHECK(gameOptions.report_penta == false);
         // Test Sprt options parsing
@@ -177,4 +193,28 @@ TEST_SUITE("Option Parsing Tests") {
         CHECK(gameOptions.opening.plies == 16);
         CHECK(gameOptions.opening.start == 4);
     }
+
+    TEST_CASE("Shuffled openings of a shard need a seed") {
+        const char *argv[] = {"fastchess.exe",
+                              "-shard",
+                              "1/2",
+                              "-openings",
+                              "file=./app/tests/data/test.epd",
+                              "format=epd",
+                              "order=random"};
+
+        CHECK_THROWS(cli::OptionsParser(sizeof(argv) / sizeof(argv[0]), argv));
+
+        const char *seeded[] = {"fastchess.exe",
+                                "-shard",
+                                "1/2",
+                                "-openings",
+                                "file=./app/tests/data/test.epd",
+                                "format=epd",
+                                "order=random",
+                                "-srand",
+                                "42"};
+
+        CHECK(cli::OptionsParser(sizeof(seeded) / sizeof(seeded[0]), seeded).getTournamentConfig().seed == 42);
+    }
 }
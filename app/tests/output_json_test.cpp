@@ -0,0 +1,75 @@
+#include <matchmaking/output/output_json.hpp>
+
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <engine/uci_engine.hpp>
+#include <json.hpp>
+
+#include "doctest/doctest.hpp"
+
+using namespace fastchess;
+
+TEST_SUITE("Json Output") {
+    TEST_CASE("Quote strings") {
+        CHECK(JsonLines::quote("engine1") == R"("engine1")");
+        CHECK(JsonLines::quote("a \"b\" \\ c") == R"("a \"b\" \\ c")");
+        CHECK(JsonLines::quote("line\nend\x01") == R"("line\nend\u0001")");
+    }
+
+    TEST_CASE("One object per event") {
+        const std::string file = "output_json_test.jsonl";
+        std::remove(file.c_str());
+
+        EngineConfiguration white, black;
+        white.name = "engine\"1";
+        black.name = "engine2";
+
+        const GamePair<EngineConfiguration, EngineConfiguration> configs = {white, black};
+
+        {
+            JsonLines output(true, file);
+            output.startGame(configs, 1, 2);
+            output.endGame(configs, Stats(1, 0, 0), "Black loses on time", MatchTermination::TIMEOUT, 1);
+
+            const engine::UciEngine engine1(white, false);
+            const engine::UciEngine engine2(black, false);
+            const SPRT sprt(0.05, 0.05, 0, 5, "normalized", true);
+
+            Stats stats(0, 1, 0, 1, 0, 0);
+            stats.losses = 1;
+            stats.draws  = 3;
+
+            output.printInterval(sprt, stats, white.name, black.name, {engine1, engine2}, "");
+            output.endTournament();
+        }
+
+        std::ifstream in(file);
+        std::vector<nlohmann::json> events;
+
+        for (std::string line; std::getline(in, line);) events.push_back(nlohmann::json::parse(line));
+
+        std::remove(file.c_str());
+
+        REQUIRE(events.size() == 4);
+        CHECK(events[0]["event"] == "start");
+        CHECK(events[0]["white"] == "engine\"1");
+        CHECK(events[0]["games"] == 2);
+        CHECK(events[0]["time"].get<int64_t>() > 0);
+
+        CHECK(events[1]["event"] == "end");
+        CHECK(events[1]["result"] == "1-0");
+        CHECK(events[1]["reason"] == "Black loses on time");
+
+        CHECK(events[2]["event"] == "interval");
+        CHECK(events[2]["games"] == 4);
+        CHECK(events[2]["penta"] == nlohmann::json::array({0, 1, 1, 0, 0}));
+        CHECK(events[2]["elo"].is_number());
+        CHECK(events[2]["llr"].is_number());
+        CHECK(events[2]["upper"].get<double>() == doctest::Approx(2.944).epsilon(0.001));
+
+        CHECK(events[3]["event"] == "tournament_end");
+    }
+}
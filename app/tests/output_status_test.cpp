@@ -0,0 +1,58 @@
+#include <matchmaking/output/output_status.hpp>
+#include <util/helper.hpp>
+
+#include <sstream>
+#include <string>
+
+#include "doctest/doctest.hpp"
+
+using namespace fastchess;
+
+TEST_SUITE("Status Output") {
+    TEST_CASE("Summary of the games") {
+        std::ostringstream out;
+
+        EngineConfiguration engine1, engine2;
+        engine1.name = "engine1";
+        engine2.name = "engine2";
+
+        const GamePair<EngineConfiguration, EngineConfiguration> configs = {engine1, engine2};
+
+        {
+            Status status(false, true, out);
+            status.setCoreMap([]() { return std::string("#."); });
+
+            status.startGame(configs, 1, 4);
+            status.startGame(configs, 2, 4);
+            status.startGame(configs, 3, 4);
+            status.endGame(configs, Stats(0, 1, 0), "White loses on time", MatchTermination::TIMEOUT, 1);
+            status.endGame(configs, Stats(1, 0, 0), "Black disconnects", MatchTermination::DISCONNECT, 2);
+            status.printResult(Stats(1, 1, 0), "engine1", "engine2");
+
+            const auto lines = status.summary();
+
+            REQUIRE(lines.size() == 5);
+            CHECK(str_utils::startsWith(lines[0], "Games: 2 of 4, "));
+            CHECK(str_utils::contains(lines[0], "1 running"));
+            CHECK(str_utils::startsWith(lines[1], "engine1 vs engine2: 1 - 1 - 0, Elo: "));
+            CHECK(lines[2] == "engine1: 0 crashes, 1 timeouts");
+            CHECK(lines[3] == "engine2: 1 crashes, 0 timeouts");
+            CHECK(lines[4] == "Cores: #.");
+        }
+
+        // the game lines come with the last summary, which has no core map anymore
+        const auto text = out.str();
+        CHECK(str_utils::contains(text, "Finished game 1 (engine1 vs engine2): 0-1 {White loses on time}\n"));
+        CHECK(str_utils::contains(text, "Finished game 2 (engine1 vs engine2): 1-0 {Black disconnects}\n"));
+        CHECK(str_utils::endsWith(text, "engine2: 1 crashes, 0 timeouts\n"));
+    }
+
+    TEST_CASE("Progress of the SPRT") {
+        std::ostringstream out;
+        Status status(false, false, out);
+
+        const SPRT sprt(0.05, 0.05, 0, 5, "normalized", true);
+        CHECK(str_utils::startsWith(status.printSprt(sprt, Stats(10, 10, 10)), "LLR: "));
+        CHECK(status.printSprt(SPRT(), Stats(10, 10, 10)).empty());
+    }
+}
@@ -0,0 +1,119 @@
+#include <config/planner.hpp>
+
+#include "doctest/doctest.hpp"
+
+using namespace fastchess;
+
+namespace {
+
+EngineConfiguration engine(const std::string &name, int threads, int hash) {
+    EngineConfiguration config;
+    config.name    = name;
+    config.options = {{"Threads", std::to_string(threads)}, {"Hash", std::to_string(hash)}};
+    return config;
+}
+
+// cores with two hyperthreads, the second one numbered after all first ones
+affinity::cpu_info::CpuInfo topology(int cores, const std::vector<int> &caches) {
+    affinity::cpu_info::CpuInfo cpu_info;
+
+    for (int i = 0; i < cores; i++) {
+        affinity::cpu_info::CpuInfo::PhysicalCpu::Core core = {i, {i, i + cores}};
+
+        core.cache_id = caches[i];
+        core.node_id  = 0;
+
+        cpu_info.physical_cpus[0].cores[i] = core;
+    }
+
+    return cpu_info;
+}
+
+}  // namespace
+
+TEST_SUITE("Resource Planner") {
+    TEST_CASE("Games get one processor per thread") {
+        config::Tournament tournament;
+        tournament.concurrency = 16;
+
+        config::Machine machine;
+        machine.processors = 16;
+        machine.cores      = 8;
+
+        const auto plan = config::plan(tournament, {engine("a", 4, 16), engine("b", 2, 16)}, machine);
+        CHECK(plan.threads == 4);
+        CHECK(plan.concurrency == 4);
+        CHECK_FALSE(plan.reason.empty());
+
+        // pinned games get the sets of the affinity manager
+        machine.cores       = 6;
+        machine.processors  = 12;
+        machine.topology    = topology(6, {0, 0, 0, 1, 1, 1});
+        tournament.affinity = true;
+        CHECK(config::plan(tournament, {engine("a", 4, 16), engine("b", 4, 16)}, machine).concurrency == 2);
+
+        // dedicated cores need processors for both engines
+        tournament.affinity_policy = AffinityPolicy::DEDICATED;
+        CHECK(config::plan(tournament, {engine("a", 2, 16), engine("b", 2, 16)}, machine).concurrency == 2);
+    }
+
+    TEST_CASE("Pinned games are planned with the sets of the affinity manager") {
+        config::Tournament tournament;
+        tournament.affinity    = true;
+        tournament.concurrency = 16;
+
+        config::Machine machine;
+        machine.processors = 16;
+        machine.cores      = 8;
+        machine.topology   = topology(8, {0, 0, 0, 0, 4, 4, 4, 4});
+
+        // every hyperthread gets a single threaded game
+        CHECK(config::plan(tournament, {engine("a", 1, 16), engine("b", 1, 16)}, machine).concurrency == 16);
+
+        // a set of three threads doesn't span two L3 caches
+        CHECK(config::plan(tournament, {engine("a", 3, 16), engine("b", 3, 16)}, machine).concurrency == 4);
+
+        // without a topology the processors are counted
+        machine.topology = {};
+        CHECK(config::plan(tournament, {engine("a", 3, 16), engine("b", 3, 16)}, machine).concurrency == 5);
+    }
+
+    TEST_CASE("The hash of all games fits into the memory") {
+        config::Tournament tournament;
+        tournament.concurrency = 8;
+
+        config::Machine machine;
+        machine.processors = 64;
+        machine.cores      = 64;
+        machine.memory     = 4096;
+
+        auto plan = config::plan(tournament, {engine("a", 1, 1024), engine("b", 1, 256), engine("c", 1, 512)}, machine);
+        CHECK(plan.memory_per_game == 1536);
+        CHECK(plan.concurrency == 2);
+
+        // idle engines of -maxengines keep their hash
+        tournament.concurrency = 1;
+        tournament.maxengines  = 5;
+        plan = config::plan(tournament, {engine("a", 1, 1024), engine("b", 1, 256), engine("c", 1, 512)}, machine);
+        CHECK(plan.concurrency == 0);
+
+        CHECK_THROWS(config::applyPlan(tournament, {engine("a", 1, 1024), engine("b", 1, 256)}, machine));
+
+        tournament.maxengines = 0;
+        machine.memory        = std::nullopt;
+        CHECK(config::plan(tournament, {engine("a", 1, 1 << 20), engine("b", 1, 1 << 20)}, machine).concurrency == 1);
+    }
+
+    TEST_CASE("The concurrency is lowered to the plan") {
+        config::Tournament tournament;
+        tournament.concurrency = 8;
+
+        config::Machine machine;
+        machine.processors = 4;
+        machine.cores      = 4;
+        machine.memory     = 1024;
+
+        config::applyPlan(tournament, {engine("a", 1, 64), engine("b", 1, 64)}, machine);
+        CHECK(tournament.concurrency == 4);
+    }
+}
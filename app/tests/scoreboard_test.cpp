@@ -54,6 +54,30 @@ TEST_SUITE("ScoreBoard") {
         CHECK(scoreboard.getStats(engine2.name, engine1.name) == Stats(3, 3, 6));
     }
 
+    TEST_CASE("Pairs playing the same round are kept apart") {
+        EngineConfiguration base = {}, first = {}, second = {};
+
+        base.name   = "base";
+        first.name  = "first";
+        second.name = "second";
+
+        ScoreBoard scoreboard;
+
+        // round 0 of both pairs is played at the same time
+        CHECK_FALSE(scoreboard.updatePair({first, base}, Stats(1, 0, 0), 0));
+        CHECK_FALSE(scoreboard.updatePair({second, base}, Stats(0, 0, 1), 0));
+        CHECK(scoreboard.updatePair({base, first}, Stats(0, 1, 0), 0));
+        CHECK(scoreboard.updatePair({base, second}, Stats(0, 0, 1), 0));
+
+        const auto stats1 = scoreboard.getStats(first.name, base.name);
+        CHECK(stats1.wins == 2);
+        CHECK(stats1.penta_WW == 1);
+
+        const auto stats2 = scoreboard.getStats(second.name, base.name);
+        CHECK(stats2.draws == 2);
+        CHECK(stats2.penta_DD == 1);
+    }
+
     // TEST_CASE("SetResults") {
     //     EngineConfiguration engine1 = {};
     //     EngineConfiguration engine2 = {};
@@ -0,0 +1,76 @@
+#include <matchmaking/search_stats.hpp>
+
+#include "doctest/doctest.hpp"
+
+namespace fastchess {
+
+TEST_SUITE("SearchBoard") {
+    TEST_CASE("Merged running stats match the whole series") {
+        RunningStats all, first, second;
+
+        for (int i = 1; i <= 8; i++) {
+            all.add(i);
+            (i <= 4 ? first : second).add(i);
+        }
+
+        first.merge(second);
+
+        CHECK(first.count() == 8);
+        CHECK(first.mean() == doctest::Approx(4.5));
+        CHECK(first.stddev() == doctest::Approx(all.stddev()));
+        CHECK(all.stddev() == doctest::Approx(2.449).epsilon(0.001));
+    }
+
+    TEST_CASE("Phases of the game") {
+        const chess::Board start;
+        CHECK(SearchBoard::phaseOf(start, 3) == GamePhase::OPENING);
+        CHECK(SearchBoard::phaseOf(start, 25) == GamePhase::MIDDLEGAME);
+
+        const chess::Board rook("8/8/4k3/8/8/3K4/3R4/8 w - - 0 1");
+        CHECK(SearchBoard::phaseOf(rook, 3) == GamePhase::ENDGAME);
+    }
+
+    TEST_CASE("Searches are collected per engine") {
+        MatchData game("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1");
+        game.players.white.config.name          = "engine1";
+        game.players.black.config.name          = "engine2";
+        game.players.white.config.limit.tc.time = 1000;
+        game.players.black.config.limit.tc.time = 1000;
+
+        game.moves.emplace_back("e2e4", "", 0, 0, 0, 0, 0, true, true);
+        game.moves.emplace_back("e7e5", "", 100, 10, 12, 0, 100000);
+        game.moves.emplace_back("g1f3", "", 50, 8, 10, 0, 0);
+        game.moves.emplace_back("b8c6", "", 100, 12, 14, 0, 0);
+
+        game.moves[1].clock_millis = 1000;
+        game.moves[2].clock_millis = 1000;
+        game.moves[2].nps          = 2000000;
+        game.moves[3].clock_millis = 900;
+
+        SearchBoard board;
+        board.add(game);
+
+        const auto engines = board.get();
+        REQUIRE(engines.size() == 2);
+
+        // the book move doesn't count
+        const auto &white = engines.at("engine1");
+        CHECK(white.games == 1);
+        CHECK(white.moves() == 1);
+        CHECK(white.nps.mean() == doctest::Approx(2000000));
+        CHECK(white.clock_left.mean() == doctest::Approx(950));
+
+        // nps from the nodes of the first move, the second one has none
+        const auto &black = engines.at("engine2");
+        CHECK(black.moves() == 2);
+        CHECK(black.nps.count() == 1);
+        CHECK(black.nps.mean() == doctest::Approx(1000000));
+        CHECK(black.phases[0].depth.mean() == doctest::Approx(11));
+        CHECK(black.usage_by_move[0].count() == 2);
+        CHECK(black.depth_by_usage[4].count() == 2);
+        CHECK(black.clock_left.mean() == doctest::Approx(800));
+        CHECK(black.clock_left_share.mean() == doctest::Approx(0.8));
+    }
+}
+
+}  // namespace fastchess
@@ -0,0 +1,69 @@
+#include <matchmaking/merge/merge.hpp>
+
+#include <cstdio>
+#include <fstream>
+
+#include <matchmaking/journal/journal.hpp>
+#include <types/shard.hpp>
+
+#include "doctest/doctest.hpp"
+
+using namespace fastchess;
+
+TEST_SUITE("Shard") {
+    TEST_CASE("Rounds are split between the shards") {
+        const config::Shard first  = {1, 3};
+        const config::Shard second = {2, 3};
+        const config::Shard third  = {3, 3};
+
+        for (std::size_t round = 0; round < 10; round++) {
+            CHECK(first.owns(round) + second.owns(round) + third.owns(round) == 1);
+        }
+
+        CHECK(first.owns(0));
+        CHECK(second.owns(1));
+        CHECK(third.owns(5));
+
+        CHECK(first.rounds(10) == 4);
+        CHECK(second.rounds(10) == 3);
+        CHECK(third.rounds(10) == 3);
+        CHECK(third.rounds(1) == 0);
+
+        CHECK(config::Shard{}.rounds(10) == 10);
+    }
+
+    TEST_CASE("Merge journals") {
+        const std::string file1 = "shard_test_1.jsonl";
+        const std::string file2 = "shard_test_2.jsonl";
+        std::remove(file1.c_str());
+        std::remove(file2.c_str());
+
+        {
+            Journal shard1(file1, 1, 42);
+            shard1.append({"engine1", "engine2", 0, 0, 0, Stats(1, 0, 0)});
+            shard1.append({"engine2", "engine1", 0, 1, 0, Stats(0, 1, 0)});
+
+            Journal shard2(file2, 1, 42);
+            shard2.append({"engine1", "engine2", 1, 0, 1, Stats(0, 1, 0)});
+            shard2.append({"engine2", "engine1", 1, 1, 1, Stats(1, 0, 0)});
+            // duplicated game is only counted once
+            shard2.append({"engine2", "engine1", 1, 1, 1, Stats(1, 0, 0)});
+        }
+
+        config::Tournament config;
+        config.report_penta = true;
+
+        auto merger  = Merger(config, {file1, file2});
+        auto results = merger.getResults();
+
+        // pairs are stored from the point of view of the second game's white player
+        const auto &stats = results[PlayerPairKey("engine2", "engine1")];
+        CHECK(stats.wins == 2);
+        CHECK(stats.losses == 2);
+        CHECK(stats.penta_WW == 1);
+        CHECK(stats.penta_LL == 1);
+
+        std::remove(file1.c_str());
+        std::remove(file2.c_str());
+    }
+}
@@ -76,4 +76,12 @@ TEST_SUITE("SPRT") {
 
         CHECK(sprt.getLLR(stats, true) == doctest::Approx(-4.98).epsilon(0.01));
     }
+
+    TEST_CASE("decisions as text") {
+        SPRT sprt(0.05, 0.05, 0, 5, "normalized", true);
+
+        CHECK(std::string(SPRT::describe(sprt.getResult(3.0))) == "H1 was accepted");
+        CHECK(std::string(SPRT::describe(sprt.getResult(-3.0))) == "H0 was accepted");
+        CHECK(std::string(SPRT::describe(sprt.getResult(0.0))) == "no decision yet");
+    }
 }
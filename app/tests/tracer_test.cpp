@@ -0,0 +1,63 @@
+#include <util/tracer/tracer.hpp>
+
+#include <cstdio>
+#include <fstream>
+#include <thread>
+
+#include "doctest/doctest.hpp"
+
+using namespace fastchess;
+
+TEST_SUITE("Tracer") {
+    TEST_CASE("Nothing is recorded without a file") {
+        CHECK_FALSE(Tracer::enabled());
+
+        Tracer::Span span("game", "tournament");
+        span.arg("game", 1);
+    }
+
+    TEST_CASE("Spans of several threads") {
+        const std::string file = "tracer_test.json";
+
+        Tracer::openFile(file);
+        REQUIRE(Tracer::enabled());
+
+        {
+            Tracer::Span span("game", "tournament");
+            span.arg("game", 7);
+
+            std::thread([]() { Tracer::Span span("think", "engine"); }).join();
+        }
+
+        const auto begin = Tracer::clock::now();
+        Tracer::async("queued", "tournament", begin, begin + std::chrono::milliseconds(2), {{"pair", 0}});
+
+        Tracer::closeFile();
+        CHECK_FALSE(Tracer::enabled());
+
+        std::ifstream in(file);
+        const auto events = nlohmann::json::parse(in);
+
+        std::remove(file.c_str());
+
+        REQUIRE(events.is_array());
+        REQUIRE(events.size() == 6);
+
+        // the thread which ends the first span is named first
+        CHECK(events[0]["ph"] == "M");
+        CHECK(events[1]["name"] == "think");
+        CHECK(events[1]["tid"] == 1);
+
+        CHECK(events[2]["ph"] == "M");
+        CHECK(events[3]["name"] == "game");
+        CHECK(events[3]["ph"] == "X");
+        CHECK(events[3]["tid"] == 2);
+        CHECK(events[3]["args"]["game"] == 7);
+        CHECK(events[3]["dur"] >= events[1]["dur"]);
+
+        CHECK(events[4]["ph"] == "b");
+        CHECK(events[5]["ph"] == "e");
+        CHECK(events[5]["id"] == events[4]["id"]);
+        CHECK(events[5]["ts"].get<int64_t>() - events[4]["ts"].get<int64_t>() == 2000);
+    }
+}
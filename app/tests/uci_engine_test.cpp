@@ -180,6 +180,10 @@ TEST_SUITE("Uci Engine Communication Tests") {
         CHECK(uci_engine.output()[1].line == "line1");
         CHECK(uci_engine.output()[2].line == "uciok");
 
+#ifdef __linux__
+        CHECK(uci_engine.rusage().has_value());
+#endif
+
         uci_engine.restart();
 
         CHECK(uci_engine.writeEngine("uci"));
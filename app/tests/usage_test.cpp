@@ -0,0 +1,46 @@
+#include <matchmaking/usage.hpp>
+
+#include "doctest/doctest.hpp"
+
+namespace fastchess {
+
+TEST_SUITE("UsageBoard") {
+    TEST_CASE("Games are summed per engine") {
+        MatchData game;
+        game.players.white.config.name = "engine1";
+        game.players.black.config.name = "engine2";
+        game.players.white.process     = ProcessUsage{800, 200, 50, 10, 64};
+
+        UsageBoard board;
+        board.add(game);
+
+        game.players.white.process = ProcessUsage{1200, 0, 30, 20, 48};
+        board.add(game);
+
+        const auto engines = board.get();
+
+        // engines without accounting are left out
+        REQUIRE(engines.size() == 1);
+
+        const auto &usage = engines.at("engine1");
+        CHECK(usage.games == 2);
+        CHECK(usage.user_millis == 2000);
+        CHECK(usage.system_millis == 200);
+        CHECK(usage.voluntary_switches == 80);
+        CHECK(usage.involuntary_switches == 30);
+        CHECK(usage.max_rss == 64);
+    }
+
+    TEST_CASE("Preemptions per second of cpu time") {
+        EngineUsage usage;
+        CHECK(usage.preemptionRate() == 0.0);
+
+        usage.user_millis          = 1500;
+        usage.system_millis        = 500;
+        usage.involuntary_switches = 400;
+        CHECK(usage.preemptionRate() == doctest::Approx(200.0));
+        CHECK(usage.preemptionRate() > UsageBoard::OVERSUBSCRIBED_RATE);
+    }
+}
+
+}  // namespace fastchess